@@ -1,5 +1,6 @@
 #include "Commands/UnrealMCPBlueprintCommands.h"
 #include "Commands/UnrealMCPCommonUtils.h"
+#include "MCPCommandRegistry.h"
 #include "Engine/Blueprint.h"
 #include "Engine/BlueprintGeneratedClass.h"
 #include "Factories/BlueprintFactory.h"
@@ -25,46 +26,36 @@ FUnrealMCPBlueprintCommands::FUnrealMCPBlueprintCommands()
 {
 }
 
-TSharedPtr<FJsonObject> FUnrealMCPBlueprintCommands::HandleCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params)
+void FUnrealMCPBlueprintCommands::RegisterCommands(FMCPCommandRegistry& Registry)
 {
-    if (CommandType == TEXT("create_blueprint"))
-    {
-        return HandleCreateBlueprint(Params);
-    }
-    else if (CommandType == TEXT("add_component_to_blueprint"))
-    {
-        return HandleAddComponentToBlueprint(Params);
-    }
-    else if (CommandType == TEXT("set_component_property"))
-    {
-        return HandleSetComponentProperty(Params);
-    }
-    else if (CommandType == TEXT("set_physics_properties"))
-    {
-        return HandleSetPhysicsProperties(Params);
-    }
-    else if (CommandType == TEXT("compile_blueprint"))
-    {
-        return HandleCompileBlueprint(Params);
-    }
-    else if (CommandType == TEXT("spawn_blueprint_actor"))
-    {
-        return HandleSpawnBlueprintActor(Params);
-    }
-    else if (CommandType == TEXT("set_blueprint_property"))
-    {
-        return HandleSetBlueprintProperty(Params);
-    }
-    else if (CommandType == TEXT("set_static_mesh_properties"))
-    {
-        return HandleSetStaticMeshProperties(Params);
-    }
-    else if (CommandType == TEXT("set_pawn_properties"))
-    {
-        return HandleSetPawnProperties(Params);
-    }
-    
-    return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown blueprint command: %s"), *CommandType));
+    Registry.Register(TEXT("create_blueprint"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleCreateBlueprint(Params); })
+        .Require(TEXT("name"));
+    Registry.Register(TEXT("add_component_to_blueprint"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddComponentToBlueprint(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("component_type"))
+        .Require(TEXT("component_name"));
+    Registry.Register(TEXT("set_component_property"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetComponentProperty(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("component_name"))
+        .Require(TEXT("property_name"));
+    Registry.Register(TEXT("set_physics_properties"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetPhysicsProperties(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("component_name"));
+    // Compiling a large blueprint can take well over the default wait
+    Registry.Register(TEXT("compile_blueprint"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleCompileBlueprint(Params); })
+        .Timeout(30.0f)
+        .Priority(EMCPCommandPriority::Bulk)
+        .Require(TEXT("blueprint_name"));
+    Registry.Register(TEXT("set_blueprint_property"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetBlueprintProperty(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("property_name"));
+    Registry.Register(TEXT("set_static_mesh_properties"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetStaticMeshProperties(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("component_name"));
+    Registry.Register(TEXT("set_pawn_properties"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetPawnProperties(Params); })
+        .Require(TEXT("blueprint_name"));
+
+    // spawn_blueprint_actor is served by the editor commands
 }
 
 TSharedPtr<FJsonObject> FUnrealMCPBlueprintCommands::HandleCreateBlueprint(const TSharedPtr<FJsonObject>& Params)
@@ -1,5 +1,6 @@
 #include "Commands/UnrealMCPBlueprintNodeCommands.h"
 #include "Commands/UnrealMCPCommonUtils.h"
+#include "MCPCommandRegistry.h"
 #include "Engine/Blueprint.h"
 #include "Engine/BlueprintGeneratedClass.h"
 #include "EdGraph/EdGraph.h"
@@ -24,42 +25,36 @@ FUnrealMCPBlueprintNodeCommands::FUnrealMCPBlueprintNodeCommands()
 {
 }
 
-TSharedPtr<FJsonObject> FUnrealMCPBlueprintNodeCommands::HandleCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params)
+void FUnrealMCPBlueprintNodeCommands::RegisterCommands(FMCPCommandRegistry& Registry)
 {
-    if (CommandType == TEXT("connect_blueprint_nodes"))
-    {
-        return HandleConnectBlueprintNodes(Params);
-    }
-    else if (CommandType == TEXT("add_blueprint_get_self_component_reference"))
-    {
-        return HandleAddBlueprintGetSelfComponentReference(Params);
-    }
-    else if (CommandType == TEXT("add_blueprint_event_node"))
-    {
-        return HandleAddBlueprintEvent(Params);
-    }
-    else if (CommandType == TEXT("add_blueprint_function_node"))
-    {
-        return HandleAddBlueprintFunctionCall(Params);
-    }
-    else if (CommandType == TEXT("add_blueprint_variable"))
-    {
-        return HandleAddBlueprintVariable(Params);
-    }
-    else if (CommandType == TEXT("add_blueprint_input_action_node"))
-    {
-        return HandleAddBlueprintInputActionNode(Params);
-    }
-    else if (CommandType == TEXT("add_blueprint_self_reference"))
-    {
-        return HandleAddBlueprintSelfReference(Params);
-    }
-    else if (CommandType == TEXT("find_blueprint_nodes"))
-    {
-        return HandleFindBlueprintNodes(Params);
-    }
-    
-    return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown blueprint node command: %s"), *CommandType));
+    Registry.Register(TEXT("connect_blueprint_nodes"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleConnectBlueprintNodes(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("source_node_id"))
+        .Require(TEXT("target_node_id"))
+        .Require(TEXT("source_pin"))
+        .Require(TEXT("target_pin"));
+    Registry.Register(TEXT("add_blueprint_get_self_component_reference"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddBlueprintGetSelfComponentReference(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("component_name"));
+    Registry.Register(TEXT("add_blueprint_event_node"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddBlueprintEvent(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("event_name"));
+    Registry.Register(TEXT("add_blueprint_function_node"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddBlueprintFunctionCall(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("function_name"));
+    Registry.Register(TEXT("add_blueprint_variable"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddBlueprintVariable(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("variable_name"))
+        .Require(TEXT("variable_type"));
+    Registry.Register(TEXT("add_blueprint_input_action_node"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddBlueprintInputActionNode(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("action_name"));
+    Registry.Register(TEXT("add_blueprint_self_reference"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddBlueprintSelfReference(Params); })
+        .Require(TEXT("blueprint_name"));
+    Registry.Register(TEXT("find_blueprint_nodes"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleFindBlueprintNodes(Params); })
+        .ReadOnly()
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("node_type"));
 }
 
 TSharedPtr<FJsonObject> FUnrealMCPBlueprintNodeCommands::HandleConnectBlueprintNodes(const TSharedPtr<FJsonObject>& Params)
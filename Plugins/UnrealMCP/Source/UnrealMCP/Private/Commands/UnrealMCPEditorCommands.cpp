@@ -1,5 +1,8 @@
 #include "Commands/UnrealMCPEditorCommands.h"
 #include "Commands/UnrealMCPCommonUtils.h"
+#include "MCPCommandRegistry.h"
+#include "MCPActorIndex.h"
+#include "MCPSceneChangeLog.h"
 #include "Editor.h"
 #include "EditorViewportClient.h"
 #include "LevelEditorViewport.h"
@@ -9,7 +12,6 @@
 #include "Misc/FileHelper.h"
 #include "GameFramework/Actor.h"
 #include "Engine/Selection.h"
-#include "Kismet/GameplayStatics.h"
 #include "Engine/StaticMeshActor.h"
 #include "Engine/DirectionalLight.h"
 #include "Engine/PointLight.h"
@@ -20,84 +22,566 @@
 #include "Subsystems/EditorActorSubsystem.h"
 #include "Engine/Blueprint.h"
 #include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/Level.h"
+#include "Misc/Base64.h"
+#include "Misc/PackageName.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "SceneManagement.h"
+#include "AI/NavigationSystemBase.h"
+#include "ConvexVolume.h"
 
-FUnrealMCPEditorCommands::FUnrealMCPEditorCommands()
+// Most actors one spatial query returns unless it asks for fewer
+#define MCP_SPATIAL_QUERY_DEFAULT_LIMIT 100
+// Clip distances of query_actors_in_frustum when the request gives none
+#define MCP_FRUSTUM_DEFAULT_NEAR_DISTANCE 10.0
+#define MCP_FRUSTUM_DEFAULT_FAR_DISTANCE 100000.0
+// Most actors one set_actor_transforms moves, which bounds its game-thread slice and the arrays it decodes
+#define MCP_MAX_TRANSFORM_ACTORS 10000
+
+FUnrealMCPEditorCommands::FUnrealMCPEditorCommands(FMCPActorIndex& InActorIndex, FMCPSceneChangeLog& InSceneChanges)
+    : ActorIndex(InActorIndex)
+    , SceneChanges(InSceneChanges)
 {
 }
 
-TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params)
+void FUnrealMCPEditorCommands::RegisterCommands(FMCPCommandRegistry& Registry)
 {
     // Actor manipulation commands
-    if (CommandType == TEXT("get_actors_in_level"))
+    Registry.Register(TEXT("get_actors_in_level"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleGetActorsInLevel(Params); })
+        .ReadOnly()
+        .Streamed([this](const TSharedPtr<FJsonObject>& Params, FString& OutError) { return CaptureActorsInLevel(Params, OutError); });
+    Registry.Register(TEXT("find_actors_by_name"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleFindActorsByName(Params); })
+        .ReadOnly()
+        .Require(TEXT("pattern"));
+    // Stays on the game thread: a stale index has to be rebuilt there to find bulk changes such as an
+    // undo, the change log is fed and read there without a lock, and each changed actor's current
+    // state is read from the actor itself
+    Registry.Register(TEXT("get_scene_changes_since"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleGetSceneChangesSince(Params); })
+        .ReadOnly()
+        .Require(TEXT("version"), EJson::Number);
+    Registry.Register(TEXT("spawn_actor"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSpawnActor(Params); })
+        .Require(TEXT("type"))
+        .Require(TEXT("name"));
+    Registry.Register(TEXT("create_actor"), [this](const TSharedPtr<FJsonObject>& Params)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("'create_actor' command is deprecated and will be removed in a future version. Please use 'spawn_actor' instead."));
+        return HandleSpawnActor(Params);
+    })
+        .Require(TEXT("type"))
+        .Require(TEXT("name"));
+    Registry.Register(TEXT("delete_actor"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleDeleteActor(Params); })
+        .Require(TEXT("name"));
+    Registry.Register(TEXT("set_actor_transform"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetActorTransform(Params); })
+        .Require(TEXT("name"));
+    Registry.Register(TEXT("set_actor_transforms"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetActorTransforms(Params); })
+        .Priority(EMCPCommandPriority::Bulk)
+        .Require(TEXT("names"), EJson::Array);
+    Registry.Register(TEXT("get_actor_properties"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleGetActorProperties(Params); })
+        .ReadOnly()
+        .Require(TEXT("name"));
+    Registry.Register(TEXT("set_actor_property"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetActorProperty(Params); })
+        .Require(TEXT("name"))
+        .Require(TEXT("property_name"))
+        .Require(TEXT("property_value"), EJson::None);
+
+    // Spatial queries
+    Registry.Register(TEXT("query_actors_in_sphere"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleQueryActorsInSphere(Params); })
+        .ReadOnly()
+        .Require(TEXT("center"), EJson::Array)
+        .Require(TEXT("radius"), EJson::Number);
+    Registry.Register(TEXT("query_actors_in_box"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleQueryActorsInBox(Params); })
+        .ReadOnly();
+    Registry.Register(TEXT("query_actors_in_frustum"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleQueryActorsInFrustum(Params); })
+        .ReadOnly();
+
+    // Blueprint actor spawning
+    Registry.Register(TEXT("spawn_blueprint_actor"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSpawnBlueprintActor(Params); })
+        .Require(TEXT("blueprint_name"))
+        .Require(TEXT("actor_name"));
+
+    // Editor viewport commands only change the view, not the level
+    Registry.Register(TEXT("focus_viewport"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleFocusViewport(Params); })
+        .ReadOnly();
+    Registry.Register(TEXT("take_screenshot"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleTakeScreenshot(Params); })
+        .ReadOnly()
+        .Timeout(30.0f)
+        .Priority(EMCPCommandPriority::Bulk)
+        .Require(TEXT("filepath"));
+}
+
+// Fields get_actors_in_level can report, chosen with 'fields'
+enum EMCPActorField : uint32
+{
+    ActorField_Name = 1 << 0,
+    ActorField_Label = 1 << 1,
+    ActorField_Class = 1 << 2,
+    ActorField_Location = 1 << 3,
+    ActorField_Rotation = 1 << 4,
+    ActorField_Scale = 1 << 5,
+    ActorField_Folder = 1 << 6,
+    ActorField_Tags = 1 << 7,
+    ActorField_Level = 1 << 8,
+
+    // The layout ActorToJson reports, used when the request names no fields
+    ActorField_Default = ActorField_Name | ActorField_Class | ActorField_Location | ActorField_Rotation | ActorField_Scale,
+    // Fields a listing can be sorted by
+    ActorField_Sortable = ActorField_Name | ActorField_Label | ActorField_Class | ActorField_Folder | ActorField_Level
+};
+
+static const TPair<const TCHAR*, uint32> GActorFieldNames[] =
+{
+    { TEXT("name"), ActorField_Name },
+    { TEXT("label"), ActorField_Label },
+    { TEXT("class"), ActorField_Class },
+    { TEXT("location"), ActorField_Location },
+    { TEXT("rotation"), ActorField_Rotation },
+    { TEXT("scale"), ActorField_Scale },
+    { TEXT("folder"), ActorField_Folder },
+    { TEXT("tags"), ActorField_Tags },
+    { TEXT("level"), ActorField_Level }
+};
+
+static uint32 FindActorField(const FString& FieldName)
+{
+    for (const TPair<const TCHAR*, uint32>& Field : GActorFieldNames)
     {
-        return HandleGetActorsInLevel(Params);
+        if (FieldName == Field.Key)
+        {
+            return Field.Value;
+        }
     }
-    else if (CommandType == TEXT("find_actors_by_name"))
+    return 0;
+}
+
+// Plain copy of the requested fields of one actor, safe to read off the game thread
+struct FMCPActorSnapshot
+{
+    FString Name;
+    FString Label;
+    FString ClassName;
+    FVector Location;
+    FRotator Rotation;
+    FVector Scale;
+    FString Folder;
+    TArray<FString> Tags;
+    FString Level;
+};
+
+// One page of get_actors_in_level
+struct FMCPActorListing
+{
+    uint32 Fields = ActorField_Default;
+    TArray<FMCPActorSnapshot> Actors;
+    // Actors matching the filters across all pages
+    int32 Total = 0;
+    // Empty on the last page
+    FString NextCursor;
+    // Scene version the listing reflects, for get_scene_changes_since
+    uint64 Version = 0;
+};
+
+static FString GetActorLevelName(const AActor* Actor)
+{
+    const ULevel* Level = Actor->GetLevel();
+    return Level ? FPackageName::GetShortName(Level->GetOutermost()->GetName()) : FString();
+}
+
+static FString GetActorFieldString(const AActor* Actor, uint32 Field)
+{
+    switch (Field)
+    {
+    case ActorField_Label: return Actor->GetActorLabel();
+    case ActorField_Class: return Actor->GetClass()->GetName();
+    case ActorField_Folder: return Actor->GetFolderPath().ToString();
+    case ActorField_Level: return GetActorLevelName(Actor);
+    default: return Actor->GetName();
+    }
+}
+
+static void SnapshotActor(const AActor* Actor, uint32 Fields, FMCPActorSnapshot& OutSnapshot)
+{
+    if (Fields & ActorField_Name)
+    {
+        OutSnapshot.Name = Actor->GetName();
+    }
+    if (Fields & ActorField_Label)
+    {
+        OutSnapshot.Label = Actor->GetActorLabel();
+    }
+    if (Fields & ActorField_Class)
+    {
+        OutSnapshot.ClassName = Actor->GetClass()->GetName();
+    }
+    if (Fields & ActorField_Location)
     {
-        return HandleFindActorsByName(Params);
+        OutSnapshot.Location = Actor->GetActorLocation();
     }
-    else if (CommandType == TEXT("spawn_actor") || CommandType == TEXT("create_actor"))
+    if (Fields & ActorField_Rotation)
     {
-        if (CommandType == TEXT("create_actor"))
+        OutSnapshot.Rotation = Actor->GetActorRotation();
+    }
+    if (Fields & ActorField_Scale)
+    {
+        OutSnapshot.Scale = Actor->GetActorScale3D();
+    }
+    if (Fields & ActorField_Folder)
+    {
+        OutSnapshot.Folder = Actor->GetFolderPath().ToString();
+    }
+    if (Fields & ActorField_Level)
+    {
+        OutSnapshot.Level = GetActorLevelName(Actor);
+    }
+    if (Fields & ActorField_Tags)
+    {
+        for (const FName& Tag : Actor->Tags)
         {
-            UE_LOG(LogTemp, Warning, TEXT("'create_actor' command is deprecated and will be removed in a future version. Please use 'spawn_actor' instead."));
+            OutSnapshot.Tags.Add(Tag.ToString());
         }
-        return HandleSpawnActor(Params);
     }
-    else if (CommandType == TEXT("delete_actor"))
+}
+
+// A cursor is the sort field, sort key and path of the last actor handed out, so the next page
+// starts right after it even when actors were added or removed in between
+static FString EncodeActorCursor(const FString& SortBy, const FString& Key, const FString& Path)
+{
+    const FTCHARToUTF8 Utf8(*FString::Printf(TEXT("%s\n%s\n%s"), *SortBy, *Key, *Path));
+    return FBase64::Encode(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+static bool DecodeActorCursor(const FString& Cursor, FString& OutSortBy, FString& OutKey, FString& OutPath)
+{
+    TArray<uint8> Bytes;
+    if (!FBase64::Decode(Cursor, Bytes))
     {
-        return HandleDeleteActor(Params);
+        return false;
     }
-    else if (CommandType == TEXT("set_actor_transform"))
+
+    const FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+    const FString Decoded(Text.Length(), Text.Get());
+
+    // Sort field and path never hold a line break; a label used as the key might
+    FString KeyAndPath;
+    return Decoded.Split(TEXT("\n"), &OutSortBy, &KeyAndPath)
+        && KeyAndPath.Split(TEXT("\n"), &OutKey, &OutPath, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+}
+
+// Resolves 'class' as a class path or short name; blueprint classes may leave out the _C suffix
+static UClass* FindActorClass(const FString& ClassName)
+{
+    UClass* Class = ClassName.Contains(TEXT("/"))
+        ? FindObject<UClass>(nullptr, *ClassName)
+        : FindFirstObject<UClass>(*ClassName, EFindFirstObjectOptions::NativeFirst);
+    if (!Class && !ClassName.EndsWith(TEXT("_C")))
     {
-        return HandleSetActorTransform(Params);
+        Class = FindActorClass(ClassName + TEXT("_C"));
     }
-    else if (CommandType == TEXT("get_actor_properties"))
+    return Class && Class->IsChildOf(AActor::StaticClass()) ? Class : nullptr;
+}
+
+bool FUnrealMCPEditorCommands::ListActors(const TSharedPtr<FJsonObject>& Params, FMCPActorListing& OutListing, FString& OutError)
+{
+    check(IsInGameThread());
+
+    const TArray<TSharedPtr<FJsonValue>>* FieldValues = nullptr;
+    if (Params->TryGetArrayField(TEXT("fields"), FieldValues))
     {
-        return HandleGetActorProperties(Params);
+        OutListing.Fields = 0;
+        for (const TSharedPtr<FJsonValue>& FieldValue : *FieldValues)
+        {
+            const uint32 Field = FindActorField(FieldValue->AsString());
+            if (!Field)
+            {
+                OutError = FString::Printf(TEXT("Unknown field: %s"), *FieldValue->AsString());
+                return false;
+            }
+            OutListing.Fields |= Field;
+        }
     }
-    else if (CommandType == TEXT("set_actor_property"))
+
+    FString SortBy = TEXT("name");
+    Params->TryGetStringField(TEXT("sort_by"), SortBy);
+    const uint32 SortField = FindActorField(SortBy);
+    if (!(SortField & ActorField_Sortable))
     {
-        return HandleSetActorProperty(Params);
+        OutError = FString::Printf(TEXT("Cannot sort by '%s'; use name, label, class, folder or level"), *SortBy);
+        return false;
     }
-    // Blueprint actor spawning
-    else if (CommandType == TEXT("spawn_blueprint_actor"))
+
+    int32 PageSize = 0;
+    Params->TryGetNumberField(TEXT("page_size"), PageSize);
+    if (PageSize < 0)
     {
-        return HandleSpawnBlueprintActor(Params);
+        OutError = TEXT("'page_size' must not be negative");
+        return false;
     }
-    // Editor viewport commands
-    else if (CommandType == TEXT("focus_viewport"))
+
+    FString Cursor, CursorSortBy, CursorKey, CursorPath;
+    if (Params->TryGetStringField(TEXT("cursor"), Cursor) && !Cursor.IsEmpty())
     {
-        return HandleFocusViewport(Params);
+        if (!DecodeActorCursor(Cursor, CursorSortBy, CursorKey, CursorPath))
+        {
+            OutError = TEXT("Invalid 'cursor'");
+            return false;
+        }
+        if (CursorSortBy != SortBy)
+        {
+            OutError = FString::Printf(TEXT("The cursor belongs to a listing sorted by '%s'"), *CursorSortBy);
+            return false;
+        }
     }
-    else if (CommandType == TEXT("take_screenshot"))
+
+    // Filters
+    UClass* Class = nullptr;
+    FString ClassName;
+    if (Params->TryGetStringField(TEXT("class"), ClassName) && !ClassName.IsEmpty())
     {
-        return HandleTakeScreenshot(Params);
+        Class = FindActorClass(ClassName);
+        if (!Class)
+        {
+            OutError = FString::Printf(TEXT("Unknown actor class: %s"), *ClassName);
+            return false;
+        }
     }
-    
-    return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown editor command: %s"), *CommandType));
+
+    FString TagName;
+    Params->TryGetStringField(TEXT("tag"), TagName);
+    const FName Tag = TagName.IsEmpty() ? NAME_None : FName(*TagName);
+
+    FString Folder;
+    Params->TryGetStringField(TEXT("folder"), Folder);
+    Folder.RemoveFromEnd(TEXT("/"));
+
+    FString NamePattern;
+    Params->TryGetStringField(TEXT("name"), NamePattern);
+
+    FString LevelName;
+    Params->TryGetStringField(TEXT("level"), LevelName);
+
+    TArray<AActor*> AllActors;
+    ActorIndex.GetAllActors(AllActors);
+
+    struct FRow
+    {
+        FString Key;
+        FString Path;
+        AActor* Actor;
+    };
+    TArray<FRow> Rows;
+    for (AActor* Actor : AllActors)
+    {
+        if ((Class && !Actor->IsA(Class))
+            || (!Tag.IsNone() && !Actor->ActorHasTag(Tag)))
+        {
+            continue;
+        }
+        if (!Folder.IsEmpty())
+        {
+            // A folder also holds the actors of its subfolders
+            const FString ActorFolder = Actor->GetFolderPath().ToString();
+            if (!ActorFolder.Equals(Folder, ESearchCase::IgnoreCase) && !ActorFolder.StartsWith(Folder + TEXT("/"), ESearchCase::IgnoreCase))
+            {
+                continue;
+            }
+        }
+        if (!NamePattern.IsEmpty() && !Actor->GetName().MatchesWildcard(NamePattern) && !Actor->GetActorLabel().MatchesWildcard(NamePattern))
+        {
+            continue;
+        }
+        if (!LevelName.IsEmpty() && !GetActorLevelName(Actor).Equals(LevelName, ESearchCase::IgnoreCase)
+            && !(Actor->GetLevel() && Actor->GetLevel()->GetOutermost()->GetName().Equals(LevelName, ESearchCase::IgnoreCase)))
+        {
+            continue;
+        }
+
+        Rows.Add({ GetActorFieldString(Actor, SortField), Actor->GetPathName(), Actor });
+    }
+
+    // Ties on the key are broken by path, which is unique, so the order is total and pages never overlap
+    auto RowLess = [](const FRow& A, const FRow& B)
+    {
+        const int32 KeyOrder = A.Key.Compare(B.Key, ESearchCase::IgnoreCase);
+        return KeyOrder != 0 ? KeyOrder < 0 : A.Path.Compare(B.Path, ESearchCase::IgnoreCase) < 0;
+    };
+    Rows.Sort(RowLess);
+
+    int32 First = 0;
+    if (!Cursor.IsEmpty())
+    {
+        First = Algo::UpperBound(Rows, FRow{ CursorKey, CursorPath, nullptr }, RowLess);
+    }
+    const int32 End = PageSize > 0 ? FMath::Min(First + PageSize, Rows.Num()) : Rows.Num();
+
+    OutListing.Total = Rows.Num();
+    OutListing.Actors.SetNum(End - First);
+    for (int32 Index = First; Index < End; ++Index)
+    {
+        SnapshotActor(Rows[Index].Actor, OutListing.Fields, OutListing.Actors[Index - First]);
+    }
+    if (End < Rows.Num())
+    {
+        OutListing.NextCursor = EncodeActorCursor(SortBy, Rows[End - 1].Key, Rows[End - 1].Path);
+    }
+    OutListing.Version = SceneChanges.GetVersion();
+    return true;
+}
+
+static TSharedPtr<FJsonValue> MakeVectorArray(double X, double Y, double Z)
+{
+    TArray<TSharedPtr<FJsonValue>> Array;
+    Array.Add(MakeShared<FJsonValueNumber>(X));
+    Array.Add(MakeShared<FJsonValueNumber>(Y));
+    Array.Add(MakeShared<FJsonValueNumber>(Z));
+    return MakeShared<FJsonValueArray>(Array);
 }
 
 TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleGetActorsInLevel(const TSharedPtr<FJsonObject>& Params)
 {
-    TArray<AActor*> AllActors;
-    UGameplayStatics::GetAllActorsOfClass(GWorld, AActor::StaticClass(), AllActors);
-    
+    FMCPActorListing Listing;
+    FString Error;
+    if (!ListActors(Params, Listing, Error))
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(Error);
+    }
+
     TArray<TSharedPtr<FJsonValue>> ActorArray;
-    for (AActor* Actor : AllActors)
+    for (const FMCPActorSnapshot& Snapshot : Listing.Actors)
     {
-        if (Actor)
+        TSharedPtr<FJsonObject> ActorObject = MakeShared<FJsonObject>();
+        if (Listing.Fields & ActorField_Name)
+        {
+            ActorObject->SetStringField(TEXT("name"), Snapshot.Name);
+        }
+        if (Listing.Fields & ActorField_Label)
+        {
+            ActorObject->SetStringField(TEXT("label"), Snapshot.Label);
+        }
+        if (Listing.Fields & ActorField_Class)
         {
-            ActorArray.Add(FUnrealMCPCommonUtils::ActorToJson(Actor));
+            ActorObject->SetStringField(TEXT("class"), Snapshot.ClassName);
         }
+        if (Listing.Fields & ActorField_Location)
+        {
+            ActorObject->SetField(TEXT("location"), MakeVectorArray(Snapshot.Location.X, Snapshot.Location.Y, Snapshot.Location.Z));
+        }
+        if (Listing.Fields & ActorField_Rotation)
+        {
+            ActorObject->SetField(TEXT("rotation"), MakeVectorArray(Snapshot.Rotation.Pitch, Snapshot.Rotation.Yaw, Snapshot.Rotation.Roll));
+        }
+        if (Listing.Fields & ActorField_Scale)
+        {
+            ActorObject->SetField(TEXT("scale"), MakeVectorArray(Snapshot.Scale.X, Snapshot.Scale.Y, Snapshot.Scale.Z));
+        }
+        if (Listing.Fields & ActorField_Folder)
+        {
+            ActorObject->SetStringField(TEXT("folder"), Snapshot.Folder);
+        }
+        if (Listing.Fields & ActorField_Tags)
+        {
+            TArray<TSharedPtr<FJsonValue>> TagArray;
+            for (const FString& Tag : Snapshot.Tags)
+            {
+                TagArray.Add(MakeShared<FJsonValueString>(Tag));
+            }
+            ActorObject->SetArrayField(TEXT("tags"), TagArray);
+        }
+        if (Listing.Fields & ActorField_Level)
+        {
+            ActorObject->SetStringField(TEXT("level"), Snapshot.Level);
+        }
+        ActorArray.Add(MakeShared<FJsonValueObject>(ActorObject));
     }
-    
+
     TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
     ResultObj->SetArrayField(TEXT("actors"), ActorArray);
-    
+    ResultObj->SetNumberField(TEXT("total"), Listing.Total);
+    ResultObj->SetNumberField(TEXT("version"), (double)Listing.Version);
+    if (!Listing.NextCursor.IsEmpty())
+    {
+        ResultObj->SetStringField(TEXT("next_cursor"), Listing.NextCursor);
+    }
     return ResultObj;
 }
 
+static void WriteVectorArray(FMCPResponseWriter& Writer, const TCHAR* Identifier, double X, double Y, double Z)
+{
+    Writer.WriteArrayStart(Identifier);
+    Writer.WriteNumber(X);
+    Writer.WriteNumber(Y);
+    Writer.WriteNumber(Z);
+    Writer.WriteArrayEnd();
+}
+
+FMCPResultWriter FUnrealMCPEditorCommands::CaptureActorsInLevel(const TSharedPtr<FJsonObject>& Params, FString& OutError)
+{
+    TSharedRef<FMCPActorListing> Listing = MakeShared<FMCPActorListing>();
+    if (!ListActors(Params, *Listing, OutError))
+    {
+        return nullptr;
+    }
+
+    // Same layout as HandleGetActorsInLevel, written one actor at a time
+    return [Listing](FMCPResponseWriter& Writer)
+    {
+        const uint32 Fields = Listing->Fields;
+        Writer.WriteArrayStart(TEXT("actors"));
+        for (const FMCPActorSnapshot& Snapshot : Listing->Actors)
+        {
+            Writer.WriteObjectStart();
+            if (Fields & ActorField_Name)
+            {
+                Writer.WriteString(TEXT("name"), Snapshot.Name);
+            }
+            if (Fields & ActorField_Label)
+            {
+                Writer.WriteString(TEXT("label"), Snapshot.Label);
+            }
+            if (Fields & ActorField_Class)
+            {
+                Writer.WriteString(TEXT("class"), Snapshot.ClassName);
+            }
+            if (Fields & ActorField_Location)
+            {
+                WriteVectorArray(Writer, TEXT("location"), Snapshot.Location.X, Snapshot.Location.Y, Snapshot.Location.Z);
+            }
+            if (Fields & ActorField_Rotation)
+            {
+                WriteVectorArray(Writer, TEXT("rotation"), Snapshot.Rotation.Pitch, Snapshot.Rotation.Yaw, Snapshot.Rotation.Roll);
+            }
+            if (Fields & ActorField_Scale)
+            {
+                WriteVectorArray(Writer, TEXT("scale"), Snapshot.Scale.X, Snapshot.Scale.Y, Snapshot.Scale.Z);
+            }
+            if (Fields & ActorField_Folder)
+            {
+                Writer.WriteString(TEXT("folder"), Snapshot.Folder);
+            }
+            if (Fields & ActorField_Tags)
+            {
+                Writer.WriteArrayStart(TEXT("tags"));
+                for (const FString& Tag : Snapshot.Tags)
+                {
+                    Writer.WriteString(Tag);
+                }
+                Writer.WriteArrayEnd();
+            }
+            if (Fields & ActorField_Level)
+            {
+                Writer.WriteString(TEXT("level"), Snapshot.Level);
+            }
+            Writer.WriteObjectEnd();
+        }
+        Writer.WriteArrayEnd();
+        Writer.WriteNumber(TEXT("total"), Listing->Total);
+        Writer.WriteNumber(TEXT("version"), (double)Listing->Version);
+        if (!Listing->NextCursor.IsEmpty())
+        {
+            Writer.WriteString(TEXT("next_cursor"), Listing->NextCursor);
+        }
+    };
+}
+
 TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleFindActorsByName(const TSharedPtr<FJsonObject>& Params)
 {
     FString Pattern;
@@ -105,22 +589,140 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleFindActorsByName(const T
     {
         return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("Missing 'pattern' parameter"));
     }
-    
-    TArray<AActor*> AllActors;
-    UGameplayStatics::GetAllActorsOfClass(GWorld, AActor::StaticClass(), AllActors);
-    
+
+    EMCPActorSearchMode Mode = EMCPActorSearchMode::Substring;
+    FString ModeName;
+    if (Params->TryGetStringField(TEXT("mode"), ModeName))
+    {
+        if (ModeName == TEXT("glob"))
+        {
+            Mode = EMCPActorSearchMode::Glob;
+        }
+        else if (ModeName == TEXT("regex"))
+        {
+            Mode = EMCPActorSearchMode::Regex;
+        }
+        else if (ModeName == TEXT("fuzzy"))
+        {
+            Mode = EMCPActorSearchMode::Fuzzy;
+        }
+        else if (ModeName != TEXT("substring"))
+        {
+            return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown mode '%s'; expected substring, glob, regex or fuzzy"), *ModeName));
+        }
+    }
+
+    bool bCaseSensitive = false;
+    Params->TryGetBoolField(TEXT("case_sensitive"), bCaseSensitive);
+    int32 Limit = 0;
+    Params->TryGetNumberField(TEXT("limit"), Limit);
+
+    TArray<FMCPActorSearchMatch> Matches;
+    ActorIndex.SearchActors(Pattern, Mode, bCaseSensitive ? ESearchCase::CaseSensitive : ESearchCase::IgnoreCase, Matches);
+
+    // Closest first for fuzzy searches, by name otherwise, so pages of results are stable
+    Algo::Sort(Matches, [](const FMCPActorSearchMatch& A, const FMCPActorSearchMatch& B)
+    {
+        if (A.Score != B.Score)
+        {
+            return A.Score > B.Score;
+        }
+        return A.Actor->GetFName().LexicalLess(B.Actor->GetFName());
+    });
+
+    const int32 NumReturned = Limit > 0 ? FMath::Min(Limit, Matches.Num()) : Matches.Num();
     TArray<TSharedPtr<FJsonValue>> MatchingActors;
-    for (AActor* Actor : AllActors)
+    MatchingActors.Reserve(NumReturned);
+    for (int32 Index = 0; Index < NumReturned; ++Index)
     {
-        if (Actor && Actor->GetName().Contains(Pattern))
+        AActor* Actor = Matches[Index].Actor;
+        TSharedPtr<FJsonObject> ActorJson = FUnrealMCPCommonUtils::ActorToJsonObject(Actor);
+        ActorJson->SetStringField(TEXT("label"), Actor->GetActorLabel());
+        if (Mode == EMCPActorSearchMode::Fuzzy)
         {
-            MatchingActors.Add(FUnrealMCPCommonUtils::ActorToJson(Actor));
+            ActorJson->SetNumberField(TEXT("score"), Matches[Index].Score);
         }
+        MatchingActors.Add(MakeShared<FJsonValueObject>(ActorJson));
     }
-    
+
     TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
     ResultObj->SetArrayField(TEXT("actors"), MatchingActors);
-    
+    ResultObj->SetNumberField(TEXT("total"), Matches.Num());
+    return ResultObj;
+}
+
+static const TCHAR* GetSceneChangeName(EMCPActorChange Change)
+{
+    switch (Change)
+    {
+    case EMCPActorChange::Added: return TEXT("added");
+    case EMCPActorChange::Removed: return TEXT("removed");
+    case EMCPActorChange::Transformed: return TEXT("transformed");
+    default: return TEXT("modified");
+    }
+}
+
+TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleGetSceneChangesSince(const TSharedPtr<FJsonObject>& Params)
+{
+    int64 SinceVersion = 0;
+    Params->TryGetNumberField(TEXT("version"), SinceVersion);
+
+    // Picks up whatever the editor changed in bulk since the last call
+    ActorIndex.EnsureUpToDate();
+
+    TArray<FMCPSceneChange> Changes;
+    const bool bComplete = SinceVersion >= 0 && SceneChanges.GetChangesSince((uint64)SinceVersion, Changes);
+
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetNumberField(TEXT("version"), (double)SceneChanges.GetVersion());
+    ResultObj->SetBoolField(TEXT("resync_required"), !bComplete);
+
+    // One entry per actor with its net change: removed if it is gone now, added if it is new
+    // since SinceVersion, otherwise modified or, if it only moved, transformed
+    struct FNetChange
+    {
+        const FMCPSceneChange* Latest = nullptr;
+        bool bAdded = false;
+        bool bModified = false;
+    };
+    TMap<FName, FNetChange> NetChanges;
+    for (const FMCPSceneChange& Change : Changes)
+    {
+        FNetChange& NetChange = NetChanges.FindOrAdd(Change.ActorName);
+        NetChange.Latest = &Change;
+        NetChange.bAdded |= Change.Change == EMCPActorChange::Added;
+        NetChange.bModified |= Change.Change == EMCPActorChange::Modified;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ChangeArray;
+    for (const TPair<FName, FNetChange>& Pair : NetChanges)
+    {
+        const FNetChange& NetChange = Pair.Value;
+        AActor* Actor = NetChange.Latest->Actor.Get();
+
+        EMCPActorChange Change = EMCPActorChange::Transformed;
+        if (NetChange.Latest->Change == EMCPActorChange::Removed || !IsValid(Actor))
+        {
+            Change = EMCPActorChange::Removed;
+        }
+        else if (NetChange.bAdded)
+        {
+            Change = EMCPActorChange::Added;
+        }
+        else if (NetChange.bModified)
+        {
+            Change = EMCPActorChange::Modified;
+        }
+
+        // Actors still there report their current state, so clients need no follow-up query
+        TSharedPtr<FJsonObject> ChangeObject = Change == EMCPActorChange::Removed ? MakeShared<FJsonObject>() : FUnrealMCPCommonUtils::ActorToJsonObject(Actor);
+        ChangeObject->SetStringField(TEXT("name"), Pair.Key.ToString());
+        ChangeObject->SetStringField(TEXT("change"), GetSceneChangeName(Change));
+        ChangeObject->SetNumberField(TEXT("version"), (double)NetChange.Latest->Version);
+        ChangeArray.Add(MakeShared<FJsonValueObject>(ChangeObject));
+    }
+    ResultObj->SetArrayField(TEXT("changes"), ChangeArray);
+
     return ResultObj;
 }
 
@@ -168,14 +770,9 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSpawnActor(const TShared
     }
 
     // Check if an actor with this name already exists
-    TArray<AActor*> AllActors;
-    UGameplayStatics::GetAllActorsOfClass(World, AActor::StaticClass(), AllActors);
-    for (AActor* Actor : AllActors)
+    if (ActorIndex.FindActorByName(ActorName))
     {
-        if (Actor && Actor->GetName() == ActorName)
-        {
-            return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Actor with name '%s' already exists"), *ActorName));
-        }
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Actor with name '%s' already exists"), *ActorName));
     }
 
     FActorSpawnParameters SpawnParams;
@@ -213,6 +810,10 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSpawnActor(const TShared
         Transform.SetScale3D(Scale);
         NewActor->SetActorTransform(Transform);
 
+        // A spawn does not reliably reach the index through the engine's events; reported once
+        // scaled, the addition already carries the final bounds and needs no separate move
+        ActorIndex.NotifyActorChanged(NewActor, EMCPActorChange::Added);
+
         // Return the created actor's details
         return FUnrealMCPCommonUtils::ActorToJsonObject(NewActor, true);
     }
@@ -228,26 +829,21 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleDeleteActor(const TShare
         return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("Missing 'name' parameter"));
     }
 
-    TArray<AActor*> AllActors;
-    UGameplayStatics::GetAllActorsOfClass(GWorld, AActor::StaticClass(), AllActors);
-    
-    for (AActor* Actor : AllActors)
+    AActor* Actor = ActorIndex.FindActorByName(ActorName);
+    if (!Actor)
     {
-        if (Actor && Actor->GetName() == ActorName)
-        {
-            // Store actor info before deletion for the response
-            TSharedPtr<FJsonObject> ActorInfo = FUnrealMCPCommonUtils::ActorToJsonObject(Actor);
-            
-            // Delete the actor
-            Actor->Destroy();
-            
-            TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
-            ResultObj->SetObjectField(TEXT("deleted_actor"), ActorInfo);
-            return ResultObj;
-        }
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Actor not found: %s"), *ActorName));
     }
+
+    // Store actor info before deletion for the response
+    TSharedPtr<FJsonObject> ActorInfo = FUnrealMCPCommonUtils::ActorToJsonObject(Actor);
+    
+    // Delete the actor
+    Actor->Destroy();
     
-    return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Actor not found: %s"), *ActorName));
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetObjectField(TEXT("deleted_actor"), ActorInfo);
+    return ResultObj;
 }
 
 TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSetActorTransform(const TSharedPtr<FJsonObject>& Params)
@@ -260,18 +856,7 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSetActorTransform(const
     }
 
     // Find the actor
-    AActor* TargetActor = nullptr;
-    TArray<AActor*> AllActors;
-    UGameplayStatics::GetAllActorsOfClass(GWorld, AActor::StaticClass(), AllActors);
-    
-    for (AActor* Actor : AllActors)
-    {
-        if (Actor && Actor->GetName() == ActorName)
-        {
-            TargetActor = Actor;
-            break;
-        }
-    }
+    AActor* TargetActor = ActorIndex.FindActorByName(ActorName);
 
     if (!TargetActor)
     {
@@ -296,11 +881,125 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSetActorTransform(const
 
     // Set the new transform
     TargetActor->SetActorTransform(NewTransform);
+    ActorIndex.NotifyActorChanged(TargetActor, EMCPActorChange::Transformed);
 
     // Return updated actor info
     return FUnrealMCPCommonUtils::ActorToJsonObject(TargetActor, true);
 }
 
+// set_actor_transforms takes each of location, rotation and scale for all actors at once, three
+// values per actor: a flat array of numbers, or base64 of the same as little-endian float32s
+static bool ReadPackedVectors(const TSharedPtr<FJsonObject>& Params, const TCHAR* FieldName, int32 NumActors, TArray<FVector>& OutVectors, FString& OutError)
+{
+    const TSharedPtr<FJsonValue> Field = Params->TryGetField(FieldName);
+    if (!Field.IsValid() || Field->IsNull())
+    {
+        return true;
+    }
+
+    const int32 NumValues = NumActors * 3;
+    OutVectors.SetNumUninitialized(NumActors);
+    if (Field->Type == EJson::String)
+    {
+        TArray<uint8> Bytes;
+        if (!FBase64::Decode(Field->AsString(), Bytes) || Bytes.Num() != NumValues * (int32)sizeof(float))
+        {
+            OutError = FString::Printf(TEXT("'%s' must be base64 of %d little-endian float32 values, three per actor"), FieldName, NumValues);
+            return false;
+        }
+
+        // The editor only runs on little-endian platforms, so the floats are used as they are
+        const float* Values = reinterpret_cast<const float*>(Bytes.GetData());
+        for (int32 Index = 0; Index < NumActors; ++Index)
+        {
+            OutVectors[Index] = FVector(Values[Index * 3], Values[Index * 3 + 1], Values[Index * 3 + 2]);
+        }
+        return true;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+    if (!Params->TryGetArrayField(FieldName, Values) || Values->Num() != NumValues)
+    {
+        OutError = FString::Printf(TEXT("'%s' must hold %d numbers, three per actor, or base64 of as many float32 values"), FieldName, NumValues);
+        return false;
+    }
+    for (int32 Index = 0; Index < NumActors; ++Index)
+    {
+        OutVectors[Index] = FVector((*Values)[Index * 3]->AsNumber(), (*Values)[Index * 3 + 1]->AsNumber(), (*Values)[Index * 3 + 2]->AsNumber());
+    }
+    return true;
+}
+
+TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSetActorTransforms(const TSharedPtr<FJsonObject>& Params)
+{
+    const TArray<TSharedPtr<FJsonValue>>& Names = Params->GetArrayField(TEXT("names"));
+    const int32 NumActors = Names.Num();
+    if (NumActors > MCP_MAX_TRANSFORM_ACTORS)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("set_actor_transforms moves at most %d actors, got %d"), MCP_MAX_TRANSFORM_ACTORS, NumActors));
+    }
+
+    // Rotations come as pitch, yaw and roll, like set_actor_transform's
+    TArray<FVector> Locations;
+    TArray<FVector> Rotations;
+    TArray<FVector> Scales;
+    FString Error;
+    if (!ReadPackedVectors(Params, TEXT("location"), NumActors, Locations, Error)
+        || !ReadPackedVectors(Params, TEXT("rotation"), NumActors, Rotations, Error)
+        || !ReadPackedVectors(Params, TEXT("scale"), NumActors, Scales, Error))
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(Error);
+    }
+
+    // Deferred, the navigation octree takes all the moves in one update once the last actor is placed.
+    // Render transforms need no such help: the engine already sends them once, at the end of the frame.
+    bool bDeferNavigation = false;
+    Params->TryGetBoolField(TEXT("defer_navigation"), bDeferNavigation);
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    FNavigationLockContext NavigationLock(World, ENavigationLockReason::Unknown, bDeferNavigation);
+
+    // Bit i of the bitmap, least significant first, is set when names[i] was moved
+    TArray<uint8> Moved;
+    Moved.SetNumZeroed((NumActors + 7) / 8);
+    int32 NumMoved = 0;
+    for (int32 Index = 0; Index < NumActors; ++Index)
+    {
+        AActor* Actor = ActorIndex.FindActorByName(Names[Index]->AsString());
+        if (!Actor)
+        {
+            continue;
+        }
+
+        FTransform NewTransform = Actor->GetTransform();
+        if (Locations.Num() > 0)
+        {
+            NewTransform.SetLocation(Locations[Index]);
+        }
+        if (Rotations.Num() > 0)
+        {
+            NewTransform.SetRotation(FQuat(FRotator(Rotations[Index].X, Rotations[Index].Y, Rotations[Index].Z)));
+        }
+        if (Scales.Num() > 0)
+        {
+            NewTransform.SetScale3D(Scales[Index]);
+        }
+
+        // Fails for actors without a root component
+        if (Actor->SetActorTransform(NewTransform))
+        {
+            ActorIndex.NotifyActorChanged(Actor, EMCPActorChange::Transformed);
+            Moved[Index / 8] |= 1 << (Index % 8);
+            ++NumMoved;
+        }
+    }
+
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetStringField(TEXT("moved"), FBase64::Encode(Moved));
+    ResultObj->SetNumberField(TEXT("count"), NumActors);
+    ResultObj->SetNumberField(TEXT("moved_count"), NumMoved);
+    return ResultObj;
+}
+
 TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleGetActorProperties(const TSharedPtr<FJsonObject>& Params)
 {
     // Get actor name
@@ -311,18 +1010,7 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleGetActorProperties(const
     }
 
     // Find the actor
-    AActor* TargetActor = nullptr;
-    TArray<AActor*> AllActors;
-    UGameplayStatics::GetAllActorsOfClass(GWorld, AActor::StaticClass(), AllActors);
-    
-    for (AActor* Actor : AllActors)
-    {
-        if (Actor && Actor->GetName() == ActorName)
-        {
-            TargetActor = Actor;
-            break;
-        }
-    }
+    AActor* TargetActor = ActorIndex.FindActorByName(ActorName);
 
     if (!TargetActor)
     {
@@ -343,18 +1031,7 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSetActorProperty(const T
     }
 
     // Find the actor
-    AActor* TargetActor = nullptr;
-    TArray<AActor*> AllActors;
-    UGameplayStatics::GetAllActorsOfClass(GWorld, AActor::StaticClass(), AllActors);
-    
-    for (AActor* Actor : AllActors)
-    {
-        if (Actor && Actor->GetName() == ActorName)
-        {
-            TargetActor = Actor;
-            break;
-        }
-    }
+    AActor* TargetActor = ActorIndex.FindActorByName(ActorName);
 
     if (!TargetActor)
     {
@@ -380,6 +1057,9 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSetActorProperty(const T
     FString ErrorMessage;
     if (FUnrealMCPCommonUtils::SetObjectProperty(TargetActor, PropertyName, PropertyValue, ErrorMessage))
     {
+        // The property may have moved or resized the actor
+        ActorIndex.NotifyActorChanged(TargetActor, EMCPActorChange::Modified);
+
         // Property set successfully
         TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
         ResultObj->SetStringField(TEXT("actor"), ActorName);
@@ -396,6 +1076,186 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSetActorProperty(const T
     }
 }
 
+/**
+ * The candidates whose bounds pass Filter, nearest to Origin first, as a spatial query result.
+ * Honours the request's optional 'class' (exact short class name) and 'limit'.
+ */
+static TSharedPtr<FJsonObject> MakeSpatialQueryResult(const TArray<FMCPActorBounds>& Candidates, const FVector& Origin,
+    const TSharedPtr<FJsonObject>& Params, TFunctionRef<bool(const FBox&)> Filter)
+{
+    int32 Limit = MCP_SPATIAL_QUERY_DEFAULT_LIMIT;
+    Params->TryGetNumberField(TEXT("limit"), Limit);
+    if (Limit <= 0)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("'limit' must be positive"));
+    }
+
+    FString ClassName;
+    Params->TryGetStringField(TEXT("class"), ClassName);
+
+    TArray<TPair<double, AActor*>> Matches;
+    for (const FMCPActorBounds& Candidate : Candidates)
+    {
+        if ((ClassName.IsEmpty() || Candidate.Actor->GetClass()->GetName() == ClassName) && Filter(Candidate.Bounds))
+        {
+            Matches.Emplace(FVector::DistSquared(Origin, Candidate.Actor->GetActorLocation()), Candidate.Actor);
+        }
+    }
+    Matches.Sort([](const TPair<double, AActor*>& A, const TPair<double, AActor*>& B) { return A.Key < B.Key; });
+
+    TArray<TSharedPtr<FJsonValue>> ActorArray;
+    for (int32 Index = 0; Index < FMath::Min(Limit, Matches.Num()); ++Index)
+    {
+        TSharedPtr<FJsonObject> ActorObject = FUnrealMCPCommonUtils::ActorToJsonObject(Matches[Index].Value);
+        ActorObject->SetNumberField(TEXT("distance"), FMath::Sqrt(Matches[Index].Key));
+        ActorArray.Add(MakeShared<FJsonValueObject>(ActorObject));
+    }
+
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetArrayField(TEXT("actors"), ActorArray);
+    ResultObj->SetNumberField(TEXT("total"), Matches.Num());
+    return ResultObj;
+}
+
+TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleQueryActorsInSphere(const TSharedPtr<FJsonObject>& Params)
+{
+    const FVector Center = FUnrealMCPCommonUtils::GetVectorFromJson(Params, TEXT("center"));
+    const double Radius = Params->GetNumberField(TEXT("radius"));
+    if (Radius < 0.0)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("'radius' must not be negative"));
+    }
+
+    TArray<FMCPActorBounds> Candidates;
+    ActorIndex.FindActorsInBox(FBox(Center - FVector(Radius), Center + FVector(Radius)), Candidates);
+
+    const double RadiusSquared = Radius * Radius;
+    return MakeSpatialQueryResult(Candidates, Center, Params, [&Center, RadiusSquared](const FBox& Bounds)
+    {
+        return Bounds.ComputeSquaredDistanceToPoint(Center) <= RadiusSquared;
+    });
+}
+
+TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleQueryActorsInBox(const TSharedPtr<FJsonObject>& Params)
+{
+    FBox Box;
+    if (Params->HasField(TEXT("min")) && Params->HasField(TEXT("max")))
+    {
+        const FVector Min = FUnrealMCPCommonUtils::GetVectorFromJson(Params, TEXT("min"));
+        const FVector Max = FUnrealMCPCommonUtils::GetVectorFromJson(Params, TEXT("max"));
+        Box = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+    }
+    else if (Params->HasField(TEXT("center")) && Params->HasField(TEXT("extent")))
+    {
+        const FVector Center = FUnrealMCPCommonUtils::GetVectorFromJson(Params, TEXT("center"));
+        const FVector Extent = FUnrealMCPCommonUtils::GetVectorFromJson(Params, TEXT("extent")).GetAbs();
+        Box = FBox(Center - Extent, Center + Extent);
+    }
+    else
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("Either 'min' and 'max' or 'center' and 'extent' must be provided"));
+    }
+
+    TArray<FMCPActorBounds> Candidates;
+    ActorIndex.FindActorsInBox(Box, Candidates);
+
+    return MakeSpatialQueryResult(Candidates, Box.GetCenter(), Params, [&Box](const FBox& Bounds)
+    {
+        return Box.Intersect(Bounds);
+    });
+}
+
+TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleQueryActorsInFrustum(const TSharedPtr<FJsonObject>& Params)
+{
+    FVector Origin;
+    FRotator Rotation = FRotator::ZeroRotator;
+    double FieldOfView = 90.0;
+    double AspectRatio = 16.0 / 9.0;
+
+    if (Params->HasField(TEXT("origin")))
+    {
+        Origin = FUnrealMCPCommonUtils::GetVectorFromJson(Params, TEXT("origin"));
+        if (Params->HasField(TEXT("rotation")))
+        {
+            Rotation = FUnrealMCPCommonUtils::GetRotatorFromJson(Params, TEXT("rotation"));
+        }
+    }
+    else
+    {
+        // Without an origin the query looks through the active level viewport
+        FLevelEditorViewportClient* ViewportClient = GCurrentLevelEditingViewportClient;
+        if (!ViewportClient)
+        {
+            return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("No 'origin' given and no level viewport is active"));
+        }
+
+        Origin = ViewportClient->GetViewLocation();
+        Rotation = ViewportClient->GetViewRotation();
+        FieldOfView = ViewportClient->ViewFOV;
+        const FIntPoint ViewportSize = ViewportClient->Viewport ? ViewportClient->Viewport->GetSizeXY() : FIntPoint::ZeroValue;
+        if (ViewportSize.X > 0 && ViewportSize.Y > 0)
+        {
+            AspectRatio = (double)ViewportSize.X / ViewportSize.Y;
+        }
+    }
+
+    double NearDistance = MCP_FRUSTUM_DEFAULT_NEAR_DISTANCE;
+    double FarDistance = MCP_FRUSTUM_DEFAULT_FAR_DISTANCE;
+    Params->TryGetNumberField(TEXT("fov"), FieldOfView);
+    Params->TryGetNumberField(TEXT("aspect_ratio"), AspectRatio);
+    Params->TryGetNumberField(TEXT("near"), NearDistance);
+    Params->TryGetNumberField(TEXT("far"), FarDistance);
+
+    if (FieldOfView <= 0.0 || FieldOfView >= 180.0)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("'fov' must be between 0 and 180 degrees"));
+    }
+    if (AspectRatio <= 0.0)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("'aspect_ratio' must be positive"));
+    }
+    if (NearDistance <= 0.0 || FarDistance <= NearDistance)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("'near' must be positive and less than 'far'"));
+    }
+
+    // The camera's view, with the renderer's axis swap, and a standard (not reversed-Z) perspective
+    // projection with a finite far plane, which is what GetViewFrustumBounds expects; fov is horizontal
+    const double HalfFieldOfView = FMath::DegreesToRadians(FieldOfView * 0.5);
+    const FMatrix ViewMatrix = FTranslationMatrix(-Origin) * FInverseRotationMatrix(Rotation) * FMatrix(
+        FPlane(0, 0, 1, 0),
+        FPlane(1, 0, 0, 0),
+        FPlane(0, 1, 0, 0),
+        FPlane(0, 0, 0, 1));
+    const FMatrix ProjectionMatrix = FPerspectiveMatrix(HalfFieldOfView, AspectRatio, 1.0, NearDistance, FarDistance);
+
+    FConvexVolume Frustum;
+    GetViewFrustumBounds(Frustum, ViewMatrix * ProjectionMatrix, true);
+
+    // The octree is searched with the box around the frustum's corners, then each hit is tested against the planes
+    const FRotationMatrix Axes(Rotation);
+    const double TanHalfFieldOfView = FMath::Tan(HalfFieldOfView);
+    FBox FrustumBox(ForceInit);
+    for (const double Distance : { NearDistance, FarDistance })
+    {
+        const FVector PlaneCenter = Origin + Axes.GetUnitAxis(EAxis::X) * Distance;
+        const FVector HalfWidth = Axes.GetUnitAxis(EAxis::Y) * (Distance * TanHalfFieldOfView);
+        const FVector HalfHeight = Axes.GetUnitAxis(EAxis::Z) * (Distance * TanHalfFieldOfView / AspectRatio);
+        FrustumBox += PlaneCenter + HalfWidth + HalfHeight;
+        FrustumBox += PlaneCenter + HalfWidth - HalfHeight;
+        FrustumBox += PlaneCenter - HalfWidth + HalfHeight;
+        FrustumBox += PlaneCenter - HalfWidth - HalfHeight;
+    }
+
+    TArray<FMCPActorBounds> Candidates;
+    ActorIndex.FindActorsInBox(FrustumBox, Candidates);
+
+    return MakeSpatialQueryResult(Candidates, Origin, Params, [&Frustum](const FBox& Bounds)
+    {
+        return Frustum.IntersectBox(Bounds.GetCenter(), Bounds.GetExtent());
+    });
+}
+
 TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSpawnBlueprintActor(const TSharedPtr<FJsonObject>& Params)
 {
     // Get required parameters
@@ -456,6 +1316,12 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSpawnBlueprintActor(cons
         return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("Failed to get editor world"));
     }
 
+    // Check if an actor with this name already exists
+    if (ActorIndex.FindActorByName(ActorName))
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Actor with name '%s' already exists"), *ActorName));
+    }
+
     FTransform SpawnTransform;
     SpawnTransform.SetLocation(Location);
     SpawnTransform.SetRotation(FQuat(Rotation));
@@ -467,6 +1333,7 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleSpawnBlueprintActor(cons
     AActor* NewActor = World->SpawnActor<AActor>(Blueprint->GeneratedClass, SpawnTransform, SpawnParams);
     if (NewActor)
     {
+        ActorIndex.NotifyActorChanged(NewActor, EMCPActorChange::Added);
         return FUnrealMCPCommonUtils::ActorToJsonObject(NewActor, true);
     }
 
@@ -515,18 +1382,7 @@ TSharedPtr<FJsonObject> FUnrealMCPEditorCommands::HandleFocusViewport(const TSha
     if (HasTargetActor)
     {
         // Find the actor
-        AActor* TargetActor = nullptr;
-        TArray<AActor*> AllActors;
-        UGameplayStatics::GetAllActorsOfClass(GWorld, AActor::StaticClass(), AllActors);
-        
-        for (AActor* Actor : AllActors)
-        {
-            if (Actor && Actor->GetName() == TargetActorName)
-            {
-                TargetActor = Actor;
-                break;
-            }
-        }
+        AActor* TargetActor = ActorIndex.FindActorByName(TargetActorName);
 
         if (!TargetActor)
         {
@@ -1,19 +1,33 @@
 #include "Commands/UnrealMCPProjectCommands.h"
 #include "Commands/UnrealMCPCommonUtils.h"
+#include "MCPCommandRegistry.h"
 #include "GameFramework/InputSettings.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetRegistry/ARFilter.h"
+#include "Misc/ConfigCacheIni.h"
+
+// Most assets one find_assets call returns unless it asks for fewer
+#define MCP_FIND_ASSETS_DEFAULT_LIMIT 1000
 
 FUnrealMCPProjectCommands::FUnrealMCPProjectCommands()
 {
 }
 
-TSharedPtr<FJsonObject> FUnrealMCPProjectCommands::HandleCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params)
+void FUnrealMCPProjectCommands::RegisterCommands(FMCPCommandRegistry& Registry)
 {
-    if (CommandType == TEXT("create_input_mapping"))
-    {
-        return HandleCreateInputMapping(Params);
-    }
-    
-    return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown project command: %s"), *CommandType));
+    Registry.Register(TEXT("create_input_mapping"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleCreateInputMapping(Params); })
+        .Require(TEXT("action_name"))
+        .Require(TEXT("key"));
+
+    // The asset registry locks internally, so this runs on the request workers
+    Registry.Register(TEXT("find_assets"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleFindAssets(Params); })
+        .AnyThread()
+        .ReadOnly();
+    // GConfig has no lock against the editor changing or saving settings, so this waits for the game thread
+    Registry.Register(TEXT("get_config_value"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleGetConfigValue(Params); })
+        .ReadOnly()
+        .Require(TEXT("section"))
+        .Require(TEXT("key"));
 }
 
 TSharedPtr<FJsonObject> FUnrealMCPProjectCommands::HandleCreateInputMapping(const TSharedPtr<FJsonObject>& Params)
@@ -69,4 +83,141 @@ TSharedPtr<FJsonObject> FUnrealMCPProjectCommands::HandleCreateInputMapping(cons
     ResultObj->SetStringField(TEXT("action_name"), ActionName);
     ResultObj->SetStringField(TEXT("key"), Key);
     return ResultObj;
-} 
\ No newline at end of file
+} 
+
+TSharedPtr<FJsonObject> FUnrealMCPProjectCommands::HandleFindAssets(const TSharedPtr<FJsonObject>& Params)
+{
+    FString Path = TEXT("/Game");
+    Params->TryGetStringField(TEXT("path"), Path);
+
+    FString ClassName;
+    Params->TryGetStringField(TEXT("class"), ClassName);
+
+    FString NameFilter;
+    Params->TryGetStringField(TEXT("name"), NameFilter);
+
+    bool bRecursive = true;
+    Params->TryGetBoolField(TEXT("recursive"), bRecursive);
+
+    int32 Limit = MCP_FIND_ASSETS_DEFAULT_LIMIT;
+    Params->TryGetNumberField(TEXT("limit"), Limit);
+    if (Limit <= 0)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("'limit' must be positive"));
+    }
+
+    // The registry module is loaded at startup; IAssetRegistry::Get avoids the module manager,
+    // which may only be used from the game thread
+    IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+    if (!AssetRegistry)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("Asset registry is not available"));
+    }
+
+    // In-memory assets can only be enumerated on the game thread, so only saved assets are listed
+    FARFilter Filter;
+    Filter.PackagePaths.Add(FName(*Path));
+    Filter.bRecursivePaths = bRecursive;
+    Filter.bIncludeOnlyOnDiskAssets = true;
+
+    // A full class path filters in the registry. A short name like "StaticMesh" is compared
+    // after the query, since resolving it to a path needs the game thread.
+    const bool bClassPath = ClassName.StartsWith(TEXT("/"));
+    if (bClassPath)
+    {
+        Filter.ClassPaths.Add(FTopLevelAssetPath(ClassName));
+    }
+    const FName ShortClassName = !bClassPath && !ClassName.IsEmpty() ? FName(*ClassName) : NAME_None;
+
+    TArray<FAssetData> Assets;
+    AssetRegistry->GetAssets(Filter, Assets);
+
+    TArray<TSharedPtr<FJsonValue>> AssetsJson;
+    int32 Matched = 0;
+    for (const FAssetData& Asset : Assets)
+    {
+        if (!ShortClassName.IsNone() && Asset.AssetClassPath.GetAssetName() != ShortClassName)
+        {
+            continue;
+        }
+        if (!NameFilter.IsEmpty() && !Asset.AssetName.ToString().Contains(NameFilter))
+        {
+            continue;
+        }
+
+        if (++Matched > Limit)
+        {
+            continue;
+        }
+
+        TSharedPtr<FJsonObject> AssetJson = MakeShared<FJsonObject>();
+        AssetJson->SetStringField(TEXT("name"), Asset.AssetName.ToString());
+        AssetJson->SetStringField(TEXT("path"), Asset.GetObjectPathString());
+        AssetJson->SetStringField(TEXT("class"), Asset.AssetClassPath.ToString());
+        AssetsJson.Add(MakeShared<FJsonValueObject>(AssetJson));
+    }
+
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetArrayField(TEXT("assets"), AssetsJson);
+    ResultObj->SetNumberField(TEXT("total"), Matched);
+    ResultObj->SetBoolField(TEXT("truncated"), Matched > Limit);
+    // Results may be incomplete until the initial scan has finished
+    ResultObj->SetBoolField(TEXT("scanning"), AssetRegistry->IsLoadingAssets());
+    return ResultObj;
+}
+
+TSharedPtr<FJsonObject> FUnrealMCPProjectCommands::HandleGetConfigValue(const TSharedPtr<FJsonObject>& Params)
+{
+    const FString Section = Params->GetStringField(TEXT("section"));
+    const FString Key = Params->GetStringField(TEXT("key"));
+
+    FString File = TEXT("game");
+    Params->TryGetStringField(TEXT("file"), File);
+
+    const FString* ConfigFile = nullptr;
+    if (File == TEXT("engine"))
+    {
+        ConfigFile = &GEngineIni;
+    }
+    else if (File == TEXT("game"))
+    {
+        ConfigFile = &GGameIni;
+    }
+    else if (File == TEXT("editor"))
+    {
+        ConfigFile = &GEditorIni;
+    }
+    else if (File == TEXT("input"))
+    {
+        ConfigFile = &GInputIni;
+    }
+    else if (File == TEXT("editor_per_project"))
+    {
+        ConfigFile = &GEditorPerProjectIni;
+    }
+    else
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown config file '%s', expected engine, game, editor, input or editor_per_project"), *File));
+    }
+
+    // Keys that appear more than once, such as +Paths=..., come back as several values
+    TArray<FString> Values;
+    GConfig->GetArray(*Section, *Key, Values, *ConfigFile);
+
+    TArray<TSharedPtr<FJsonValue>> ValuesJson;
+    for (const FString& Value : Values)
+    {
+        ValuesJson.Add(MakeShared<FJsonValueString>(Value));
+    }
+
+    TSharedPtr<FJsonObject> ResultObj = MakeShared<FJsonObject>();
+    ResultObj->SetStringField(TEXT("section"), Section);
+    ResultObj->SetStringField(TEXT("key"), Key);
+    ResultObj->SetBoolField(TEXT("found"), Values.Num() > 0);
+    if (Values.Num() > 0)
+    {
+        ResultObj->SetStringField(TEXT("value"), Values.Last());
+    }
+    ResultObj->SetArrayField(TEXT("values"), ValuesJson);
+    return ResultObj;
+}
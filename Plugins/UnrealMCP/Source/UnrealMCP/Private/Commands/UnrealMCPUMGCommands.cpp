@@ -1,5 +1,6 @@
 #include "Commands/UnrealMCPUMGCommands.h"
 #include "Commands/UnrealMCPCommonUtils.h"
+#include "MCPCommandRegistry.h"
 #include "Editor.h"
 #include "EditorAssetLibrary.h"
 #include "AssetRegistry/AssetRegistryModule.h"
@@ -30,34 +31,27 @@ FUnrealMCPUMGCommands::FUnrealMCPUMGCommands()
 {
 }
 
-TSharedPtr<FJsonObject> FUnrealMCPUMGCommands::HandleCommand(const FString& CommandName, const TSharedPtr<FJsonObject>& Params)
+void FUnrealMCPUMGCommands::RegisterCommands(FMCPCommandRegistry& Registry)
 {
-	if (CommandName == TEXT("create_umg_widget_blueprint"))
-	{
-		return HandleCreateUMGWidgetBlueprint(Params);
-	}
-	else if (CommandName == TEXT("add_text_block_to_widget"))
-	{
-		return HandleAddTextBlockToWidget(Params);
-	}
-	else if (CommandName == TEXT("add_widget_to_viewport"))
-	{
-		return HandleAddWidgetToViewport(Params);
-	}
-	else if (CommandName == TEXT("add_button_to_widget"))
-	{
-		return HandleAddButtonToWidget(Params);
-	}
-	else if (CommandName == TEXT("bind_widget_event"))
-	{
-		return HandleBindWidgetEvent(Params);
-	}
-	else if (CommandName == TEXT("set_text_block_binding"))
-	{
-		return HandleSetTextBlockBinding(Params);
-	}
-
-	return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown UMG command: %s"), *CommandName));
+	Registry.Register(TEXT("create_umg_widget_blueprint"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleCreateUMGWidgetBlueprint(Params); })
+		.Require(TEXT("widget_name"));
+	Registry.Register(TEXT("add_text_block_to_widget"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddTextBlockToWidget(Params); })
+		.Require(TEXT("blueprint_name"))
+		.Require(TEXT("widget_name"));
+	Registry.Register(TEXT("add_widget_to_viewport"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddWidgetToViewport(Params); })
+		.Require(TEXT("blueprint_name"));
+	Registry.Register(TEXT("add_button_to_widget"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleAddButtonToWidget(Params); })
+		.Require(TEXT("blueprint_name"))
+		.Require(TEXT("widget_name"))
+		.Require(TEXT("text"));
+	Registry.Register(TEXT("bind_widget_event"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleBindWidgetEvent(Params); })
+		.Require(TEXT("blueprint_name"))
+		.Require(TEXT("widget_name"))
+		.Require(TEXT("event_name"));
+	Registry.Register(TEXT("set_text_block_binding"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleSetTextBlockBinding(Params); })
+		.Require(TEXT("blueprint_name"))
+		.Require(TEXT("widget_name"))
+		.Require(TEXT("binding_name"));
 }
 
 TSharedPtr<FJsonObject> FUnrealMCPUMGCommands::HandleCreateUMGWidgetBlueprint(const TSharedPtr<FJsonObject>& Params)
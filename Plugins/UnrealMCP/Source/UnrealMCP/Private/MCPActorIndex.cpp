@@ -0,0 +1,760 @@
+#include "MCPActorIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "Editor.h"
+#include "EngineDefines.h"
+#include "EngineUtils.h"
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+#include "Internationalization/Regex.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/UObjectGlobals.h"
+
+FMCPActorIndex::FMCPActorIndex()
+    : bStale(true)
+    , bSubscribed(false)
+{
+}
+
+FMCPActorIndex::~FMCPActorIndex()
+{
+    Reset();
+}
+
+void FMCPActorIndex::Reset()
+{
+    if (bSubscribed)
+    {
+        if (GEngine)
+        {
+            GEngine->OnLevelActorAdded().Remove(ActorAddedHandle);
+            GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+            GEngine->OnLevelActorListChanged().Remove(ActorListChangedHandle);
+            GEngine->OnActorMoved().Remove(ActorMovedHandle);
+        }
+        FCoreDelegates::OnActorLabelChanged.Remove(ActorLabelChangedHandle);
+        FEditorDelegates::MapChange.Remove(MapChangeHandle);
+        FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+        FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+        bSubscribed = false;
+    }
+
+    ActorsByName.Reset();
+    ActorsByLabel.Reset();
+    ActorsByClass.Reset();
+    KeysByActor.Reset();
+    Octree.Reset();
+    SearchEntries.Reset();
+    SearchEntriesByTrigram.Reset();
+    IndexedWorld.Reset();
+    bStale = true;
+}
+
+AActor* FMCPActorIndex::FindActorByName(const FString& Name)
+{
+    EnsureUpToDate();
+
+    // FNAME_Find looks the string up without adding it; a name never seen cannot be an actor's
+    const FName ActorName(*Name, FNAME_Find);
+    if (ActorName.IsNone())
+    {
+        return nullptr;
+    }
+
+    const TWeakObjectPtr<AActor>* Found = ActorsByName.Find(ActorName);
+    AActor* Actor = Found ? Found->Get() : nullptr;
+    return IsValid(Actor) && Actor->GetFName() == ActorName ? Actor : nullptr;
+}
+
+void FMCPActorIndex::FindActorsByLabel(const FString& Label, TArray<AActor*>& OutActors)
+{
+    EnsureUpToDate();
+
+    if (const TArray<TWeakObjectPtr<AActor>>* Bucket = ActorsByLabel.Find(Label))
+    {
+        for (const TWeakObjectPtr<AActor>& WeakActor : *Bucket)
+        {
+            AActor* Actor = WeakActor.Get();
+            if (IsValid(Actor))
+            {
+                OutActors.Add(Actor);
+            }
+        }
+    }
+}
+
+void FMCPActorIndex::FindActorsOfClass(FName ClassName, TArray<AActor*>& OutActors)
+{
+    EnsureUpToDate();
+
+    if (const TArray<TWeakObjectPtr<AActor>>* Bucket = ActorsByClass.Find(ClassName))
+    {
+        for (const TWeakObjectPtr<AActor>& WeakActor : *Bucket)
+        {
+            AActor* Actor = WeakActor.Get();
+            if (IsValid(Actor))
+            {
+                OutActors.Add(Actor);
+            }
+        }
+    }
+}
+
+void FMCPActorIndex::GetAllActors(TArray<AActor*>& OutActors)
+{
+    EnsureUpToDate();
+
+    OutActors.Reserve(OutActors.Num() + ActorsByName.Num());
+    for (const TPair<FName, TWeakObjectPtr<AActor>>& Pair : ActorsByName)
+    {
+        AActor* Actor = Pair.Value.Get();
+        if (IsValid(Actor))
+        {
+            OutActors.Add(Actor);
+        }
+    }
+}
+
+void FMCPActorIndex::FindActorsInBox(const FBox& Box, TArray<FMCPActorBounds>& OutActors)
+{
+    EnsureUpToDate();
+
+    if (!Octree)
+    {
+        return;
+    }
+
+    Octree->FindElementsWithBoundsTest(FBoxCenterAndExtent(Box), [&OutActors](const FOctreeElement& Element)
+    {
+        AActor* Actor = Element.Actor.Get();
+        if (IsValid(Actor))
+        {
+            OutActors.Add({ Actor, Element.Bounds });
+        }
+    });
+}
+
+/** Three characters, lowercased, packed into one trigram key */
+static uint64 MakeTrigram(TCHAR First, TCHAR Second, TCHAR Third)
+{
+    return ((uint64)FChar::ToLower(First) << 42) | ((uint64)FChar::ToLower(Second) << 21) | (uint64)FChar::ToLower(Third);
+}
+
+template <typename AllocatorType>
+static void AddTrigrams(FStringView Text, TArray<uint64, AllocatorType>& OutTrigrams)
+{
+    for (int32 Index = 0; Index + 2 < Text.Len(); ++Index)
+    {
+        OutTrigrams.Add(MakeTrigram(Text[Index], Text[Index + 1], Text[Index + 2]));
+    }
+}
+
+/** One bit per letter and digit, the rest of the characters sharing the remaining bits */
+static uint64 GetCharacterMask(FStringView Text)
+{
+    uint64 Mask = 0;
+    for (const TCHAR Character : Text)
+    {
+        const TCHAR Lower = FChar::ToLower(Character);
+        const uint32 Bit = (Lower >= TEXT('a') && Lower <= TEXT('z')) ? Lower - TEXT('a')
+            : (Lower >= TEXT('0') && Lower <= TEXT('9')) ? 26 + Lower - TEXT('0')
+            : 36 + (uint32)Lower % 28;
+        Mask |= 1ull << Bit;
+    }
+    return Mask;
+}
+
+/** Literal runs of a regular expression that every match contains; none when that is unclear */
+static void GetRegexLiterals(const FString& Pattern, TArray<FString>& OutLiterals)
+{
+    // With alternation, no run is certain to be in a match
+    if (Pattern.Contains(TEXT("|")))
+    {
+        return;
+    }
+
+    FString Run;
+    int32 GroupDepth = 0;
+    bool bInClass = false;
+    for (int32 Index = 0; Index < Pattern.Len(); ++Index)
+    {
+        const TCHAR Character = Pattern[Index];
+        const TCHAR Next = Index + 1 < Pattern.Len() ? Pattern[Index + 1] : TEXT('\0');
+        const bool bLiteral = !bInClass && GroupDepth == 0 && (FChar::IsAlnum(Character) || Character == TEXT('_') || Character == TEXT(' ') || Character == TEXT('-'));
+        if (bLiteral)
+        {
+            // A character that may be left out makes the run it ends uncertain, so drop it all
+            const bool bOptional = Next == TEXT('?') || Next == TEXT('*') || (Next == TEXT('{') && Index + 2 < Pattern.Len() && Pattern[Index + 2] == TEXT('0'));
+            if (bOptional)
+            {
+                Run.Reset();
+                continue;
+            }
+            Run.AppendChar(Character);
+            if (Next != TEXT('{'))
+            {
+                continue;
+            }
+        }
+
+        // Anything else ends the run: metacharacters, groups, classes and repeated characters
+        if (!Run.IsEmpty())
+        {
+            OutLiterals.Add(MoveTemp(Run));
+            Run.Reset();
+        }
+        if (bLiteral)
+        {
+            continue;
+        }
+        if (Character == TEXT('\\'))
+        {
+            ++Index;
+        }
+        else if (!bInClass && Character == TEXT('{'))
+        {
+            // A quantifier's counts are not text of the match
+            while (Index + 1 < Pattern.Len() && Pattern[Index] != TEXT('}'))
+            {
+                ++Index;
+            }
+        }
+        else if (Character == TEXT('['))
+        {
+            bInClass = true;
+        }
+        else if (Character == TEXT(']'))
+        {
+            bInClass = false;
+        }
+        else if (!bInClass && Character == TEXT('('))
+        {
+            ++GroupDepth;
+        }
+        else if (!bInClass && Character == TEXT(')'))
+        {
+            GroupDepth = FMath::Max(0, GroupDepth - 1);
+        }
+    }
+    if (!Run.IsEmpty())
+    {
+        OutLiterals.Add(MoveTemp(Run));
+    }
+}
+
+/** Text that every name or label matching Pattern contains */
+static void GetSearchLiterals(const FString& Pattern, EMCPActorSearchMode Mode, TArray<FString>& OutLiterals)
+{
+    switch (Mode)
+    {
+    case EMCPActorSearchMode::Substring:
+        OutLiterals.Add(Pattern);
+        break;
+    case EMCPActorSearchMode::Glob:
+    {
+        // The text between wildcards
+        FString Literal;
+        for (const TCHAR Character : Pattern)
+        {
+            if (Character != TEXT('*') && Character != TEXT('?'))
+            {
+                Literal.AppendChar(Character);
+            }
+            else if (!Literal.IsEmpty())
+            {
+                OutLiterals.Add(MoveTemp(Literal));
+                Literal.Reset();
+            }
+        }
+        if (!Literal.IsEmpty())
+        {
+            OutLiterals.Add(MoveTemp(Literal));
+        }
+        break;
+    }
+    case EMCPActorSearchMode::Regex:
+        GetRegexLiterals(Pattern, OutLiterals);
+        break;
+    default:
+        // A fuzzy pattern's characters need not be next to each other
+        break;
+    }
+}
+
+static bool IsWordStart(const FString& Text, int32 Index)
+{
+    if (Index == 0)
+    {
+        return true;
+    }
+    const TCHAR Previous = Text[Index - 1];
+    const TCHAR Character = Text[Index];
+    return !FChar::IsAlnum(Previous)
+        || (FChar::IsLower(Previous) && FChar::IsUpper(Character))
+        || (FChar::IsAlpha(Previous) && FChar::IsDigit(Character));
+}
+
+/**
+ * How closely Text holds Pattern's characters in order, from 0 for not at all to about 1 for
+ * a match at its start. Characters that follow one another or start a word count for more,
+ * and longer texts for slightly less.
+ */
+static float GetFuzzyScore(const FString& Pattern, const FString& Text, ESearchCase::Type SearchCase)
+{
+    if (Pattern.IsEmpty() || Pattern.Len() > Text.Len())
+    {
+        return 0.0f;
+    }
+
+    float Score = 0.0f;
+    int32 TextIndex = 0;
+    int32 PreviousMatch = INDEX_NONE;
+    for (const TCHAR PatternCharacter : Pattern)
+    {
+        const TCHAR Wanted = SearchCase == ESearchCase::IgnoreCase ? FChar::ToLower(PatternCharacter) : PatternCharacter;
+        while (TextIndex < Text.Len() && (SearchCase == ESearchCase::IgnoreCase ? FChar::ToLower(Text[TextIndex]) : Text[TextIndex]) != Wanted)
+        {
+            ++TextIndex;
+        }
+        if (TextIndex == Text.Len())
+        {
+            return 0.0f;
+        }
+
+        Score += 1.0f;
+        if (PreviousMatch != INDEX_NONE && TextIndex == PreviousMatch + 1)
+        {
+            Score += 2.0f;
+        }
+        if (IsWordStart(Text, TextIndex))
+        {
+            Score += 3.0f;
+        }
+        PreviousMatch = TextIndex++;
+    }
+
+    // Every match keeps a positive score, however long its text
+    return FMath::Max(Score / (6.0f * Pattern.Len()) - 0.002f * (Text.Len() - Pattern.Len()), KINDA_SMALL_NUMBER);
+}
+
+void FMCPActorIndex::SearchActors(const FString& Pattern, EMCPActorSearchMode Mode, ESearchCase::Type SearchCase, TArray<FMCPActorSearchMatch>& OutMatches)
+{
+    EnsureUpToDate();
+
+    TArray<FString> Literals;
+    GetSearchLiterals(Pattern, Mode, Literals);
+
+    TArray<uint64> Trigrams;
+    uint64 RequiredCharacters = Mode == EMCPActorSearchMode::Fuzzy ? GetCharacterMask(Pattern) : 0;
+    for (const FString& Literal : Literals)
+    {
+        AddTrigrams(Literal, Trigrams);
+        RequiredCharacters |= GetCharacterMask(Literal);
+    }
+    Algo::Sort(Trigrams);
+    Trigrams.SetNum(Algo::Unique(Trigrams));
+
+    TArray<int32> Candidates;
+    FindSearchCandidates(Trigrams, Candidates);
+
+    TOptional<FRegexPattern> RegexPattern;
+    if (Mode == EMCPActorSearchMode::Regex)
+    {
+        RegexPattern.Emplace(Pattern, SearchCase == ESearchCase::IgnoreCase ? ERegexPatternFlags::CaseInsensitive : ERegexPatternFlags::None);
+    }
+
+    for (const int32 SearchId : Candidates)
+    {
+        const FSearchEntry& Entry = SearchEntries[SearchId];
+        AActor* Actor = Entry.Actor.Get();
+        if ((Entry.CharacterMask & RequiredCharacters) != RequiredCharacters || !IsValid(Actor))
+        {
+            continue;
+        }
+
+        bool bMatched = false;
+        float Score = 0.0f;
+        switch (Mode)
+        {
+        case EMCPActorSearchMode::Substring:
+            bMatched = Entry.Name.Contains(Pattern, SearchCase) || Entry.Label.Contains(Pattern, SearchCase);
+            break;
+        case EMCPActorSearchMode::Glob:
+            bMatched = Entry.Name.MatchesWildcard(Pattern, SearchCase) || Entry.Label.MatchesWildcard(Pattern, SearchCase);
+            break;
+        case EMCPActorSearchMode::Regex:
+        {
+            FRegexMatcher NameMatcher(*RegexPattern, Entry.Name);
+            FRegexMatcher LabelMatcher(*RegexPattern, Entry.Label);
+            bMatched = NameMatcher.FindNext() || LabelMatcher.FindNext();
+            break;
+        }
+        case EMCPActorSearchMode::Fuzzy:
+            Score = FMath::Max(GetFuzzyScore(Pattern, Entry.Name, SearchCase), GetFuzzyScore(Pattern, Entry.Label, SearchCase));
+            bMatched = Score > 0.0f;
+            break;
+        }
+
+        if (bMatched)
+        {
+            OutMatches.Add({ Actor, Score });
+        }
+    }
+}
+
+void FMCPActorIndex::FindSearchCandidates(const TArray<uint64>& Trigrams, TArray<int32>& OutCandidates) const
+{
+    if (Trigrams.IsEmpty())
+    {
+        OutCandidates.Reserve(SearchEntries.Num());
+        for (TSparseArray<FSearchEntry>::TConstIterator It(SearchEntries); It; ++It)
+        {
+            OutCandidates.Add(It.GetIndex());
+        }
+        return;
+    }
+
+    TArray<const TArray<int32>*, TInlineAllocator<16>> Lists;
+    for (const uint64 Trigram : Trigrams)
+    {
+        const TArray<int32>* Entries = SearchEntriesByTrigram.Find(Trigram);
+        if (!Entries)
+        {
+            // Nothing holds this trigram, so nothing can match
+            return;
+        }
+        Lists.Add(Entries);
+    }
+
+    // Walk the shortest list and look its entries up in the others
+    Algo::SortBy(Lists, [](const TArray<int32>* Entries) { return Entries->Num(); });
+    for (const int32 SearchId : *Lists[0])
+    {
+        bool bInAll = true;
+        for (int32 ListIndex = 1; ListIndex < Lists.Num() && bInAll; ++ListIndex)
+        {
+            bInAll = Algo::BinarySearch(*Lists[ListIndex], SearchId) != INDEX_NONE;
+        }
+        if (bInAll)
+        {
+            OutCandidates.Add(SearchId);
+        }
+    }
+}
+
+void FMCPActorIndex::NotifyActorChanged(AActor* Actor, EMCPActorChange Change)
+{
+    check(IsInGameThread());
+
+    // Spawns are normally indexed and reported through the engine's event already
+    if (Change == EMCPActorChange::Added)
+    {
+        if (!KeysByActor.Contains(Actor))
+        {
+            OnLevelActorAdded(Actor);
+        }
+        return;
+    }
+
+    UpdateActorBounds(Actor);
+    BroadcastChange(Change, Actor);
+}
+
+void FMCPActorIndex::UpdateActorBounds(AActor* Actor)
+{
+    // A stale index recomputes every actor's bounds when it is rebuilt
+    const FIndexedKeys* Keys = bStale ? nullptr : KeysByActor.Find(Actor);
+    if (!Keys || !Octree || !IsValid(Actor))
+    {
+        return;
+    }
+
+    if (Keys->OctreeId->IsValidId())
+    {
+        Octree->RemoveElement(*Keys->OctreeId);
+    }
+    AddToOctree(Actor, *Keys);
+}
+
+int32 FMCPActorIndex::Num()
+{
+    EnsureUpToDate();
+    return ActorsByName.Num();
+}
+
+void FMCPActorIndex::EnsureUpToDate()
+{
+    check(IsInGameThread());
+
+    if (!bSubscribed && GEngine)
+    {
+        ActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &FMCPActorIndex::OnLevelActorAdded);
+        ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &FMCPActorIndex::OnLevelActorDeleted);
+        ActorListChangedHandle = GEngine->OnLevelActorListChanged().AddRaw(this, &FMCPActorIndex::MarkStale);
+        ActorLabelChangedHandle = FCoreDelegates::OnActorLabelChanged.AddRaw(this, &FMCPActorIndex::OnActorLabelChanged);
+        MapChangeHandle = FEditorDelegates::MapChange.AddLambda([this](uint32 MapChangeFlags) { MarkStale(); });
+        ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([this](const TMap<UObject*, UObject*>& ReplacementMap) { MarkStale(); });
+        ActorMovedHandle = GEngine->OnActorMoved().AddRaw(this, &FMCPActorIndex::OnActorMoved);
+        ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FMCPActorIndex::OnObjectPropertyChanged);
+        bSubscribed = true;
+        bStale = true;
+    }
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (bStale || IndexedWorld.Get() != World)
+    {
+        Rebuild(World);
+    }
+}
+
+void FMCPActorIndex::Rebuild(UWorld* World)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Kept to report the actors added and removed while the index was stale
+    const bool bHadWorld = !IndexedWorld.IsExplicitlyNull();
+    const bool bSameWorld = bHadWorld && IndexedWorld.Get() == World;
+    TMap<TObjectKey<AActor>, FIndexedKeys> PreviousKeys = MoveTemp(KeysByActor);
+
+    ActorsByName.Reset();
+    ActorsByLabel.Reset();
+    ActorsByClass.Reset();
+    KeysByActor.Reset();
+    Octree.Reset();
+    SearchEntries.Reset();
+    SearchEntriesByTrigram.Reset();
+    IndexedWorld = World;
+    bStale = false;
+
+    if (World)
+    {
+        Octree = MakeUnique<FActorOctree>(FVector::ZeroVector, HALF_WORLD_MAX);
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            AddActor(*It);
+        }
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("MCPActorIndex: Indexed %d actors in %.2f ms"), ActorsByName.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    if (bSameWorld)
+    {
+        // Removals first, so an actor replaced under the same name ends up reported as added
+        for (const TPair<TObjectKey<AActor>, FIndexedKeys>& Pair : PreviousKeys)
+        {
+            if (!KeysByActor.Contains(Pair.Key))
+            {
+                ActorChangedEvent.Broadcast(EMCPActorChange::Removed, nullptr, Pair.Value.Name);
+            }
+        }
+        for (const TPair<TObjectKey<AActor>, FIndexedKeys>& Pair : KeysByActor)
+        {
+            if (!PreviousKeys.Contains(Pair.Key))
+            {
+                ActorChangedEvent.Broadcast(EMCPActorChange::Added, Pair.Key.ResolveObjectPtr(), Pair.Value.Name);
+            }
+        }
+    }
+    else if (bHadWorld)
+    {
+        ActorChangedEvent.Broadcast(EMCPActorChange::Reset, nullptr, NAME_None);
+    }
+}
+
+void FMCPActorIndex::AddActor(AActor* Actor)
+{
+    if (!IsValid(Actor))
+    {
+        return;
+    }
+
+    // An actor already indexed under other keys is moved to its current ones
+    RemoveActor(Actor);
+
+    FIndexedKeys Keys;
+    Keys.Name = Actor->GetFName();
+    Keys.Label = Actor->GetActorLabel();
+    Keys.ClassName = Actor->GetClass()->GetFName();
+    Keys.OctreeId = MakeShared<FOctreeElementId2>();
+
+    ActorsByName.Add(Keys.Name, Actor);
+    ActorsByLabel.FindOrAdd(Keys.Label).Add(Actor);
+    ActorsByClass.FindOrAdd(Keys.ClassName).Add(Actor);
+    if (Octree)
+    {
+        AddToOctree(Actor, Keys);
+    }
+    AddSearchEntry(Actor, Keys);
+    KeysByActor.Add(Actor, MoveTemp(Keys));
+}
+
+void FMCPActorIndex::AddToOctree(AActor* Actor, const FIndexedKeys& Keys)
+{
+    // Actors without primitive components, such as lights, are filed as a point at their location
+    FBox Bounds = Actor->GetComponentsBoundingBox(true);
+    if (!Bounds.IsValid)
+    {
+        Bounds = FBox(Actor->GetActorLocation(), Actor->GetActorLocation());
+    }
+
+    FOctreeElement Element;
+    Element.Actor = Actor;
+    Element.Bounds = Bounds;
+    Element.Id = Keys.OctreeId;
+    Octree->AddElement(Element);
+}
+
+/** Removes Actor, and entries whose actor is gone, from one bucket; drops the bucket once empty */
+template <typename KeyType>
+static void RemoveFromBucket(TMap<KeyType, TArray<TWeakObjectPtr<AActor>>>& Buckets, const KeyType& Key, const AActor* Actor)
+{
+    if (TArray<TWeakObjectPtr<AActor>>* Bucket = Buckets.Find(Key))
+    {
+        Bucket->RemoveAllSwap([Actor](const TWeakObjectPtr<AActor>& Entry) { return !Entry.IsValid() || Entry.Get() == Actor; });
+        if (Bucket->IsEmpty())
+        {
+            Buckets.Remove(Key);
+        }
+    }
+}
+
+void FMCPActorIndex::RemoveActor(const AActor* Actor)
+{
+    FIndexedKeys Keys;
+    if (!KeysByActor.RemoveAndCopyValue(Actor, Keys))
+    {
+        return;
+    }
+
+    // Another actor may have taken the name since
+    const TWeakObjectPtr<AActor>* NamedActor = ActorsByName.Find(Keys.Name);
+    if (NamedActor && (NamedActor->Get() == Actor || !NamedActor->IsValid()))
+    {
+        ActorsByName.Remove(Keys.Name);
+    }
+
+    RemoveFromBucket(ActorsByLabel, Keys.Label, Actor);
+    RemoveFromBucket(ActorsByClass, Keys.ClassName, Actor);
+
+    if (Octree && Keys.OctreeId->IsValidId())
+    {
+        Octree->RemoveElement(*Keys.OctreeId);
+    }
+    if (Keys.SearchId != INDEX_NONE)
+    {
+        RemoveSearchEntry(Keys.SearchId);
+    }
+}
+
+void FMCPActorIndex::AddSearchEntry(AActor* Actor, FIndexedKeys& Keys)
+{
+    FSearchEntry Entry;
+    Entry.Actor = Actor;
+    Entry.Name = Keys.Name.ToString();
+    Entry.Label = Keys.Label;
+    Entry.CharacterMask = GetCharacterMask(Entry.Name) | GetCharacterMask(Entry.Label);
+
+    TArray<uint64, TInlineAllocator<64>> Trigrams;
+    AddTrigrams(Entry.Name, Trigrams);
+    AddTrigrams(Entry.Label, Trigrams);
+    Algo::Sort(Trigrams);
+    Trigrams.SetNum(Algo::Unique(Trigrams));
+
+    Keys.SearchId = SearchEntries.Add(MoveTemp(Entry));
+    for (const uint64 Trigram : Trigrams)
+    {
+        // Ids are mostly handed out in order, so this is usually an append
+        TArray<int32>& Entries = SearchEntriesByTrigram.FindOrAdd(Trigram);
+        Entries.Insert(Keys.SearchId, Algo::LowerBound(Entries, Keys.SearchId));
+    }
+}
+
+void FMCPActorIndex::RemoveSearchEntry(int32 SearchId)
+{
+    const FSearchEntry& Entry = SearchEntries[SearchId];
+    TArray<uint64, TInlineAllocator<64>> Trigrams;
+    AddTrigrams(Entry.Name, Trigrams);
+    AddTrigrams(Entry.Label, Trigrams);
+
+    for (const uint64 Trigram : Trigrams)
+    {
+        TArray<int32>* Entries = SearchEntriesByTrigram.Find(Trigram);
+        const int32 Position = Entries ? Algo::BinarySearch(*Entries, SearchId) : INDEX_NONE;
+        if (Position != INDEX_NONE)
+        {
+            Entries->RemoveAt(Position, 1, EAllowShrinking::No);
+            if (Entries->IsEmpty())
+            {
+                SearchEntriesByTrigram.Remove(Trigram);
+            }
+        }
+    }
+    SearchEntries.RemoveAt(SearchId);
+}
+
+void FMCPActorIndex::OnLevelActorAdded(AActor* Actor)
+{
+    // Actors of other worlds, such as PIE, are not indexed; a stale index is rebuilt anyway
+    if (!bStale && Actor && Actor->GetWorld() == IndexedWorld.Get())
+    {
+        AddActor(Actor);
+        BroadcastChange(EMCPActorChange::Added, Actor);
+    }
+}
+
+void FMCPActorIndex::OnLevelActorDeleted(AActor* Actor)
+{
+    if (!bStale && Actor && KeysByActor.Contains(Actor))
+    {
+        BroadcastChange(EMCPActorChange::Removed, Actor);
+        RemoveActor(Actor);
+    }
+}
+
+void FMCPActorIndex::OnActorLabelChanged(AActor* Actor)
+{
+    // Relabelling can also rename the object, so every key is refreshed
+    if (!bStale && Actor && KeysByActor.Contains(Actor))
+    {
+        AddActor(Actor);
+    }
+    BroadcastChange(EMCPActorChange::Modified, Actor);
+}
+
+void FMCPActorIndex::OnActorMoved(AActor* Actor)
+{
+    UpdateActorBounds(Actor);
+    BroadcastChange(EMCPActorChange::Transformed, Actor);
+}
+
+void FMCPActorIndex::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+    // Edits in the details panel land on the actor or on one of its components
+    AActor* Actor = Cast<AActor>(Object);
+    if (!Actor)
+    {
+        const UActorComponent* Component = Cast<UActorComponent>(Object);
+        Actor = Component ? Component->GetOwner() : nullptr;
+    }
+
+    if (Actor)
+    {
+        UpdateActorBounds(Actor);
+        BroadcastChange(EMCPActorChange::Modified, Actor);
+    }
+}
+
+void FMCPActorIndex::BroadcastChange(EMCPActorChange Change, AActor* Actor)
+{
+    // Moves and edits are reported even while stale, since the rebuild only finds additions and removals
+    if (Actor && IndexedWorld.IsValid() && Actor->GetWorld() == IndexedWorld.Get())
+    {
+        ActorChangedEvent.Broadcast(Change, Actor, Actor->GetFName());
+    }
+}
+
+void FMCPActorIndex::MarkStale()
+{
+    bStale = true;
+}
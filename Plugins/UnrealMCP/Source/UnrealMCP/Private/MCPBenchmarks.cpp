@@ -0,0 +1,557 @@
+#include "MCPClientConnection.h"
+#include "MCPResponseWriter.h"
+#include "MCPCbor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryWriter.h"
+#include "Math/RandomStream.h"
+#include "UnrealMCPBridge.h"
+#include "Editor.h"
+#include "EngineUtils.h"
+#include "Misc/Base64.h"
+
+namespace MCPBenchmarks
+{
+    /** The MCP bridge, the editor world and the actors of its level; logs why and returns false when one is missing */
+    static bool GetBenchmarkActors(const TCHAR* CommandName, UUnrealMCPBridge*& OutBridge, UWorld*& OutWorld, TArray<AActor*>& OutActors)
+    {
+        OutBridge = GEditor ? GEditor->GetEditorSubsystem<UUnrealMCPBridge>() : nullptr;
+        OutWorld = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+        if (!OutBridge || !OutWorld)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: Needs the MCP bridge and an editor world"), CommandName);
+            return false;
+        }
+
+        OutBridge->GetActorIndex().GetAllActors(OutActors);
+        if (OutActors.IsEmpty())
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: The level has no actors"), CommandName);
+            return false;
+        }
+        return true;
+    }
+
+    struct FIngestResult
+    {
+        double MegabytesPerSecond = 0.0;
+        /** Malloc and Realloc calls per request; negative when the allocator does not count them */
+        double AllocationsPerRequest = 0.0;
+    };
+
+    /** The ingest path used before requests were parsed in place: widen to FString, then parse */
+    static bool ParseViaWideString(const TArray<uint8>& Payload)
+    {
+        FString JsonString;
+        FFileHelper::BufferToString(JsonString, Payload.GetData(), Payload.Num());
+
+        TSharedPtr<FJsonObject> JsonObject;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+        return FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid();
+    }
+
+    static bool ParseInPlace(const TArray<uint8>& Payload)
+    {
+        TSharedPtr<FJsonObject> JsonObject;
+        FString Error;
+        return FMCPClientConnection::DeserializeRequest(Payload.GetData(), Payload.Num(), JsonObject, Error);
+    }
+
+    static TArray<uint8> MakePayload(const FString& Json)
+    {
+        FTCHARToUTF8 Converter(*Json);
+        return TArray<uint8>((const uint8*)Converter.Get(), Converter.Length());
+    }
+
+    static FString MakeTransformRequest(int32 Index)
+    {
+        return FString::Printf(
+            TEXT("{\"command\":\"set_actor_transform\",\"params\":{\"name\":\"StaticMeshActor_%d\",\"location\":[%d.5,-40.25,300.0],\"rotation\":[0.0,90.0,0.0],\"scale\":[1.0,1.0,1.0]}}"),
+            Index, Index);
+    }
+
+    static FString MakeLargeRequest(int32 TargetBytes)
+    {
+        FString Json = TEXT("{\"command\":\"batch\",\"params\":{\"commands\":[");
+        for (int32 Index = 0; Json.Len() < TargetBytes; ++Index)
+        {
+            if (Index > 0)
+            {
+                Json += TEXT(",");
+            }
+            Json += MakeTransformRequest(Index);
+        }
+        Json += TEXT("]}}");
+        return Json;
+    }
+
+    static FIngestResult Measure(bool (*Parse)(const TArray<uint8>&), const TArray<uint8>& Payload, int32 Iterations)
+    {
+        FIngestResult Result;
+
+        // Warm up caches and the allocator
+        Parse(Payload);
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Parse(Payload);
+        }
+        const double Elapsed = FPlatformTime::Seconds() - StartTime;
+        Result.MegabytesPerSecond = (double)Payload.Num() * Iterations / (1024.0 * 1024.0) / FMath::Max(Elapsed, 1e-9);
+
+#if STATS
+        // The allocator's own call counters are process-wide, so other threads' allocations land in
+        // them too; that noise only ever adds, so the quietest of a few rounds is the closest count
+        const int32 Rounds = 5;
+        const int32 RoundIterations = FMath::Max(1, Iterations / Rounds);
+        uint64 FewestCalls = MAX_uint64;
+        for (int32 Round = 0; Round < Rounds; ++Round)
+        {
+            const uint64 CallsBefore = (uint64)FMalloc::TotalMallocCalls + (uint64)FMalloc::TotalReallocCalls;
+            for (int32 Iteration = 0; Iteration < RoundIterations; ++Iteration)
+            {
+                Parse(Payload);
+            }
+            const uint64 CallsAfter = (uint64)FMalloc::TotalMallocCalls + (uint64)FMalloc::TotalReallocCalls;
+            FewestCalls = FMath::Min(FewestCalls, CallsAfter - CallsBefore);
+        }
+        Result.AllocationsPerRequest = (double)FewestCalls / RoundIterations;
+#else
+        Result.AllocationsPerRequest = -1.0;
+#endif
+        return Result;
+    }
+
+    static void Report(const TCHAR* Label, const TArray<uint8>& Payload, int32 Iterations)
+    {
+        const FIngestResult Wide = Measure(&ParseViaWideString, Payload, Iterations);
+        const FIngestResult InPlace = Measure(&ParseInPlace, Payload, Iterations);
+
+        UE_LOG(LogTemp, Display, TEXT("UnrealMCP.BenchJsonIngest: %s request (%d bytes, %d iterations)"), Label, Payload.Num(), Iterations);
+        UE_LOG(LogTemp, Display, TEXT("    FString path: %8.1f MB/s, %8.1f allocations/request"), Wide.MegabytesPerSecond, Wide.AllocationsPerRequest);
+        UE_LOG(LogTemp, Display, TEXT("    UTF-8 path:   %8.1f MB/s, %8.1f allocations/request"), InPlace.MegabytesPerSecond, InPlace.AllocationsPerRequest);
+#if !STATS
+        UE_LOG(LogTemp, Display, TEXT("    (allocations are only counted in builds with stats)"));
+#endif
+    }
+
+    static void RunJsonIngestBenchmark(const TArray<FString>& Args)
+    {
+        const int32 Scale = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1;
+
+        Report(TEXT("Small"), MakePayload(MakeTransformRequest(42)), 20000 * Scale);
+        Report(TEXT("1 MB"), MakePayload(MakeLargeRequest(1024 * 1024)), 20 * Scale);
+    }
+
+    static TSharedPtr<FJsonValue> MakeVectorValue(double X, double Y, double Z)
+    {
+        TArray<TSharedPtr<FJsonValue>> Components;
+        Components.Add(MakeShared<FJsonValueNumber>(X));
+        Components.Add(MakeShared<FJsonValueNumber>(Y));
+        Components.Add(MakeShared<FJsonValueNumber>(Z));
+        return MakeShared<FJsonValueArray>(Components);
+    }
+
+    /** A get_actors_in_level response with the same layout as FUnrealMCPCommonUtils::ActorToJson */
+    static TSharedPtr<FJsonObject> MakeActorListing(int32 NumActors)
+    {
+        FRandomStream Random(NumActors);
+        TArray<TSharedPtr<FJsonValue>> Actors;
+        Actors.Reserve(NumActors);
+        for (int32 Index = 0; Index < NumActors; ++Index)
+        {
+            TSharedPtr<FJsonObject> Actor = MakeShared<FJsonObject>();
+            Actor->SetStringField(TEXT("name"), FString::Printf(TEXT("StaticMeshActor_%d"), Index));
+            Actor->SetStringField(TEXT("class"), TEXT("StaticMeshActor"));
+            Actor->SetField(TEXT("location"), MakeVectorValue(Random.FRandRange(-50000.0, 50000.0), Random.FRandRange(-50000.0, 50000.0), Random.FRandRange(0.0, 5000.0)));
+            Actor->SetField(TEXT("rotation"), MakeVectorValue(0.0, Random.FRandRange(-180.0, 180.0), 0.0));
+            Actor->SetField(TEXT("scale"), MakeVectorValue(1.0, 1.0, 1.0));
+            Actors.Add(MakeShared<FJsonValueObject>(Actor));
+        }
+
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetArrayField(TEXT("actors"), Actors);
+
+        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetStringField(TEXT("status"), TEXT("success"));
+        Response->SetObjectField(TEXT("result"), Result);
+        return Response;
+    }
+
+    static double EncodeListing(EMCPPayloadEncoding Encoding, const TSharedPtr<FJsonObject>& Listing, TArray<uint8>& OutBytes, int32 Iterations)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            OutBytes.Reset();
+            FMemoryWriter Archive(OutBytes);
+            TUniquePtr<FMCPResponseWriter> Writer = FMCPResponseWriter::Create(Encoding, Archive);
+            Writer->WriteJsonObject(Listing);
+            Writer->Close();
+        }
+        return (FPlatformTime::Seconds() - StartTime) / Iterations;
+    }
+
+    static double DecodeListing(EMCPPayloadEncoding Encoding, const TArray<uint8>& Bytes, int32 Iterations)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            TSharedPtr<FJsonObject> Object;
+            FString Error;
+            const bool bDecoded = Encoding == EMCPPayloadEncoding::Cbor
+                ? FMCPCborReader::DeserializeObject(Bytes.GetData(), Bytes.Num(), Object, Error)
+                : FMCPClientConnection::DeserializeRequest(Bytes.GetData(), Bytes.Num(), Object, Error);
+            if (!bDecoded)
+            {
+                UE_LOG(LogTemp, Error, TEXT("UnrealMCP.BenchPayloadEncoding: Failed to decode the listing: %s"), *Error);
+                return 0.0;
+            }
+        }
+        return (FPlatformTime::Seconds() - StartTime) / Iterations;
+    }
+
+    static void RunPayloadEncodingBenchmark(const TArray<FString>& Args)
+    {
+        const int32 NumActors = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+        const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10;
+        const TSharedPtr<FJsonObject> Listing = MakeActorListing(NumActors);
+
+        UE_LOG(LogTemp, Display, TEXT("UnrealMCP.BenchPayloadEncoding: %d actors, %d iterations"), NumActors, Iterations);
+        for (EMCPPayloadEncoding Encoding : { EMCPPayloadEncoding::Json, EMCPPayloadEncoding::Cbor })
+        {
+            TArray<uint8> Bytes;
+            const double EncodeSeconds = EncodeListing(Encoding, Listing, Bytes, Iterations);
+            const double DecodeSeconds = DecodeListing(Encoding, Bytes, Iterations);
+            UE_LOG(LogTemp, Display, TEXT("    %s: %10d bytes, encode %7.2f ms, decode %7.2f ms"),
+                Encoding == EMCPPayloadEncoding::Cbor ? TEXT("CBOR") : TEXT("JSON"),
+                Bytes.Num(), EncodeSeconds * 1000.0, DecodeSeconds * 1000.0);
+        }
+    }
+
+    /** The lookup single-actor commands used before the actor index: compare names over the whole level */
+    static AActor* FindActorByScanning(UWorld* World, const FString& Name)
+    {
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            if (It->GetName() == Name)
+            {
+                return *It;
+            }
+        }
+        return nullptr;
+    }
+
+    static void RunActorLookupBenchmark(const TArray<FString>& Args)
+    {
+        const int32 NumLookups = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+
+        UUnrealMCPBridge* Bridge = nullptr;
+        UWorld* World = nullptr;
+        TArray<AActor*> Actors;
+        if (!GetBenchmarkActors(TEXT("UnrealMCP.BenchActorLookup"), Bridge, World, Actors))
+        {
+            return;
+        }
+        FMCPActorIndex& Index = Bridge->GetActorIndex();
+
+        // Look up existing actors picked at random, plus one miss in ten
+        FRandomStream Random(NumLookups);
+        TArray<FString> Names;
+        for (int32 Lookup = 0; Lookup < NumLookups; ++Lookup)
+        {
+            Names.Add(Lookup % 10 == 9 ? FString::Printf(TEXT("MCPBenchMissing_%d"), Lookup) : Actors[Random.RandHelper(Actors.Num())]->GetName());
+        }
+
+        int32 ScanHits = 0;
+        double StartTime = FPlatformTime::Seconds();
+        for (const FString& Name : Names)
+        {
+            ScanHits += FindActorByScanning(World, Name) ? 1 : 0;
+        }
+        const double ScanSeconds = FPlatformTime::Seconds() - StartTime;
+
+        int32 IndexHits = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (const FString& Name : Names)
+        {
+            IndexHits += Index.FindActorByName(Name) ? 1 : 0;
+        }
+        const double IndexSeconds = FPlatformTime::Seconds() - StartTime;
+
+        UE_LOG(LogTemp, Display, TEXT("UnrealMCP.BenchActorLookup: %d lookups in a level of %d actors"), NumLookups, Actors.Num());
+        UE_LOG(LogTemp, Display, TEXT("    scan:  %10.2f us/lookup, %d found"), ScanSeconds * 1e6 / NumLookups, ScanHits);
+        UE_LOG(LogTemp, Display, TEXT("    index: %10.2f us/lookup, %d found"), IndexSeconds * 1e6 / NumLookups, IndexHits);
+    }
+
+    static void RunSpatialQueryBenchmark(const TArray<FString>& Args)
+    {
+        const int32 NumQueries = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+        const double Radius = Args.Num() > 1 ? FCString::Atod(*Args[1]) : 2000.0;
+
+        UUnrealMCPBridge* Bridge = nullptr;
+        UWorld* World = nullptr;
+        TArray<AActor*> Actors;
+        if (!GetBenchmarkActors(TEXT("UnrealMCP.BenchSpatialQuery"), Bridge, World, Actors))
+        {
+            return;
+        }
+        FMCPActorIndex& Index = Bridge->GetActorIndex();
+
+        // Spheres around actors picked at random, so every query lands where the level has content
+        FRandomStream Random(NumQueries);
+        TArray<FVector> Centers;
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            Centers.Add(Actors[Random.RandHelper(Actors.Num())]->GetActorLocation());
+        }
+        const double RadiusSquared = Radius * Radius;
+
+        // What a sphere query costs without the octree: every actor's bounds against the sphere
+        int64 ScanHits = 0;
+        double StartTime = FPlatformTime::Seconds();
+        for (const FVector& Center : Centers)
+        {
+            for (TActorIterator<AActor> It(World); It; ++It)
+            {
+                const FBox Bounds = It->GetComponentsBoundingBox(true);
+                const FVector Location = It->GetActorLocation();
+                const FBox QueryBounds = Bounds.IsValid ? Bounds : FBox(Location, Location);
+                ScanHits += QueryBounds.ComputeSquaredDistanceToPoint(Center) <= RadiusSquared ? 1 : 0;
+            }
+        }
+        const double ScanSeconds = FPlatformTime::Seconds() - StartTime;
+
+        int64 OctreeHits = 0;
+        StartTime = FPlatformTime::Seconds();
+        TArray<FMCPActorBounds> Candidates;
+        for (const FVector& Center : Centers)
+        {
+            Candidates.Reset();
+            Index.FindActorsInBox(FBox(Center - FVector(Radius), Center + FVector(Radius)), Candidates);
+            for (const FMCPActorBounds& Candidate : Candidates)
+            {
+                OctreeHits += Candidate.Bounds.ComputeSquaredDistanceToPoint(Center) <= RadiusSquared ? 1 : 0;
+            }
+        }
+        const double OctreeSeconds = FPlatformTime::Seconds() - StartTime;
+
+        UE_LOG(LogTemp, Display, TEXT("UnrealMCP.BenchSpatialQuery: %d sphere queries of radius %.0f in a level of %d actors"), NumQueries, Radius, Actors.Num());
+        UE_LOG(LogTemp, Display, TEXT("    scan:   %10.2f us/query, %lld hits"), ScanSeconds * 1e6 / NumQueries, ScanHits);
+        UE_LOG(LogTemp, Display, TEXT("    octree: %10.2f us/query, %lld hits"), OctreeSeconds * 1e6 / NumQueries, OctreeHits);
+    }
+
+    static void RunSceneChangesBenchmark(const TArray<FString>& Args)
+    {
+        const int32 NumPolls = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+
+        UUnrealMCPBridge* Bridge = nullptr;
+        UWorld* World = nullptr;
+        TArray<AActor*> Actors;
+        if (!GetBenchmarkActors(TEXT("UnrealMCP.BenchSceneChanges"), Bridge, World, Actors))
+        {
+            return;
+        }
+
+        // Runs inline, since this is the game thread; the full listing is what clients polled before
+        const TSharedPtr<FJsonObject> ListParams = MakeShared<FJsonObject>();
+        double StartTime = FPlatformTime::Seconds();
+        const TSharedPtr<FJsonObject> Listing = Bridge->ExecuteCommandJson(TEXT("get_actors_in_level"), ListParams);
+        const double ListSeconds = FPlatformTime::Seconds() - StartTime;
+
+        const TSharedPtr<FJsonObject>* ListResult = nullptr;
+        double Version = 0.0;
+        if (!Listing.IsValid() || !Listing->TryGetObjectField(TEXT("result"), ListResult) || !(*ListResult)->TryGetNumberField(TEXT("version"), Version))
+        {
+            UE_LOG(LogTemp, Error, TEXT("UnrealMCP.BenchSceneChanges: get_actors_in_level failed"));
+            return;
+        }
+
+        const TSharedPtr<FJsonObject> PollParams = MakeShared<FJsonObject>();
+        PollParams->SetNumberField(TEXT("version"), Version);
+        int32 ChangedPolls = 0;
+        StartTime = FPlatformTime::Seconds();
+        for (int32 Poll = 0; Poll < NumPolls; ++Poll)
+        {
+            const TSharedPtr<FJsonObject> Response = Bridge->ExecuteCommandJson(TEXT("get_scene_changes_since"), PollParams);
+            const TSharedPtr<FJsonObject>* Result = nullptr;
+            if (Response.IsValid() && Response->TryGetObjectField(TEXT("result"), Result) && (*Result)->GetArrayField(TEXT("changes")).Num() > 0)
+            {
+                ++ChangedPolls;
+            }
+        }
+        const double PollSeconds = FPlatformTime::Seconds() - StartTime;
+
+        UE_LOG(LogTemp, Display, TEXT("UnrealMCP.BenchSceneChanges: level of %d actors"), Actors.Num());
+        UE_LOG(LogTemp, Display, TEXT("    get_actors_in_level:     %10.2f us"), ListSeconds * 1e6);
+        UE_LOG(LogTemp, Display, TEXT("    get_scene_changes_since: %10.2f us/poll, %d of %d polls saw changes"), PollSeconds * 1e6 / NumPolls, ChangedPolls, NumPolls);
+    }
+
+    static void RunActorSearchBenchmark(const TArray<FString>& Args)
+    {
+        const int32 NumQueries = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+
+        UUnrealMCPBridge* Bridge = nullptr;
+        UWorld* World = nullptr;
+        TArray<AActor*> Actors;
+        if (!GetBenchmarkActors(TEXT("UnrealMCP.BenchActorSearch"), Bridge, World, Actors))
+        {
+            return;
+        }
+        FMCPActorIndex& Index = Bridge->GetActorIndex();
+
+        // Four characters out of the labels of actors picked at random, as a user would type them
+        FRandomStream Random(NumQueries);
+        TArray<FString> Patterns;
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            const FString Label = Actors[Random.RandHelper(Actors.Num())]->GetActorLabel();
+            Patterns.Add(Label.Mid(Random.RandHelper(FMath::Max(1, Label.Len() - 3)), 4));
+        }
+
+        // What find_actors_by_name did before the index, extended to labels
+        int64 ScanHits = 0;
+        double StartTime = FPlatformTime::Seconds();
+        for (const FString& Pattern : Patterns)
+        {
+            for (TActorIterator<AActor> It(World); It; ++It)
+            {
+                ScanHits += (It->GetName().Contains(Pattern) || It->GetActorLabel().Contains(Pattern)) ? 1 : 0;
+            }
+        }
+        const double ScanSeconds = FPlatformTime::Seconds() - StartTime;
+
+        const EMCPActorSearchMode Modes[] = { EMCPActorSearchMode::Substring, EMCPActorSearchMode::Glob, EMCPActorSearchMode::Fuzzy };
+        const TCHAR* ModeNames[] = { TEXT("substring"), TEXT("glob"), TEXT("fuzzy") };
+
+        UE_LOG(LogTemp, Display, TEXT("UnrealMCP.BenchActorSearch: %d searches in a level of %d actors"), NumQueries, Actors.Num());
+        UE_LOG(LogTemp, Display, TEXT("    scan:            %10.2f us/search, %lld hits"), ScanSeconds * 1e6 / NumQueries, ScanHits);
+        TArray<FMCPActorSearchMatch> Matches;
+        for (int32 ModeIndex = 0; ModeIndex < (int32)UE_ARRAY_COUNT(Modes); ++ModeIndex)
+        {
+            int64 Hits = 0;
+            StartTime = FPlatformTime::Seconds();
+            for (const FString& Pattern : Patterns)
+            {
+                Matches.Reset();
+                Index.SearchActors(Modes[ModeIndex] == EMCPActorSearchMode::Glob ? TEXT("*") + Pattern + TEXT("*") : Pattern, Modes[ModeIndex], ESearchCase::IgnoreCase, Matches);
+                Hits += Matches.Num();
+            }
+            const double IndexSeconds = FPlatformTime::Seconds() - StartTime;
+            UE_LOG(LogTemp, Display, TEXT("    index %-10s %10.2f us/search, %lld hits"), ModeNames[ModeIndex], IndexSeconds * 1e6 / NumQueries, Hits);
+        }
+    }
+
+    /** set_actor_transforms params moving every actor to Locations, packed as set_actor_transforms takes them */
+    static TSharedPtr<FJsonObject> MakeBulkTransformParams(const TArray<AActor*>& Actors, const TArray<FVector>& Locations, bool bDeferNavigation)
+    {
+        TArray<TSharedPtr<FJsonValue>> Names;
+        TArray<float> Values;
+        for (int32 Index = 0; Index < Actors.Num(); ++Index)
+        {
+            Names.Add(MakeShared<FJsonValueString>(Actors[Index]->GetName()));
+            Values.Add(Locations[Index].X);
+            Values.Add(Locations[Index].Y);
+            Values.Add(Locations[Index].Z);
+        }
+
+        const TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+        Params->SetArrayField(TEXT("names"), Names);
+        Params->SetStringField(TEXT("location"), FBase64::Encode(reinterpret_cast<const uint8*>(Values.GetData()), Values.Num() * sizeof(float)));
+        Params->SetBoolField(TEXT("defer_navigation"), bDeferNavigation);
+        return Params;
+    }
+
+    static void RunActorTransformsBenchmark(const TArray<FString>& Args)
+    {
+        const int32 MaxActors = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+
+        UUnrealMCPBridge* Bridge = nullptr;
+        UWorld* World = nullptr;
+        TArray<AActor*> Actors;
+        if (!GetBenchmarkActors(TEXT("UnrealMCP.BenchActorTransforms"), Bridge, World, Actors))
+        {
+            return;
+        }
+        Actors.SetNum(FMath::Min(Actors.Num(), MaxActors));
+
+        // Every pass really moves the actors, one unit along X and back, and they end where they started
+        TArray<FVector> Original;
+        TArray<FVector> Shifted;
+        for (AActor* Actor : Actors)
+        {
+            Original.Add(Actor->GetActorLocation());
+            Shifted.Add(Actor->GetActorLocation() + FVector(1.0, 0.0, 0.0));
+        }
+
+        // Runs inline, since this is the game thread; one command per actor is what clients sent before
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 Index = 0; Index < Actors.Num(); ++Index)
+        {
+            const TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+            Params->SetStringField(TEXT("name"), Actors[Index]->GetName());
+            Params->SetArrayField(TEXT("location"), {
+                MakeShared<FJsonValueNumber>(Shifted[Index].X),
+                MakeShared<FJsonValueNumber>(Shifted[Index].Y),
+                MakeShared<FJsonValueNumber>(Shifted[Index].Z) });
+            Bridge->ExecuteCommandJson(TEXT("set_actor_transform"), Params);
+        }
+        const double SingleSeconds = FPlatformTime::Seconds() - StartTime;
+
+        StartTime = FPlatformTime::Seconds();
+        Bridge->ExecuteCommandJson(TEXT("set_actor_transforms"), MakeBulkTransformParams(Actors, Original, false));
+        const double BulkSeconds = FPlatformTime::Seconds() - StartTime;
+
+        StartTime = FPlatformTime::Seconds();
+        Bridge->ExecuteCommandJson(TEXT("set_actor_transforms"), MakeBulkTransformParams(Actors, Shifted, true));
+        const double DeferredSeconds = FPlatformTime::Seconds() - StartTime;
+
+        Bridge->ExecuteCommandJson(TEXT("set_actor_transforms"), MakeBulkTransformParams(Actors, Original, false));
+
+        UE_LOG(LogTemp, Display, TEXT("UnrealMCP.BenchActorTransforms: moving %d actors"), Actors.Num());
+        UE_LOG(LogTemp, Display, TEXT("    set_actor_transform per actor:    %10.2f ms"), SingleSeconds * 1e3);
+        UE_LOG(LogTemp, Display, TEXT("    set_actor_transforms:             %10.2f ms"), BulkSeconds * 1e3);
+        UE_LOG(LogTemp, Display, TEXT("    set_actor_transforms, deferred nav: %8.2f ms"), DeferredSeconds * 1e3);
+    }
+}
+
+static FAutoConsoleCommand GMCPBenchJsonIngestCommand(
+    TEXT("UnrealMCP.BenchJsonIngest"),
+    TEXT("Compares request parsing throughput and allocations for the FString and in-place UTF-8 paths on small and 1 MB payloads. Usage: UnrealMCP.BenchJsonIngest [IterationScale]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&MCPBenchmarks::RunJsonIngestBenchmark));
+
+static FAutoConsoleCommand GMCPBenchPayloadEncodingCommand(
+    TEXT("UnrealMCP.BenchPayloadEncoding"),
+    TEXT("Compares encoded size and encode/decode time of a get_actors_in_level listing as JSON and as CBOR. Usage: UnrealMCP.BenchPayloadEncoding [NumActors] [Iterations]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&MCPBenchmarks::RunPayloadEncodingBenchmark));
+
+static FAutoConsoleCommand GMCPBenchActorLookupCommand(
+    TEXT("UnrealMCP.BenchActorLookup"),
+    TEXT("Compares finding actors by name through a scan of the level and through the MCP actor index. Usage: UnrealMCP.BenchActorLookup [NumLookups]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&MCPBenchmarks::RunActorLookupBenchmark));
+
+static FAutoConsoleCommand GMCPBenchSpatialQueryCommand(
+    TEXT("UnrealMCP.BenchSpatialQuery"),
+    TEXT("Compares sphere queries answered by testing every actor's bounds and by the MCP actor index's octree. Usage: UnrealMCP.BenchSpatialQuery [NumQueries] [Radius]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&MCPBenchmarks::RunSpatialQueryBenchmark));
+
+static FAutoConsoleCommand GMCPBenchSceneChangesCommand(
+    TEXT("UnrealMCP.BenchSceneChanges"),
+    TEXT("Compares a full get_actors_in_level with polling get_scene_changes_since on an unchanged level. Usage: UnrealMCP.BenchSceneChanges [NumPolls]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&MCPBenchmarks::RunSceneChangesBenchmark));
+
+static FAutoConsoleCommand GMCPBenchActorSearchCommand(
+    TEXT("UnrealMCP.BenchActorSearch"),
+    TEXT("Compares find_actors_by_name searches over names and labels by scanning the level and through the MCP actor index's trigram index. Usage: UnrealMCP.BenchActorSearch [NumQueries]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&MCPBenchmarks::RunActorSearchBenchmark));
+
+static FAutoConsoleCommand GMCPBenchActorTransformsCommand(
+    TEXT("UnrealMCP.BenchActorTransforms"),
+    TEXT("Compares moving actors with one set_actor_transform each and with a single set_actor_transforms, with and without deferred navigation updates. Usage: UnrealMCP.BenchActorTransforms [NumActors]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&MCPBenchmarks::RunActorTransformsBenchmark));
@@ -0,0 +1,508 @@
+#include "MCPCbor.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+// CBOR major types
+const uint8 CborUnsignedInteger = 0;
+const uint8 CborNegativeInteger = 1;
+const uint8 CborByteString = 2;
+const uint8 CborTextString = 3;
+const uint8 CborArray = 4;
+const uint8 CborMap = 5;
+const uint8 CborTag = 6;
+const uint8 CborSimple = 7;
+
+// Additional information values with a fixed meaning
+const uint8 CborFalse = 20;
+const uint8 CborTrue = 21;
+const uint8 CborNull = 22;
+const uint8 CborUndefined = 23;
+const uint8 CborHalfFloat = 25;
+const uint8 CborSingleFloat = 26;
+const uint8 CborDoubleFloat = 27;
+const uint8 CborIndefinite = 31;
+const uint8 CborBreakByte = 0xFF;
+
+// Deepest nesting accepted from a client, so hostile input cannot exhaust the stack
+const int32 MaxCborNestingDepth = 128;
+
+// Integral doubles below this magnitude are encoded exactly as integers
+const double MaxExactCborInteger = 9007199254740992.0;
+
+FMCPCborWriter::FMCPCborWriter(FArchive& InArchive)
+    : Archive(InArchive)
+{
+}
+
+void FMCPCborWriter::WriteHeader(uint8 MajorType, uint64 Argument)
+{
+    uint8 Bytes[9];
+    int32 ArgumentSize = 0;
+    Bytes[0] = MajorType << 5;
+
+    if (Argument < 24)
+    {
+        Bytes[0] |= (uint8)Argument;
+    }
+    else if (Argument <= 0xFF)
+    {
+        Bytes[0] |= 24;
+        ArgumentSize = 1;
+    }
+    else if (Argument <= 0xFFFF)
+    {
+        Bytes[0] |= 25;
+        ArgumentSize = 2;
+    }
+    else if (Argument <= 0xFFFFFFFF)
+    {
+        Bytes[0] |= 26;
+        ArgumentSize = 4;
+    }
+    else
+    {
+        Bytes[0] |= 27;
+        ArgumentSize = 8;
+    }
+
+    // Arguments are big-endian
+    for (int32 Index = 0; Index < ArgumentSize; ++Index)
+    {
+        Bytes[1 + Index] = (uint8)(Argument >> (8 * (ArgumentSize - 1 - Index)));
+    }
+    Archive.Serialize(Bytes, 1 + ArgumentSize);
+}
+
+void FMCPCborWriter::WriteNull()
+{
+    uint8 Byte = (CborSimple << 5) | CborNull;
+    Archive.Serialize(&Byte, 1);
+}
+
+void FMCPCborWriter::WriteBool(bool bValue)
+{
+    uint8 Byte = (CborSimple << 5) | (bValue ? CborTrue : CborFalse);
+    Archive.Serialize(&Byte, 1);
+}
+
+void FMCPCborWriter::WriteNumber(double Value)
+{
+    if (FMath::IsFinite(Value) && FMath::Abs(Value) < MaxExactCborInteger && Value == FMath::FloorToDouble(Value))
+    {
+        const int64 Integer = (int64)Value;
+        if (Integer >= 0)
+        {
+            WriteHeader(CborUnsignedInteger, (uint64)Integer);
+        }
+        else
+        {
+            WriteHeader(CborNegativeInteger, (uint64)(-1 - Integer));
+        }
+        return;
+    }
+
+    const float SingleValue = (float)Value;
+    if ((double)SingleValue == Value || FMath::IsNaN(Value))
+    {
+        // Single precision is enough to represent this value exactly
+        uint32 Bits;
+        FMemory::Memcpy(&Bits, &SingleValue, sizeof(Bits));
+        uint8 Bytes[5] = { (CborSimple << 5) | CborSingleFloat, (uint8)(Bits >> 24), (uint8)(Bits >> 16), (uint8)(Bits >> 8), (uint8)Bits };
+        Archive.Serialize(Bytes, sizeof(Bytes));
+        return;
+    }
+
+    uint64 Bits;
+    FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+    uint8 Bytes[9];
+    Bytes[0] = (CborSimple << 5) | CborDoubleFloat;
+    for (int32 Index = 0; Index < 8; ++Index)
+    {
+        Bytes[1 + Index] = (uint8)(Bits >> (8 * (7 - Index)));
+    }
+    Archive.Serialize(Bytes, sizeof(Bytes));
+}
+
+void FMCPCborWriter::WriteString(FStringView Value)
+{
+    FTCHARToUTF8 Converter(Value.GetData(), Value.Len());
+    WriteHeader(CborTextString, (uint64)Converter.Length());
+    Archive.Serialize((void*)Converter.Get(), Converter.Length());
+}
+
+void FMCPCborWriter::WriteArrayStart(int32 Num)
+{
+    if (Num < 0)
+    {
+        uint8 Byte = (CborArray << 5) | CborIndefinite;
+        Archive.Serialize(&Byte, 1);
+        return;
+    }
+    WriteHeader(CborArray, (uint64)Num);
+}
+
+void FMCPCborWriter::WriteMapStart(int32 Num)
+{
+    if (Num < 0)
+    {
+        uint8 Byte = (CborMap << 5) | CborIndefinite;
+        Archive.Serialize(&Byte, 1);
+        return;
+    }
+    WriteHeader(CborMap, (uint64)Num);
+}
+
+void FMCPCborWriter::WriteBreak()
+{
+    uint8 Byte = CborBreakByte;
+    Archive.Serialize(&Byte, 1);
+}
+
+void FMCPCborWriter::WriteJsonValue(const TSharedPtr<FJsonValue>& Value)
+{
+    if (!Value.IsValid())
+    {
+        WriteNull();
+        return;
+    }
+
+    switch (Value->Type)
+    {
+    case EJson::String:
+        WriteString(Value->AsString());
+        break;
+    case EJson::Number:
+        WriteNumber(Value->AsNumber());
+        break;
+    case EJson::Boolean:
+        WriteBool(Value->AsBool());
+        break;
+    case EJson::Array:
+    {
+        const TArray<TSharedPtr<FJsonValue>>& Items = Value->AsArray();
+        WriteArrayStart(Items.Num());
+        for (const TSharedPtr<FJsonValue>& Item : Items)
+        {
+            WriteJsonValue(Item);
+        }
+        break;
+    }
+    case EJson::Object:
+        WriteJsonObject(Value->AsObject());
+        break;
+    default:
+        WriteNull();
+        break;
+    }
+}
+
+void FMCPCborWriter::WriteJsonObject(const TSharedPtr<FJsonObject>& Object)
+{
+    if (!Object.IsValid())
+    {
+        WriteNull();
+        return;
+    }
+
+    WriteMapStart(Object->Values.Num());
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Values)
+    {
+        WriteString(Field.Key);
+        WriteJsonValue(Field.Value);
+    }
+}
+
+FMCPCborReader::FMCPCborReader(const uint8* InData, int32 InSize)
+    : Data(InData)
+    , Size(InSize)
+    , Offset(0)
+{
+}
+
+bool FMCPCborReader::DeserializeObject(const uint8* Data, int32 Size, TSharedPtr<FJsonObject>& OutObject, FString& OutError)
+{
+    FMCPCborReader Reader(Data, Size);
+    TSharedPtr<FJsonValue> Value = Reader.ReadValue(0);
+    if (!Value.IsValid())
+    {
+        OutError = Reader.Error;
+        return false;
+    }
+    if (Reader.Offset != Size)
+    {
+        OutError = FString::Printf(TEXT("Unexpected data after the CBOR item at offset %d"), Reader.Offset);
+        return false;
+    }
+    if (Value->Type != EJson::Object)
+    {
+        OutError = TEXT("CBOR message must be a map");
+        return false;
+    }
+
+    OutObject = Value->AsObject();
+    return true;
+}
+
+bool FMCPCborReader::Fail(const TCHAR* Message)
+{
+    if (Error.IsEmpty())
+    {
+        Error = FString::Printf(TEXT("%s at offset %d"), Message, Offset);
+    }
+    return false;
+}
+
+bool FMCPCborReader::IsBreak() const
+{
+    return Offset < Size && Data[Offset] == CborBreakByte;
+}
+
+bool FMCPCborReader::ReadHeader(uint8& OutMajorType, uint8& OutAdditional, uint64& OutArgument)
+{
+    if (Offset >= Size)
+    {
+        return Fail(TEXT("Unexpected end of CBOR data"));
+    }
+
+    const uint8 InitialByte = Data[Offset++];
+    OutMajorType = InitialByte >> 5;
+    OutAdditional = InitialByte & 0x1F;
+    OutArgument = 0;
+
+    if (OutAdditional < 24)
+    {
+        OutArgument = OutAdditional;
+        return true;
+    }
+    if (OutAdditional == CborIndefinite)
+    {
+        // Only strings and containers may have an indefinite length; a break is handled by the caller
+        return (OutMajorType >= CborByteString && OutMajorType <= CborMap) ? true : Fail(TEXT("Unexpected CBOR break or indefinite length"));
+    }
+    if (OutAdditional > 27)
+    {
+        return Fail(TEXT("Reserved CBOR additional information"));
+    }
+
+    const int32 ArgumentSize = 1 << (OutAdditional - 24);
+    if (Size - Offset < ArgumentSize)
+    {
+        return Fail(TEXT("Unexpected end of CBOR data"));
+    }
+    for (int32 Index = 0; Index < ArgumentSize; ++Index)
+    {
+        OutArgument = (OutArgument << 8) | Data[Offset++];
+    }
+    return true;
+}
+
+bool FMCPCborReader::ReadText(uint8 Additional, uint64 Length, FString& OutText)
+{
+    if (Additional == CborIndefinite)
+    {
+        // An indefinite string is a sequence of definite text chunks ended by a break
+        while (!IsBreak())
+        {
+            uint8 ChunkMajorType = 0;
+            uint8 ChunkAdditional = 0;
+            uint64 ChunkLength = 0;
+            if (!ReadHeader(ChunkMajorType, ChunkAdditional, ChunkLength))
+            {
+                return false;
+            }
+            if (ChunkMajorType != CborTextString || ChunkAdditional == CborIndefinite)
+            {
+                return Fail(TEXT("Invalid chunk in indefinite CBOR text string"));
+            }
+
+            FString Chunk;
+            if (!ReadText(ChunkAdditional, ChunkLength, Chunk))
+            {
+                return false;
+            }
+            OutText += Chunk;
+        }
+        ++Offset;
+        return true;
+    }
+
+    if (Length > (uint64)(Size - Offset))
+    {
+        return Fail(TEXT("CBOR text string runs past the end of the message"));
+    }
+
+    FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Data + Offset), (int32)Length);
+    OutText = FString(Converter.Length(), Converter.Get());
+    Offset += (int32)Length;
+    return true;
+}
+
+TSharedPtr<FJsonValue> FMCPCborReader::ReadValue(int32 Depth)
+{
+    if (Depth > MaxCborNestingDepth)
+    {
+        Fail(TEXT("CBOR data is nested too deeply"));
+        return nullptr;
+    }
+
+    uint8 MajorType = 0;
+    uint8 Additional = 0;
+    uint64 Argument = 0;
+    if (!ReadHeader(MajorType, Additional, Argument))
+    {
+        return nullptr;
+    }
+
+    switch (MajorType)
+    {
+    case CborUnsignedInteger:
+        return MakeShared<FJsonValueNumber>((double)Argument);
+
+    case CborNegativeInteger:
+        return MakeShared<FJsonValueNumber>(-1.0 - (double)Argument);
+
+    case CborTextString:
+    {
+        FString Text;
+        if (!ReadText(Additional, Argument, Text))
+        {
+            return nullptr;
+        }
+        return MakeShared<FJsonValueString>(MoveTemp(Text));
+    }
+
+    case CborArray:
+    {
+        const bool bIndefinite = Additional == CborIndefinite;
+        // Every item takes at least one byte, which bounds a definite length
+        if (!bIndefinite && Argument > (uint64)(Size - Offset))
+        {
+            Fail(TEXT("CBOR array length runs past the end of the message"));
+            return nullptr;
+        }
+
+        TArray<TSharedPtr<FJsonValue>> Items;
+        Items.Reserve(bIndefinite ? 0 : (int32)Argument);
+        for (uint64 Index = 0; bIndefinite || Index < Argument; ++Index)
+        {
+            if (bIndefinite && IsBreak())
+            {
+                ++Offset;
+                break;
+            }
+
+            TSharedPtr<FJsonValue> Item = ReadValue(Depth + 1);
+            if (!Item.IsValid())
+            {
+                return nullptr;
+            }
+            Items.Add(MoveTemp(Item));
+        }
+        return MakeShared<FJsonValueArray>(Items);
+    }
+
+    case CborMap:
+    {
+        const bool bIndefinite = Additional == CborIndefinite;
+        if (!bIndefinite && Argument > (uint64)(Size - Offset) / 2)
+        {
+            Fail(TEXT("CBOR map length runs past the end of the message"));
+            return nullptr;
+        }
+
+        TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+        for (uint64 Index = 0; bIndefinite || Index < Argument; ++Index)
+        {
+            if (bIndefinite && IsBreak())
+            {
+                ++Offset;
+                break;
+            }
+
+            // Keys must be text, as they are in JSON
+            uint8 KeyMajorType = 0;
+            uint8 KeyAdditional = 0;
+            uint64 KeyLength = 0;
+            FString Key;
+            if (!ReadHeader(KeyMajorType, KeyAdditional, KeyLength))
+            {
+                return nullptr;
+            }
+            if (KeyMajorType != CborTextString)
+            {
+                Fail(TEXT("CBOR map keys must be text strings"));
+                return nullptr;
+            }
+            if (!ReadText(KeyAdditional, KeyLength, Key))
+            {
+                return nullptr;
+            }
+
+            TSharedPtr<FJsonValue> Value = ReadValue(Depth + 1);
+            if (!Value.IsValid())
+            {
+                return nullptr;
+            }
+            Object->SetField(Key, Value);
+        }
+        return MakeShared<FJsonValueObject>(Object);
+    }
+
+    case CborTag:
+        // Tags carry no meaning in the JSON data model; decode the tagged item itself
+        return ReadValue(Depth + 1);
+
+    case CborSimple:
+        switch (Additional)
+        {
+        case CborFalse:
+            return MakeShared<FJsonValueBoolean>(false);
+        case CborTrue:
+            return MakeShared<FJsonValueBoolean>(true);
+        case CborNull:
+        case CborUndefined:
+            return MakeShared<FJsonValueNull>();
+        case CborHalfFloat:
+        {
+            const int32 Exponent = (Argument >> 10) & 0x1F;
+            const int32 Mantissa = Argument & 0x3FF;
+            double Value;
+            if (Exponent == 0)
+            {
+                Value = Mantissa * FMath::Pow(2.0, -24.0);
+            }
+            else if (Exponent != 31)
+            {
+                Value = (Mantissa + 1024) * FMath::Pow(2.0, (double)(Exponent - 25));
+            }
+            else
+            {
+                // JSON has no infinity or NaN, so clamp infinities and drop NaN
+                Value = Mantissa == 0 ? TNumericLimits<double>::Max() : 0.0;
+            }
+            return MakeShared<FJsonValueNumber>((Argument & 0x8000) ? -Value : Value);
+        }
+        case CborSingleFloat:
+        {
+            const uint32 Bits = (uint32)Argument;
+            float Value;
+            FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+            return MakeShared<FJsonValueNumber>(Value);
+        }
+        case CborDoubleFloat:
+        {
+            double Value;
+            FMemory::Memcpy(&Value, &Argument, sizeof(Value));
+            return MakeShared<FJsonValueNumber>(Value);
+        }
+        default:
+            Fail(TEXT("Unsupported CBOR simple value"));
+            return nullptr;
+        }
+
+    default:
+        // Byte strings have no JSON equivalent
+        Fail(TEXT("CBOR byte strings are not supported"));
+        return nullptr;
+    }
+}
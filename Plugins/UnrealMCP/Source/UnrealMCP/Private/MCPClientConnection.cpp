@@ -0,0 +1,1137 @@
+#include "MCPClientConnection.h"
+#include "MCPResponseWriter.h"
+#include "MCPCbor.h"
+#include "UnrealMCPBridge.h"
+#include "MCPEventHub.h"
+#include "MCPTransport.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/Compression.h"
+#include "Misc/ScopeLock.h"
+
+// Frame header: a little-endian uint32 holding the payload length of this frame in the
+// low 30 bits. The top bit marks a continuation: more frames of the same message follow.
+// The next bit marks a compressed frame, only used once 'hello' negotiated compression.
+const uint32 FrameLengthMask = 0x3FFFFFFF;
+const uint32 FrameFlagMore = 0x80000000;
+const uint32 FrameFlagCompressed = 0x40000000;
+
+// A compressed frame starts with the little-endian uncompressed length of its payload
+const int32 CompressedFrameHeaderSize = 4;
+
+// Frames smaller than this are sent uncompressed unless the client asks for another threshold
+const int32 DefaultCompressionThreshold = 4 * 1024;
+const int32 MinCompressionThreshold = 256;
+
+// Largest request accepted, whether sent as one frame or as continuation frames
+const uint32 MaxMessageSize = 256 * 1024 * 1024;
+
+// Frame size used for chunked responses unless the client asks for another one in 'hello'
+const int32 DefaultMaxFrameSize = 64 * 1024;
+const int32 MinNegotiatedFrameSize = 4 * 1024;
+const int32 MaxNegotiatedFrameSize = 4 * 1024 * 1024;
+
+// Scratch buffer used to discard the remainder of an oversized message
+const int32 DiscardBufferSize = 16 * 1024;
+
+// Protocol revision reported by 'hello'
+const int32 MCPProtocolVersion = 5;
+
+// How often an idle session wakes up to check for shutdown and idle expiry
+const float IdlePollIntervalSeconds = 0.5f;
+
+// Client sessions with no traffic for this long are closed by the server
+const float ClientIdleTimeoutSeconds = 300.0f;
+
+// Events queued for a subscriber that is not reading them before further ones are dropped
+const int32 MaxPendingEventsPerSubscription = 1024;
+
+// Pipelined requests a single session may have outstanding before reading pauses
+const int32 MaxPipelinedRequestsPerConnection = 32;
+
+// Response buffers kept for reuse, shared by all sessions
+const int32 MaxPooledResponseBuffers = 16;
+
+// Buffers that grew past this (whole responses under legacy framing) are freed rather than pooled
+const int32 MaxPooledResponseBufferSize = 4 * 1024 * 1024;
+
+/** Free list of response buffers, so steady traffic does not allocate one per response */
+class FMCPResponseBufferPool
+{
+public:
+    static TArray<uint8> Acquire()
+    {
+        FScopeLock Lock(&GetLock());
+        TArray<TArray<uint8>>& FreeBuffers = GetFreeBuffers();
+        return FreeBuffers.Num() > 0 ? FreeBuffers.Pop(EAllowShrinking::No) : TArray<uint8>();
+    }
+
+    static void Release(TArray<uint8>&& Buffer)
+    {
+        if (Buffer.Max() == 0 || Buffer.Max() > MaxPooledResponseBufferSize)
+        {
+            return;
+        }
+
+        Buffer.Reset();
+        FScopeLock Lock(&GetLock());
+        TArray<TArray<uint8>>& FreeBuffers = GetFreeBuffers();
+        if (FreeBuffers.Num() < MaxPooledResponseBuffers)
+        {
+            FreeBuffers.Add(MoveTemp(Buffer));
+        }
+    }
+
+private:
+    static FCriticalSection& GetLock()
+    {
+        static FCriticalSection Lock;
+        return Lock;
+    }
+
+    static TArray<TArray<uint8>>& GetFreeBuffers()
+    {
+        static TArray<TArray<uint8>> FreeBuffers;
+        return FreeBuffers;
+    }
+};
+
+/**
+ * Archive that a JSON writer serializes a response into.
+ * Bytes collect in a pooled buffer; with chunked framing every full buffer goes
+ * out as a continuation frame, so a response of any size needs one frame of
+ * memory. Legacy framing has to know the length up front and buffers the whole
+ * message. SendLock is only taken once the first frame is flushed, so responses
+ * that fit in one frame never hold it while being serialized.
+ */
+class FMCPResponseStream : public FArchive
+{
+public:
+    explicit FMCPResponseStream(FMCPClientConnection& InConnection)
+        : Connection(InConnection)
+        , Buffer(FMCPResponseBufferPool::Acquire())
+        , bHoldsSendLock(false)
+        , bFlushedFrames(false)
+        , bSendFailed(false)
+    {
+        SetIsSaving(true);
+
+        FScopeLock Lock(&Connection.SendLock);
+        bChunked = Connection.bChunkedResponses;
+        FrameSize = Connection.MaxFrameSize;
+        Encoding = Connection.PayloadEncoding;
+        if (bChunked)
+        {
+            Buffer.Reserve(FrameSize);
+        }
+    }
+
+    virtual ~FMCPResponseStream()
+    {
+        if (bHoldsSendLock)
+        {
+            Connection.SendLock.Unlock();
+        }
+        FMCPResponseBufferPool::Release(MoveTemp(Buffer));
+    }
+
+    virtual void Serialize(void* Data, int64 Length) override
+    {
+        const uint8* Bytes = static_cast<const uint8*>(Data);
+        while (Length > 0)
+        {
+            // Only flush once more bytes arrive, so the final frame is never empty
+            if (bChunked && Buffer.Num() >= FrameSize)
+            {
+                FlushFrame();
+            }
+
+            const int64 StepSize = bChunked ? FMath::Min<int64>(Length, FrameSize - Buffer.Num()) : Length;
+            Buffer.Append(Bytes, StepSize);
+            Bytes += StepSize;
+            Length -= StepSize;
+        }
+    }
+
+    virtual FString GetArchiveName() const override
+    {
+        return TEXT("FMCPResponseStream");
+    }
+
+    /** Encoding the response must be written in, fixed when the stream was opened */
+    EMCPPayloadEncoding GetEncoding() const
+    {
+        return Encoding;
+    }
+
+    /** Sends whatever is still buffered as the last frame of the message */
+    bool Finish()
+    {
+        LockForSending();
+        if (!bSendFailed)
+        {
+            // Anything that was never split is sent with the session's normal framing
+            bSendFailed = bFlushedFrames
+                ? !Connection.SendPayloadFrame(Buffer.GetData(), Buffer.Num(), 0)
+                : !Connection.SendMessage(Buffer.GetData(), Buffer.Num());
+        }
+        Buffer.Reset();
+        return !bSendFailed;
+    }
+
+private:
+    void LockForSending()
+    {
+        if (!bHoldsSendLock)
+        {
+            Connection.SendLock.Lock();
+            bHoldsSendLock = true;
+        }
+    }
+
+    void FlushFrame()
+    {
+        // Frames of this message must not interleave with other responses from here on
+        LockForSending();
+        if (!bSendFailed && !Connection.SendPayloadFrame(Buffer.GetData(), Buffer.Num(), FrameFlagMore))
+        {
+            // Keep consuming the writer's output so it can finish, but stop sending
+            bSendFailed = true;
+            SetError();
+        }
+        bFlushedFrames = true;
+        Buffer.Reset();
+    }
+
+    FMCPClientConnection& Connection;
+    TArray<uint8> Buffer;
+    bool bChunked;
+    int32 FrameSize;
+    EMCPPayloadEncoding Encoding;
+    bool bHoldsSendLock;
+    bool bFlushedFrames;
+    bool bSendFailed;
+};
+
+/**
+ * One pipelined request executing on the shared request pool.
+ * Keeps the connection alive until its response has been sent.
+ */
+class FMCPPipelinedRequestWork : public IQueuedWork
+{
+public:
+    FMCPPipelinedRequestWork(TSharedRef<FMCPClientConnection> InConnection, const FString& InCommandType, const TSharedPtr<FJsonObject>& InParams, const TSharedPtr<FJsonValue>& InRequestId)
+        : Connection(InConnection)
+        , CommandType(InCommandType)
+        , Params(InParams)
+        , RequestId(InRequestId)
+    {
+    }
+
+    virtual void DoThreadedWork() override
+    {
+        Connection->ExecuteRequest(CommandType, Params, RequestId);
+        Connection->OnPipelinedRequestFinished();
+        delete this;
+    }
+
+    virtual void Abandon() override
+    {
+        Connection->OnPipelinedRequestFinished();
+        delete this;
+    }
+
+private:
+    TSharedRef<FMCPClientConnection> Connection;
+    FString CommandType;
+    TSharedPtr<FJsonObject> Params;
+    TSharedPtr<FJsonValue> RequestId;
+};
+
+FMCPClientConnection::FMCPClientConnection(UUnrealMCPBridge* InBridge, TSharedPtr<FMCPTransport> InTransport, int32 InConnectionId, FQueuedThreadPool* InRequestPool, FQueuedThreadPool* InInteractivePool)
+    : Bridge(InBridge)
+    , Transport(InTransport)
+    , ConnectionId(InConnectionId)
+    , RequestPool(InRequestPool)
+    , InteractivePool(InInteractivePool)
+    , bRunning(true)
+    , bFinished(false)
+    , bChunkedResponses(false)
+    , MaxFrameSize(DefaultMaxFrameSize)
+    , PayloadEncoding(EMCPPayloadEncoding::Json)
+    , CompressionFormat(NAME_None)
+    , CompressionThreshold(DefaultCompressionThreshold)
+    , EventSender(nullptr)
+    , EventSenderThread(nullptr)
+{
+    PipelinedRequestFinishedEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FMCPClientConnection::~FMCPClientConnection()
+{
+    FPlatformProcess::ReturnSynchEventToPool(PipelinedRequestFinishedEvent);
+    PipelinedRequestFinishedEvent = nullptr;
+}
+
+bool FMCPClientConnection::Init()
+{
+    return true;
+}
+
+uint32 FMCPClientConnection::Run()
+{
+    // Serve the client session until it closes or goes idle
+    HandleClientConnection();
+
+    // Let pipelined requests that are still executing finish before the socket goes away
+    WaitForPipelinedRequests(1);
+
+    // Connection handled, close it
+    Transport->Close();
+    UE_LOG(LogTemp, Display, TEXT("MCPClientConnection: Client session %d closed"), ConnectionId);
+
+    bFinished = true;
+    return 0;
+}
+
+void FMCPClientConnection::Stop()
+{
+    bRunning = false;
+    if (Transport.IsValid())
+    {
+        // Wake the worker if it is blocked reading from the client
+        Transport->Shutdown(ESocketShutdownMode::ReadWrite);
+    }
+}
+
+void FMCPClientConnection::Exit()
+{
+}
+
+void FMCPClientConnection::RejectClient(const TSharedPtr<FMCPTransport>& Client, const FString& ErrorMessage)
+{
+    FString ResultString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultString);
+    FJsonSerializer::Serialize(CreateErrorResponse(ErrorMessage).ToSharedRef(), Writer);
+
+    FTCHARToUTF8 Converter(*ResultString);
+    SendFrame(Client, (const uint8*)Converter.Get(), Converter.Length(), 0);
+    Client->Shutdown(ESocketShutdownMode::ReadWrite);
+    Client->Close();
+}
+
+void FMCPClientConnection::HandleClientConnection()
+{
+    if (!Transport.IsValid() || !Transport->IsConnected())
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPClientConnection: Invalid or disconnected transport passed to connection %d"), ConnectionId);
+        return;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("MCPClientConnection: Starting client session %d"), ConnectionId);
+
+    // Keep the session open and serve framed requests until the client closes its side,
+    // the connection breaks, the session goes idle or the server is stopped
+    double LastActivityTime = FPlatformTime::Seconds();
+    int32 MessagesHandled = 0;
+
+    while (bRunning)
+    {
+        const bool bReadable = Transport->WaitForRead(FTimespan::FromSeconds(IdlePollIntervalSeconds));
+        if (!bReadable)
+        {
+            if (!Transport->IsConnected())
+            {
+                UE_LOG(LogTemp, Display, TEXT("MCPClientConnection: Client session %d lost its connection"), ConnectionId);
+                break;
+            }
+
+            // A subscriber may legitimately sit waiting for events
+            if (!EventSubscription.IsValid() && FPlatformTime::Seconds() - LastActivityTime > ClientIdleTimeoutSeconds)
+            {
+                UE_LOG(LogTemp, Display, TEXT("MCPClientConnection: Closing client session after %.0f seconds of inactivity"), ClientIdleTimeoutSeconds);
+                break;
+            }
+            continue;
+        }
+
+        // Read one message, which may span several continuation frames
+        TArray<uint8> MessagePayload;
+        const EMCPReceiveResult MessageResult = ReceiveMessage(MessagePayload);
+        if (MessageResult == EMCPReceiveResult::Closed)
+        {
+            // The client half-closed its side; answer everything it sent before closing ours
+            UE_LOG(LogTemp, Display, TEXT("MCPClientConnection: Client closed session %d after %d message(s)"), ConnectionId, MessagesHandled);
+            WaitForPipelinedRequests(1);
+            Transport->Shutdown(ESocketShutdownMode::Write);
+            break;
+        }
+        if (MessageResult == EMCPReceiveResult::TooLarge)
+        {
+            // The oversized message was drained, so the stream is still in sync
+            SendResponseObject(CreateErrorResponse(FString::Printf(TEXT("Message exceeds the maximum size of %u bytes"), MaxMessageSize)));
+            LastActivityTime = FPlatformTime::Seconds();
+            continue;
+        }
+        if (MessageResult != EMCPReceiveResult::Success)
+        {
+            // The stream cannot be resynchronised after a bad frame, so the session is dropped
+            UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Failed to read a message on session %d"), ConnectionId);
+            if (MessageResult == EMCPReceiveResult::BadFrame)
+            {
+                SendResponseObject(CreateErrorResponse(TEXT("Invalid frame header")));
+            }
+            break;
+        }
+
+        // Only this thread changes the encoding, in 'hello', so it can be read without the lock
+        TSharedPtr<FJsonObject> JsonObject;
+        FString ParseError;
+        const bool bParsed = PayloadEncoding == EMCPPayloadEncoding::Cbor
+            ? FMCPCborReader::DeserializeObject(MessagePayload.GetData(), MessagePayload.Num(), JsonObject, ParseError)
+            : DeserializeRequest(MessagePayload.GetData(), MessagePayload.Num(), JsonObject, ParseError);
+        if (bParsed)
+        {
+            // The raw bytes are no longer needed while the command runs
+            MessagePayload.Empty();
+            ProcessMessage(JsonObject);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Failed to parse message. Error: %s"), *ParseError);
+            SendResponseObject(CreateErrorResponse(FString::Printf(TEXT("Failed to parse message: %s"), *ParseError)));
+        }
+
+        ++MessagesHandled;
+        LastActivityTime = FPlatformTime::Seconds();
+    }
+
+    if (EventSubscription.IsValid())
+    {
+        Bridge->GetEventHub().RemoveSubscription(EventSubscription.ToSharedRef());
+        StopEventDelivery();
+        EventSubscription.Reset();
+    }
+}
+
+bool FMCPClientConnection::DeserializeRequest(const uint8* Data, int32 Size, TSharedPtr<FJsonObject>& OutObject, FString& OutError)
+{
+    // Skip a UTF-8 byte order mark if the client sent one
+    if (Size >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+    {
+        Data += 3;
+        Size -= 3;
+    }
+
+    // Parse the received UTF-8 bytes in place rather than widening them into an FString first
+    const FUtf8StringView JsonView(reinterpret_cast<const UTF8CHAR*>(Data), Size);
+    TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(JsonView);
+
+    if (FJsonSerializer::Deserialize(Reader, OutObject) && OutObject.IsValid())
+    {
+        return true;
+    }
+
+    OutError = Reader->GetErrorMessage();
+    return false;
+}
+
+FMCPClientConnection::EMCPReceiveResult FMCPClientConnection::ReceiveMessage(TArray<uint8>& OutMessage)
+{
+    OutMessage.Reset();
+
+    bool bMoreFrames = true;
+    bool bFirstFrame = true;
+    bool bTooLarge = false;
+    while (bMoreFrames)
+    {
+        uint8 HeaderBytes[4];
+        const EMCPReceiveResult HeaderResult = ReceiveExactly(Transport, HeaderBytes, sizeof(HeaderBytes));
+        if (HeaderResult != EMCPReceiveResult::Success)
+        {
+            return (bFirstFrame && HeaderResult == EMCPReceiveResult::Closed) ? EMCPReceiveResult::Closed : EMCPReceiveResult::Error;
+        }
+
+        // Convert from little-endian bytes to uint32
+        const uint32 Header = HeaderBytes[0] | (HeaderBytes[1] << 8) | (HeaderBytes[2] << 16) | (HeaderBytes[3] << 24);
+        const uint32 FrameLength = Header & FrameLengthMask;
+        const bool bCompressed = (Header & FrameFlagCompressed) != 0;
+        bMoreFrames = (Header & FrameFlagMore) != 0;
+
+        UE_LOG(LogTemp, Verbose, TEXT("MCPClientConnection: Received %sframe of %u bytes%s"), bCompressed ? TEXT("compressed ") : TEXT(""), FrameLength, bMoreFrames ? TEXT(" (more follow)") : TEXT(""));
+
+        // Only the reading thread changes the compression format, in 'hello'
+        if ((bCompressed && (CompressionFormat.IsNone() || FrameLength < (uint32)CompressedFrameHeaderSize)) || (bFirstFrame && !bMoreFrames && FrameLength == 0))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Invalid frame header: 0x%08x"), Header);
+            return EMCPReceiveResult::BadFrame;
+        }
+        bFirstFrame = false;
+
+        if (!bTooLarge && (uint64)OutMessage.Num() + FrameLength > MaxMessageSize)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Message on session %d exceeds %u bytes, discarding it"), ConnectionId, MaxMessageSize);
+            bTooLarge = true;
+            OutMessage.Empty();
+        }
+
+        if (bTooLarge)
+        {
+            // Keep reading so the next message starts on a frame boundary, in bounded steps
+            uint8 DiscardBuffer[DiscardBufferSize];
+            uint32 Remaining = FrameLength;
+            while (Remaining > 0)
+            {
+                const int32 StepSize = (int32)FMath::Min<uint32>(Remaining, DiscardBufferSize);
+                if (ReceiveExactly(Transport, DiscardBuffer, StepSize) != EMCPReceiveResult::Success)
+                {
+                    return EMCPReceiveResult::Error;
+                }
+                Remaining -= StepSize;
+            }
+            continue;
+        }
+
+        if (bCompressed)
+        {
+            TArray<uint8> CompressedFrame;
+            CompressedFrame.SetNumUninitialized(FrameLength);
+            if (ReceiveExactly(Transport, CompressedFrame.GetData(), FrameLength) != EMCPReceiveResult::Success)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Failed to read compressed frame of %u bytes."), FrameLength);
+                return EMCPReceiveResult::Error;
+            }
+
+            const uint32 UncompressedLength = CompressedFrame[0] | (CompressedFrame[1] << 8) | (CompressedFrame[2] << 16) | (CompressedFrame[3] << 24);
+            if ((uint64)OutMessage.Num() + UncompressedLength > MaxMessageSize)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Message on session %d exceeds %u bytes, discarding it"), ConnectionId, MaxMessageSize);
+                bTooLarge = true;
+                OutMessage.Empty();
+                continue;
+            }
+
+            // Inflate straight into its place in the message
+            const int32 Offset = OutMessage.Num();
+            OutMessage.AddUninitialized(UncompressedLength);
+            if (!FCompression::UncompressMemory(CompressionFormat, OutMessage.GetData() + Offset, UncompressedLength,
+                CompressedFrame.GetData() + CompressedFrameHeaderSize, FrameLength - CompressedFrameHeaderSize))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Failed to decompress a frame of %u bytes on session %d"), FrameLength, ConnectionId);
+                return EMCPReceiveResult::BadFrame;
+            }
+            continue;
+        }
+
+        // Read the frame straight into its place in the message
+        const int32 Offset = OutMessage.Num();
+        OutMessage.AddUninitialized(FrameLength);
+        if (FrameLength > 0 && ReceiveExactly(Transport, OutMessage.GetData() + Offset, FrameLength) != EMCPReceiveResult::Success)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: Failed to read frame payload of %u bytes."), FrameLength);
+            return EMCPReceiveResult::Error;
+        }
+    }
+
+    return bTooLarge ? EMCPReceiveResult::TooLarge : EMCPReceiveResult::Success;
+}
+
+FMCPClientConnection::EMCPReceiveResult FMCPClientConnection::ReceiveExactly(const TSharedPtr<FMCPTransport>& Client, uint8* Data, int32 Size)
+{
+    int32 TotalRead = 0;
+    while (TotalRead < Size)
+    {
+        int32 BytesRead = 0;
+        if (!Client->Recv(Data + TotalRead, Size - TotalRead, BytesRead))
+        {
+            // A graceful close between messages reports zero bytes; in the middle of one it is an error
+            return (BytesRead == 0 && TotalRead == 0) ? EMCPReceiveResult::Closed : EMCPReceiveResult::Error;
+        }
+        if (BytesRead <= 0)
+        {
+            return TotalRead == 0 ? EMCPReceiveResult::Closed : EMCPReceiveResult::Error;
+        }
+        TotalRead += BytesRead;
+    }
+    return EMCPReceiveResult::Success;
+}
+
+TSharedPtr<FJsonObject> FMCPClientConnection::CreateErrorResponse(const FString& ErrorMessage, const TSharedPtr<FJsonValue>& RequestId)
+{
+    TSharedPtr<FJsonObject> ResponseJson = MakeShareable(new FJsonObject);
+    if (RequestId.IsValid())
+    {
+        ResponseJson->SetField(TEXT("id"), RequestId);
+    }
+    ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
+    ResponseJson->SetStringField(TEXT("error"), ErrorMessage);
+    return ResponseJson;
+}
+
+void FMCPClientConnection::ProcessMessage(const TSharedPtr<FJsonObject>& JsonObject)
+{
+    if (!JsonObject.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: ProcessMessage received an invalid JSON object."));
+        SendResponseObject(CreateErrorResponse(TEXT("Invalid JSON message")));
+        return;
+    }
+
+    // Optional correlation id, echoed back verbatim so clients may use numbers or strings
+    TSharedPtr<FJsonValue> RequestId = JsonObject->TryGetField(TEXT("id"));
+    if (RequestId.IsValid() && RequestId->Type == EJson::Null)
+    {
+        RequestId.Reset();
+    }
+
+    FString CommandType;
+    if (!JsonObject->TryGetStringField(TEXT("command"), CommandType))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MCPClientConnection: JSON message does not contain a 'command' field."));
+        SendResponseObject(CreateErrorResponse(TEXT("Message does not contain a 'command' field"), RequestId));
+        return;
+    }
+
+    const TSharedPtr<FJsonObject>* ParamsPtr = nullptr;
+    TSharedPtr<FJsonObject> Params = JsonObject->TryGetObjectField(TEXT("params"), ParamsPtr) ? *ParamsPtr : MakeShared<FJsonObject>();
+
+    // Session negotiation changes how later frames are written, so it is never pipelined
+    if (CommandType == TEXT("hello"))
+    {
+        HandleHello(Params, RequestId);
+        return;
+    }
+    if (CommandType == TEXT("subscribe") || CommandType == TEXT("unsubscribe"))
+    {
+        HandleSubscription(Params, RequestId, CommandType == TEXT("subscribe"));
+        return;
+    }
+
+    if (!RequestId.IsValid() || !RequestPool)
+    {
+        // Untagged requests keep the original strictly sequential behaviour
+        ExecuteRequest(CommandType, Params, RequestId);
+        return;
+    }
+
+    // Unknown commands fail at once, so they are treated like control requests
+    const FMCPCommandInfo* Command = Bridge->GetCommandRegistry().Find(CommandType);
+    const EMCPCommandPriority Priority = Command ? Command->PriorityClass : EMCPCommandPriority::Control;
+    if (Priority == EMCPCommandPriority::Control && (!Command || !Command->bGameThread))
+    {
+        // Answered right here, ahead of whatever this session has queued on the pools
+        ExecuteRequest(CommandType, Params, RequestId);
+        return;
+    }
+
+    // Apply backpressure instead of queueing without bound. Reads get headroom above the
+    // limit, so a session saturated with mutations can still query.
+    const bool bInteractive = Priority <= EMCPCommandPriority::Interactive && InteractivePool;
+    WaitForPipelinedRequests(bInteractive ? MaxPipelinedRequestsPerConnection * 2 : MaxPipelinedRequestsPerConnection);
+    if (!bRunning)
+    {
+        return;
+    }
+
+    PipelinedRequests.Increment();
+    FMCPPipelinedRequestWork* Work = new FMCPPipelinedRequestWork(AsShared(), CommandType, Params, RequestId);
+    if (bInteractive)
+    {
+        InteractivePool->AddQueuedWork(Work);
+    }
+    else
+    {
+        // Idle workers take queued mutations before queued bulk work
+        RequestPool->AddQueuedWork(Work, Priority == EMCPCommandPriority::Bulk ? EQueuedWorkPriority::Low : EQueuedWorkPriority::Normal);
+    }
+}
+
+void FMCPClientConnection::ExecuteRequest(const FString& CommandType, const TSharedPtr<FJsonObject>& Params, const TSharedPtr<FJsonValue>& RequestId)
+{
+    // Execute the command, on the game thread where required
+    TSharedPtr<FJsonObject> ResponseJson;
+    if (Bridge->SupportsStreamedResult(CommandType))
+    {
+        // Large results are written straight to the socket instead of being built as a DOM
+        FMCPResultWriter ResultWriter;
+        ResponseJson = Bridge->ExecuteCommandStreamed(CommandType, Params, ResultWriter);
+        if (!ResponseJson.IsValid())
+        {
+            SendStreamedResponse(ResultWriter, RequestId);
+            return;
+        }
+    }
+    else
+    {
+        ResponseJson = Bridge->ExecuteCommandJson(CommandType, Params);
+    }
+    if (RequestId.IsValid())
+    {
+        ResponseJson->SetField(TEXT("id"), RequestId);
+    }
+
+    // Send the response back to the client
+    SendResponseObject(ResponseJson);
+}
+
+void FMCPClientConnection::OnPipelinedRequestFinished()
+{
+    PipelinedRequests.Decrement();
+    PipelinedRequestFinishedEvent->Trigger();
+}
+
+void FMCPClientConnection::WaitForPipelinedRequests(int32 Limit)
+{
+    while (PipelinedRequests.GetValue() >= Limit)
+    {
+        // Wake periodically in case the pool abandoned work while shutting down
+        PipelinedRequestFinishedEvent->Wait(FTimespan::FromMilliseconds(100));
+    }
+}
+
+/** Maps a compression name used in 'hello' to a format available in this build */
+static FName FindCompressionFormat(const FString& Name)
+{
+    FName Format = NAME_None;
+    if (Name == TEXT("zlib"))
+    {
+        Format = NAME_Zlib;
+    }
+    else if (Name == TEXT("lz4"))
+    {
+        Format = NAME_LZ4;
+    }
+    else if (Name == TEXT("oodle"))
+    {
+        Format = NAME_Oodle;
+    }
+    return (!Format.IsNone() && FCompression::IsFormatValid(Format)) ? Format : NAME_None;
+}
+
+void FMCPClientConnection::HandleHello(const TSharedPtr<FJsonObject>& Params, const TSharedPtr<FJsonValue>& RequestId)
+{
+    EMCPPayloadEncoding NegotiatedEncoding = PayloadEncoding;
+    FString RequestedEncoding;
+    if (Params->TryGetStringField(TEXT("encoding"), RequestedEncoding))
+    {
+        if (RequestedEncoding == TEXT("cbor"))
+        {
+            NegotiatedEncoding = EMCPPayloadEncoding::Cbor;
+        }
+        else if (RequestedEncoding == TEXT("json"))
+        {
+            NegotiatedEncoding = EMCPPayloadEncoding::Json;
+        }
+    }
+
+    // Compression is given as one format or a list in order of preference
+    FName NegotiatedCompression = CompressionFormat;
+    TArray<FString> RequestedCompression;
+    const TArray<TSharedPtr<FJsonValue>>* RequestedCompressionList = nullptr;
+    FString RequestedCompressionName;
+    if (Params->TryGetArrayField(TEXT("compression"), RequestedCompressionList))
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *RequestedCompressionList)
+        {
+            RequestedCompression.Add(Value->AsString());
+        }
+    }
+    else if (Params->TryGetStringField(TEXT("compression"), RequestedCompressionName))
+    {
+        RequestedCompression.Add(RequestedCompressionName);
+    }
+    if (Params->HasField(TEXT("compression")))
+    {
+        NegotiatedCompression = NAME_None;
+        for (const FString& Name : RequestedCompression)
+        {
+            NegotiatedCompression = FindCompressionFormat(Name);
+            if (!NegotiatedCompression.IsNone())
+            {
+                break;
+            }
+        }
+    }
+
+    int32 NegotiatedThreshold = CompressionThreshold;
+    int32 RequestedThreshold = 0;
+    if (Params->TryGetNumberField(TEXT("compression_threshold"), RequestedThreshold))
+    {
+        NegotiatedThreshold = FMath::Clamp<int32>(RequestedThreshold, MinCompressionThreshold, MaxMessageSize);
+    }
+
+    {
+        FScopeLock Lock(&SendLock);
+
+        bool bRequestChunkedFrames = false;
+        if (Params->TryGetBoolField(TEXT("chunked_frames"), bRequestChunkedFrames))
+        {
+            bChunkedResponses = bRequestChunkedFrames;
+        }
+
+        int32 RequestedFrameSize = 0;
+        if (Params->TryGetNumberField(TEXT("max_frame_size"), RequestedFrameSize))
+        {
+            MaxFrameSize = FMath::Clamp(RequestedFrameSize, MinNegotiatedFrameSize, MaxNegotiatedFrameSize);
+        }
+    }
+
+    TSharedPtr<FJsonObject> ResultJson = MakeShared<FJsonObject>();
+    ResultJson->SetNumberField(TEXT("protocol_version"), MCPProtocolVersion);
+    ResultJson->SetNumberField(TEXT("connection_id"), ConnectionId);
+    ResultJson->SetBoolField(TEXT("chunked_frames"), bChunkedResponses);
+    ResultJson->SetNumberField(TEXT("max_frame_size"), MaxFrameSize);
+    ResultJson->SetNumberField(TEXT("max_message_size"), MaxMessageSize);
+    ResultJson->SetBoolField(TEXT("pipelining"), RequestPool != nullptr);
+    ResultJson->SetNumberField(TEXT("max_pipelined_requests"), MaxPipelinedRequestsPerConnection);
+    ResultJson->SetStringField(TEXT("encoding"), NegotiatedEncoding == EMCPPayloadEncoding::Cbor ? TEXT("cbor") : TEXT("json"));
+    ResultJson->SetStringField(TEXT("compression"), NegotiatedCompression.IsNone() ? TEXT("none") : NegotiatedCompression.ToString().ToLower());
+    ResultJson->SetNumberField(TEXT("compression_threshold"), NegotiatedThreshold);
+
+    TArray<TSharedPtr<FJsonValue>> SupportedCompression;
+    for (const TCHAR* Name : { TEXT("zlib"), TEXT("lz4"), TEXT("oodle") })
+    {
+        if (!FindCompressionFormat(Name).IsNone())
+        {
+            SupportedCompression.Add(MakeShared<FJsonValueString>(Name));
+        }
+    }
+    ResultJson->SetArrayField(TEXT("compression_formats"), SupportedCompression);
+
+    TSharedPtr<FJsonObject> ResponseJson = MakeShared<FJsonObject>();
+    if (RequestId.IsValid())
+    {
+        ResponseJson->SetField(TEXT("id"), RequestId);
+    }
+    ResponseJson->SetStringField(TEXT("status"), TEXT("success"));
+    ResponseJson->SetObjectField(TEXT("result"), ResultJson);
+    SendResponseObject(ResponseJson);
+
+    // The reply still uses the old encoding and compression so the client can read it;
+    // everything after uses the new ones
+    FScopeLock Lock(&SendLock);
+    PayloadEncoding = NegotiatedEncoding;
+    CompressionFormat = NegotiatedCompression;
+    CompressionThreshold = NegotiatedThreshold;
+}
+
+bool FMCPClientConnection::SendResponseObject(const TSharedPtr<FJsonObject>& ResponseJson)
+{
+    // Encode straight into the outgoing frames
+    FMCPResponseStream Stream(*this);
+    TUniquePtr<FMCPResponseWriter> Writer = FMCPResponseWriter::Create(Stream.GetEncoding(), Stream);
+    Writer->WriteJsonObject(ResponseJson);
+    Writer->Close();
+    return Stream.Finish();
+}
+
+bool FMCPClientConnection::SendStreamedResponse(const FMCPResultWriter& ResultWriter, const TSharedPtr<FJsonValue>& RequestId)
+{
+    FMCPResponseStream Stream(*this);
+    TUniquePtr<FMCPResponseWriter> Writer = FMCPResponseWriter::Create(Stream.GetEncoding(), Stream);
+
+    // Same envelope as a successful ExecuteCommandJson response
+    Writer->WriteObjectStart();
+    if (RequestId.IsValid())
+    {
+        Writer->WriteJsonValue(TEXT("id"), RequestId);
+    }
+    Writer->WriteString(TEXT("status"), TEXT("success"));
+    Writer->WriteObjectStart(TEXT("result"));
+    ResultWriter(*Writer);
+    Writer->WriteObjectEnd();
+    Writer->WriteObjectEnd();
+    Writer->Close();
+
+    return Stream.Finish();
+}
+
+bool FMCPClientConnection::SendMessage(const uint8* Data, int64 Length)
+{
+    if (!bChunkedResponses)
+    {
+        // Legacy framing: the whole message in one frame
+        if (Length > FrameLengthMask)
+        {
+            UE_LOG(LogTemp, Error, TEXT("MCPClientConnection: Response of %lld bytes needs chunked frames, which session %d did not negotiate"), Length, ConnectionId);
+            const FString ErrorString = TEXT("{\"status\":\"error\",\"error\":\"Response too large; negotiate chunked_frames with 'hello'\"}");
+            FTCHARToUTF8 ErrorConverter(*ErrorString);
+            return SendFrame(Transport, (const uint8*)ErrorConverter.Get(), ErrorConverter.Length(), 0);
+        }
+        return SendPayloadFrame(Data, (uint32)Length, 0);
+    }
+
+    // Chunked framing: bounded frames, each but the last flagged as a continuation
+    int64 Offset = 0;
+    do
+    {
+        const uint32 FrameLength = (uint32)FMath::Min<int64>(Length - Offset, MaxFrameSize);
+        const bool bLastFrame = Offset + FrameLength >= Length;
+        if (!SendPayloadFrame(Data + Offset, FrameLength, bLastFrame ? 0 : FrameFlagMore))
+        {
+            return false;
+        }
+        Offset += FrameLength;
+    }
+    while (Offset < Length);
+
+    return true;
+}
+
+bool FMCPClientConnection::SendPayloadFrame(const uint8* Data, uint32 Length, uint32 Flags)
+{
+    if (CompressionFormat.IsNone() || Length < (uint32)CompressionThreshold)
+    {
+        return SendFrame(Transport, Data, Length, Flags);
+    }
+
+    // The compressed frame carries the uncompressed length ahead of the compressed bytes
+    int32 CompressedSize = FCompression::CompressMemoryBound(CompressionFormat, (int32)Length);
+    CompressionBuffer.SetNumUninitialized(CompressedFrameHeaderSize + CompressedSize, EAllowShrinking::No);
+    const bool bCompressed = FCompression::CompressMemory(CompressionFormat, CompressionBuffer.GetData() + CompressedFrameHeaderSize, CompressedSize, Data, (int32)Length);
+    if (!bCompressed || CompressedFrameHeaderSize + CompressedSize >= (int64)Length)
+    {
+        // Incompressible data such as PNG screenshots goes out as is
+        return SendFrame(Transport, Data, Length, Flags);
+    }
+
+    CompressionBuffer[0] = (Length >> 0) & 0xFF;
+    CompressionBuffer[1] = (Length >> 8) & 0xFF;
+    CompressionBuffer[2] = (Length >> 16) & 0xFF;
+    CompressionBuffer[3] = (Length >> 24) & 0xFF;
+    const bool bSent = SendFrame(Transport, CompressionBuffer.GetData(), CompressedFrameHeaderSize + CompressedSize, Flags | FrameFlagCompressed);
+
+    // Keep the scratch buffer for the next frame unless a huge single-frame message grew it
+    if (CompressionBuffer.Max() > MaxPooledResponseBufferSize)
+    {
+        CompressionBuffer.Empty();
+    }
+    return bSent;
+}
+
+bool FMCPClientConnection::SendFrame(const TSharedPtr<FMCPTransport>& Client, const uint8* Data, uint32 Length, uint32 Flags)
+{
+    // Send the 4-byte header first (little-endian)
+    const uint32 Header = (Length & FrameLengthMask) | Flags;
+    uint8 HeaderBytes[4];
+    HeaderBytes[0] = (Header >> 0) & 0xFF;
+    HeaderBytes[1] = (Header >> 8) & 0xFF;
+    HeaderBytes[2] = (Header >> 16) & 0xFF;
+    HeaderBytes[3] = (Header >> 24) & 0xFF;
+
+    // Then the frame payload
+    return SendAll(Client, HeaderBytes, sizeof(HeaderBytes)) && SendAll(Client, Data, Length);
+}
+
+bool FMCPClientConnection::SendAll(const TSharedPtr<FMCPTransport>& Client, const uint8* Data, int64 Length)
+{
+    // Send may accept only part of the buffer, so keep going until everything is written
+    int64 TotalSent = 0;
+    while (TotalSent < Length)
+    {
+        int32 BytesSent = 0;
+        const int32 StepSize = (int32)FMath::Min<int64>(Length - TotalSent, MAX_int32);
+        if (!Client->Send(Data + TotalSent, StepSize, BytesSent) || BytesSent <= 0)
+        {
+            return false;
+        }
+        TotalSent += BytesSent;
+    }
+    return true;
+}
+
+void FMCPClientConnection::HandleSubscription(const TSharedPtr<FJsonObject>& Params, const TSharedPtr<FJsonValue>& RequestId, bool bSubscribe)
+{
+    const uint32 AllEvents = (1u << (uint32)EMCPEditorEvent::Num) - 1;
+
+    uint32 Mask = 0;
+    const TArray<TSharedPtr<FJsonValue>>* EventNames = nullptr;
+    if (Params->TryGetArrayField(TEXT("events"), EventNames))
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *EventNames)
+        {
+            const FString Name = Value->AsString();
+            EMCPEditorEvent Event;
+            if (Name == TEXT("*"))
+            {
+                Mask = AllEvents;
+            }
+            else if (FMCPEventHub::FindEvent(Name, Event))
+            {
+                Mask |= 1u << (uint32)Event;
+            }
+            else
+            {
+                SendResponseObject(CreateErrorResponse(FString::Printf(TEXT("Unknown event: %s"), *Name), RequestId));
+                return;
+            }
+        }
+    }
+    else if (bSubscribe)
+    {
+        SendResponseObject(CreateErrorResponse(TEXT("Missing 'events' parameter"), RequestId));
+        return;
+    }
+    else
+    {
+        // Unsubscribing without a list ends the whole subscription
+        Mask = AllEvents;
+    }
+
+    FMCPEventHub& EventHub = Bridge->GetEventHub();
+    bool bNewSubscription = false;
+    if (bSubscribe)
+    {
+        if (EventSubscription.IsValid())
+        {
+            EventSubscription->SetEventMask(EventSubscription->GetEventMask() | Mask);
+        }
+        else if (Mask != 0)
+        {
+            EventSubscription = MakeShared<FMCPEventSubscription>(MaxPendingEventsPerSubscription);
+            EventSubscription->SetEventMask(Mask);
+            if (!StartEventDelivery())
+            {
+                EventSubscription.Reset();
+                SendResponseObject(CreateErrorResponse(TEXT("Failed to start sending events"), RequestId));
+                return;
+            }
+            bNewSubscription = true;
+        }
+    }
+    else if (EventSubscription.IsValid())
+    {
+        EventSubscription->SetEventMask(EventSubscription->GetEventMask() & ~Mask);
+        if (EventSubscription->GetEventMask() == 0)
+        {
+            EventHub.RemoveSubscription(EventSubscription.ToSharedRef());
+            StopEventDelivery();
+            EventSubscription.Reset();
+        }
+    }
+
+    TArray<TSharedPtr<FJsonValue>> SubscribedEvents;
+    for (int32 Index = 0; Index < (int32)EMCPEditorEvent::Num; ++Index)
+    {
+        if (EventSubscription.IsValid() && EventSubscription->IsSubscribed((EMCPEditorEvent)Index))
+        {
+            SubscribedEvents.Add(MakeShared<FJsonValueString>(FMCPEventHub::GetEventName((EMCPEditorEvent)Index)));
+        }
+    }
+
+    TSharedPtr<FJsonObject> ResultJson = MakeShared<FJsonObject>();
+    ResultJson->SetArrayField(TEXT("events"), SubscribedEvents);
+    ResultJson->SetNumberField(TEXT("max_pending_events"), MaxPendingEventsPerSubscription);
+
+    TSharedPtr<FJsonObject> ResponseJson = MakeShared<FJsonObject>();
+    if (RequestId.IsValid())
+    {
+        ResponseJson->SetField(TEXT("id"), RequestId);
+    }
+    ResponseJson->SetStringField(TEXT("status"), TEXT("success"));
+    ResponseJson->SetObjectField(TEXT("result"), ResultJson);
+    SendResponseObject(ResponseJson);
+
+    // Only handed to the hub once the reply is out, so no event can arrive ahead of it
+    if (bNewSubscription)
+    {
+        EventHub.AddSubscription(EventSubscription.ToSharedRef());
+    }
+}
+
+/** Sends a subscribed session's events as soon as they are queued, independently of its requests */
+class FMCPEventSender : public FRunnable
+{
+public:
+    FMCPEventSender(FMCPClientConnection& InConnection, const TSharedRef<FMCPEventSubscription>& InSubscription)
+        : Connection(InConnection)
+        , Subscription(InSubscription)
+        , bRunning(true)
+    {
+    }
+
+    virtual uint32 Run() override
+    {
+        while (bRunning)
+        {
+            Subscription->WaitForEvents();
+            if (bRunning)
+            {
+                Connection.SendPendingEvents(*Subscription);
+            }
+        }
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        bRunning = false;
+        Subscription->Wake();
+    }
+
+private:
+    FMCPClientConnection& Connection;
+    TSharedRef<FMCPEventSubscription> Subscription;
+    TAtomic<bool> bRunning;
+};
+
+bool FMCPClientConnection::StartEventDelivery()
+{
+    EventSender = new FMCPEventSender(*this, EventSubscription.ToSharedRef());
+    EventSenderThread = FRunnableThread::Create(EventSender, *FString::Printf(TEXT("UnrealMCPEvents_%d"), ConnectionId), 64 * 1024, TPri_Normal);
+    if (!EventSenderThread)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPClientConnection: Failed to create the event thread of session %d"), ConnectionId);
+        delete EventSender;
+        EventSender = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void FMCPClientConnection::StopEventDelivery()
+{
+    if (EventSenderThread)
+    {
+        // Killing the thread calls Stop(), which wakes it, and waits for it to exit
+        EventSenderThread->Kill(true);
+        delete EventSenderThread;
+        EventSenderThread = nullptr;
+    }
+
+    delete EventSender;
+    EventSender = nullptr;
+}
+
+void FMCPClientConnection::SendPendingEvents(FMCPEventSubscription& Subscription)
+{
+    TArray<TSharedPtr<FJsonObject>> Messages;
+    int32 Dropped = 0;
+    Subscription.TakePending(Messages, Dropped);
+
+    // Tell the client what it missed first, so it knows to resync before applying what follows
+    if (Dropped > 0)
+    {
+        TSharedPtr<FJsonObject> Data = MakeShared<FJsonObject>();
+        Data->SetNumberField(TEXT("count"), Dropped);
+        TSharedPtr<FJsonObject> DroppedMessage = MakeShared<FJsonObject>();
+        DroppedMessage->SetStringField(TEXT("event"), TEXT("events_dropped"));
+        DroppedMessage->SetObjectField(TEXT("data"), Data);
+        SendResponseObject(DroppedMessage);
+    }
+
+    for (const TSharedPtr<FJsonObject>& Message : Messages)
+    {
+        if (!SendResponseObject(Message))
+        {
+            break;
+        }
+    }
+}
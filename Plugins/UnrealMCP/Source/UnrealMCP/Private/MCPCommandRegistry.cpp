@@ -0,0 +1,90 @@
+#include "MCPCommandRegistry.h"
+#include "Dom/JsonValue.h"
+
+/** Name of a JSON type as it appears in parameter errors */
+static const TCHAR* GetJsonTypeName(EJson Type)
+{
+    switch (Type)
+    {
+    case EJson::String: return TEXT("a string");
+    case EJson::Number: return TEXT("a number");
+    case EJson::Boolean: return TEXT("a boolean");
+    case EJson::Array: return TEXT("an array");
+    case EJson::Object: return TEXT("an object");
+    default: return TEXT("a value");
+    }
+}
+
+const TCHAR* LexToString(EMCPCommandPriority Priority)
+{
+    switch (Priority)
+    {
+    case EMCPCommandPriority::Control: return TEXT("control");
+    case EMCPCommandPriority::Interactive: return TEXT("interactive");
+    case EMCPCommandPriority::Mutation: return TEXT("mutation");
+    default: return TEXT("bulk");
+    }
+}
+
+FMCPCommandInfo& FMCPCommandInfo::ReadOnly()
+{
+    bReadOnly = true;
+    // Only the default moves, so Bulk or Control set earlier is kept
+    if (PriorityClass == EMCPCommandPriority::Mutation)
+    {
+        PriorityClass = EMCPCommandPriority::Interactive;
+    }
+    return *this;
+}
+
+FMCPCommandInfo& FMCPCommandInfo::Require(const TCHAR* ParamName, EJson Type)
+{
+    RequiredParams.Add({ FString(ParamName), Type });
+    return *this;
+}
+
+FMCPCommandInfo& FMCPCommandInfo::Streamed(FMCPStreamedCommandHandler InStreamedHandler)
+{
+    StreamedHandler = MoveTemp(InStreamedHandler);
+    return *this;
+}
+
+bool FMCPCommandInfo::ValidateParams(const TSharedPtr<FJsonObject>& Params, FString& OutError) const
+{
+    for (const FMCPCommandParam& Param : RequiredParams)
+    {
+        const TSharedPtr<FJsonValue> Value = Params.IsValid() ? Params->TryGetField(Param.Name) : nullptr;
+        if (!Value.IsValid() || Value->IsNull())
+        {
+            OutError = FString::Printf(TEXT("Missing '%s' parameter"), *Param.Name);
+            return false;
+        }
+        if (Param.Type != EJson::None && Value->Type != Param.Type)
+        {
+            OutError = FString::Printf(TEXT("'%s' parameter must be %s"), *Param.Name, GetJsonTypeName(Param.Type));
+            return false;
+        }
+    }
+    return true;
+}
+
+FMCPCommandInfo& FMCPCommandRegistry::Register(const TCHAR* Name, FMCPCommandHandler Handler)
+{
+    const FName CommandName(Name);
+    if (Commands.Contains(CommandName))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MCPCommandRegistry: Command '%s' registered twice, keeping the last one"), Name);
+    }
+
+    FMCPCommandInfo& Info = Commands.Add(CommandName);
+    Info.Name = CommandName;
+    Info.Handler = MoveTemp(Handler);
+    return Info;
+}
+
+const FMCPCommandInfo* FMCPCommandRegistry::Find(const FString& Name) const
+{
+    // FNAME_Find looks the string up without adding it, so unknown commands resolve to NAME_None
+    const FName CommandName(*Name, FNAME_Find);
+    return CommandName.IsNone() ? nullptr : Commands.Find(CommandName);
+}
@@ -0,0 +1,135 @@
+#include "MCPConnectionManager.h"
+#include "MCPClientConnection.h"
+#include "UnrealMCPBridge.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/ScopeLock.h"
+
+/** Creates a request pool, or returns null so its requests run on the session threads instead */
+static FQueuedThreadPool* CreateRequestPool(int32 NumWorkers, const TCHAR* Name)
+{
+    FQueuedThreadPool* Pool = FQueuedThreadPool::Allocate();
+    if (!Pool->Create(FMath::Max(1, NumWorkers), 128 * 1024, TPri_Normal, Name))
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPConnectionManager: Failed to create %s, its requests will run sequentially"), Name);
+        delete Pool;
+        return nullptr;
+    }
+    return Pool;
+}
+
+/** Waits for a pool's queued work and frees it */
+static void DestroyRequestPool(FQueuedThreadPool*& Pool)
+{
+    if (Pool)
+    {
+        Pool->Destroy();
+        delete Pool;
+        Pool = nullptr;
+    }
+}
+
+FMCPConnectionManager::FMCPConnectionManager(UUnrealMCPBridge* InBridge, int32 InMaxConnections, int32 InNumRequestWorkers, int32 InNumInteractiveWorkers)
+    : Bridge(InBridge)
+    , MaxConnections(FMath::Max(1, InMaxConnections))
+    , NextConnectionId(1)
+    , bAcceptingConnections(true)
+    , RequestPool(CreateRequestPool(InNumRequestWorkers, TEXT("UnrealMCPRequestPool")))
+    , InteractivePool(CreateRequestPool(InNumInteractiveWorkers, TEXT("UnrealMCPInteractivePool")))
+{
+}
+
+FMCPConnectionManager::~FMCPConnectionManager()
+{
+    StopAll();
+}
+
+bool FMCPConnectionManager::AddConnection(TSharedPtr<FMCPTransport> ClientTransport)
+{
+    FScopeLock Lock(&ConnectionsLock);
+
+    ReapFinishedConnections();
+
+    if (!bAcceptingConnections)
+    {
+        FMCPClientConnection::RejectClient(ClientTransport, TEXT("Server is shutting down"));
+        return false;
+    }
+
+    if (Connections.Num() >= MaxConnections)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MCPConnectionManager: Rejecting client, all %d connection slots are in use"), MaxConnections);
+        FMCPClientConnection::RejectClient(ClientTransport, FString::Printf(TEXT("Server busy: all %d connection slots are in use"), MaxConnections));
+        return false;
+    }
+
+    const int32 ConnectionId = NextConnectionId++;
+    TSharedPtr<FMCPClientConnection> Connection = MakeShared<FMCPClientConnection>(Bridge, ClientTransport, ConnectionId, RequestPool, InteractivePool);
+
+    FRunnableThread* Thread = FRunnableThread::Create(
+        Connection.Get(),
+        *FString::Printf(TEXT("UnrealMCPConnection_%d"), ConnectionId),
+        0, TPri_Normal
+    );
+
+    if (!Thread)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPConnectionManager: Failed to create worker thread for connection %d"), ConnectionId);
+        FMCPClientConnection::RejectClient(ClientTransport, TEXT("Server failed to start a worker for this connection"));
+        return false;
+    }
+
+    FConnectionSlot& Slot = Connections.AddDefaulted_GetRef();
+    Slot.Connection = Connection;
+    Slot.Thread = Thread;
+
+    UE_LOG(LogTemp, Display, TEXT("MCPConnectionManager: Serving connection %d (%d/%d active)"), ConnectionId, Connections.Num(), MaxConnections);
+    return true;
+}
+
+void FMCPConnectionManager::StopAll()
+{
+    TArray<FConnectionSlot> SlotsToStop;
+    {
+        FScopeLock Lock(&ConnectionsLock);
+        bAcceptingConnections = false;
+        SlotsToStop = MoveTemp(Connections);
+        Connections.Reset();
+    }
+
+    // Kill outside the lock; each worker is woken by its connection's Stop()
+    for (FConnectionSlot& Slot : SlotsToStop)
+    {
+        if (Slot.Thread)
+        {
+            Slot.Thread->Kill(true);
+            delete Slot.Thread;
+            Slot.Thread = nullptr;
+        }
+    }
+
+    // Sessions wait for their own pipelined requests, so the pools are idle by now
+    DestroyRequestPool(RequestPool);
+    DestroyRequestPool(InteractivePool);
+}
+
+int32 FMCPConnectionManager::GetNumActiveConnections()
+{
+    FScopeLock Lock(&ConnectionsLock);
+    ReapFinishedConnections();
+    return Connections.Num();
+}
+
+void FMCPConnectionManager::ReapFinishedConnections()
+{
+    for (int32 Index = Connections.Num() - 1; Index >= 0; --Index)
+    {
+        FConnectionSlot& Slot = Connections[Index];
+        if (Slot.Connection->IsFinished())
+        {
+            Slot.Thread->WaitForCompletion();
+            delete Slot.Thread;
+            Connections.RemoveAtSwap(Index);
+        }
+    }
+}
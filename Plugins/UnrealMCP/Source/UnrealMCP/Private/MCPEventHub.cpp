@@ -0,0 +1,384 @@
+#include "MCPEventHub.h"
+#include "MCPSceneChangeLog.h"
+#include "Commands/UnrealMCPCommonUtils.h"
+#include "Editor.h"
+#include "Editor/EditorEngine.h"
+#include "Engine/Blueprint.h"
+#include "Engine/Selection.h"
+#include "GameFramework/Actor.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+
+static const TCHAR* const GEventNames[] =
+{
+    TEXT("actor_added"),
+    TEXT("actor_removed"),
+    TEXT("actor_moved"),
+    TEXT("level_changed"),
+    TEXT("selection_changed"),
+    TEXT("blueprint_compiled"),
+    TEXT("asset_saved"),
+    TEXT("pie_started"),
+    TEXT("pie_stopped")
+};
+static_assert(UE_ARRAY_COUNT(GEventNames) == (int32)EMCPEditorEvent::Num, "Every editor event needs a name");
+
+/** Name of a blueprint's compile status as it appears in blueprint_compiled */
+static const TCHAR* GetBlueprintStatusName(EBlueprintStatus Status)
+{
+    switch (Status)
+    {
+    case BS_UpToDate: return TEXT("up_to_date");
+    case BS_UpToDateWithWarnings: return TEXT("up_to_date_with_warnings");
+    case BS_Error: return TEXT("error");
+    case BS_Dirty: return TEXT("dirty");
+    default: return TEXT("unknown");
+    }
+}
+
+FMCPEventSubscription::FMCPEventSubscription(int32 InMaxPendingEvents)
+    : EventMask(0)
+    , MaxPendingEvents(InMaxPendingEvents)
+    , DroppedEvents(0)
+{
+}
+
+void FMCPEventSubscription::Push(const TSharedPtr<FJsonObject>& Message)
+{
+    {
+        FScopeLock Lock(&PendingLock);
+        if (PendingMessages.Num() >= MaxPendingEvents)
+        {
+            ++DroppedEvents;
+            return;
+        }
+        PendingMessages.Add(Message);
+    }
+    EventsPushed->Trigger();
+}
+
+void FMCPEventSubscription::TakePending(TArray<TSharedPtr<FJsonObject>>& OutMessages, int32& OutDropped)
+{
+    FScopeLock Lock(&PendingLock);
+    OutMessages = MoveTemp(PendingMessages);
+    PendingMessages.Reset();
+    OutDropped = DroppedEvents;
+    DroppedEvents = 0;
+}
+
+FMCPEventHub::FMCPEventHub()
+    : ActorIndex(nullptr)
+    , SceneChanges(nullptr)
+    , WantedEvents(0)
+    , bBound(false)
+    , bSelectionChanged(false)
+{
+}
+
+FMCPEventHub::~FMCPEventHub()
+{
+    Stop();
+}
+
+void FMCPEventHub::Init(FMCPActorIndex& InActorIndex, FMCPSceneChangeLog& InSceneChanges)
+{
+    check(!EndFrameHandle.IsValid());
+    ActorIndex = &InActorIndex;
+    SceneChanges = &InSceneChanges;
+}
+
+void FMCPEventHub::Start()
+{
+    check(IsInGameThread() && ActorIndex && SceneChanges);
+
+    if (!EndFrameHandle.IsValid())
+    {
+        EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FMCPEventHub::OnEndFrame);
+    }
+}
+
+void FMCPEventHub::Stop()
+{
+    if (EndFrameHandle.IsValid())
+    {
+        FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+        EndFrameHandle.Reset();
+    }
+    UnbindEditorEvents();
+    WantedEvents = 0;
+
+    FScopeLock Lock(&SubscriptionsLock);
+    Subscriptions.Reset();
+}
+
+void FMCPEventHub::AddSubscription(const TSharedRef<FMCPEventSubscription>& Subscription)
+{
+    FScopeLock Lock(&SubscriptionsLock);
+    Subscriptions.AddUnique(Subscription);
+}
+
+void FMCPEventHub::RemoveSubscription(const TSharedRef<FMCPEventSubscription>& Subscription)
+{
+    FScopeLock Lock(&SubscriptionsLock);
+    Subscriptions.Remove(Subscription);
+}
+
+const TCHAR* FMCPEventHub::GetEventName(EMCPEditorEvent Event)
+{
+    return GEventNames[(int32)Event];
+}
+
+bool FMCPEventHub::FindEvent(const FString& Name, EMCPEditorEvent& OutEvent)
+{
+    for (int32 Index = 0; Index < (int32)EMCPEditorEvent::Num; ++Index)
+    {
+        if (Name == GEventNames[Index])
+        {
+            OutEvent = (EMCPEditorEvent)Index;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FMCPEventHub::OnEndFrame()
+{
+    TArray<TSharedRef<FMCPEventSubscription>> Subscribers;
+    {
+        FScopeLock Lock(&SubscriptionsLock);
+        Subscribers = Subscriptions;
+    }
+
+    // Editor events are only listened to while some client wants them
+    uint32 Mask = 0;
+    for (const TSharedRef<FMCPEventSubscription>& Subscriber : Subscribers)
+    {
+        Mask |= Subscriber->GetEventMask();
+    }
+    WantedEvents = Mask;
+    if (WantedEvents != 0 && !bBound)
+    {
+        BindEditorEvents();
+    }
+    else if (WantedEvents == 0 && bBound)
+    {
+        UnbindEditorEvents();
+    }
+    if (!bBound)
+    {
+        return;
+    }
+
+    // Actors added or removed in bulk, e.g. by an undo, only show up once the index is rebuilt
+    if (IsWanted(EMCPEditorEvent::ActorAdded) || IsWanted(EMCPEditorEvent::ActorRemoved) || IsWanted(EMCPEditorEvent::LevelChanged))
+    {
+        ActorIndex->EnsureUpToDate();
+    }
+
+    // Every actor moved this frame is reported once, where it ended up
+    for (const TPair<FName, TWeakObjectPtr<AActor>>& Move : PendingMoves)
+    {
+        if (AActor* Actor = Move.Value.Get())
+        {
+            AddEvent(EMCPEditorEvent::ActorMoved, MakeActorData(Actor, Move.Key));
+        }
+    }
+    PendingMoves.Reset();
+
+    if (bSelectionChanged)
+    {
+        bSelectionChanged = false;
+
+        TArray<TSharedPtr<FJsonValue>> SelectedActors;
+        for (FSelectionIterator It(GEditor->GetSelectedActorIterator()); It; ++It)
+        {
+            if (const AActor* Actor = Cast<AActor>(*It))
+            {
+                SelectedActors.Add(MakeShared<FJsonValueString>(Actor->GetName()));
+            }
+        }
+        TSharedPtr<FJsonObject> Data = MakeShared<FJsonObject>();
+        Data->SetArrayField(TEXT("actors"), SelectedActors);
+        AddEvent(EMCPEditorEvent::SelectionChanged, Data);
+    }
+
+    for (const FPendingEvent& Pending : PendingEvents)
+    {
+        for (const TSharedRef<FMCPEventSubscription>& Subscriber : Subscribers)
+        {
+            if (Subscriber->IsSubscribed(Pending.Event))
+            {
+                Subscriber->Push(Pending.Message);
+            }
+        }
+    }
+    PendingEvents.Reset();
+}
+
+void FMCPEventHub::BindEditorEvents()
+{
+    // The index only reports changes once it is in use
+    ActorIndex->EnsureUpToDate();
+    ActorChangedHandle = ActorIndex->OnActorChanged().AddRaw(this, &FMCPEventHub::OnActorChanged);
+    SelectionChangedHandle = USelection::SelectionChangedEvent.AddRaw(this, &FMCPEventHub::OnSelectionChanged);
+    if (GEditor)
+    {
+        BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddRaw(this, &FMCPEventHub::OnBlueprintPreCompile);
+        BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FMCPEventHub::OnBlueprintCompiled);
+    }
+    PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FMCPEventHub::OnPackageSaved);
+    PostPIEStartedHandle = FEditorDelegates::PostPIEStarted.AddRaw(this, &FMCPEventHub::OnPostPIEStarted);
+    EndPIEHandle = FEditorDelegates::EndPIE.AddRaw(this, &FMCPEventHub::OnEndPIE);
+    bBound = true;
+}
+
+void FMCPEventHub::UnbindEditorEvents()
+{
+    if (!bBound)
+    {
+        return;
+    }
+
+    ActorIndex->OnActorChanged().Remove(ActorChangedHandle);
+    USelection::SelectionChangedEvent.Remove(SelectionChangedHandle);
+    if (GEditor)
+    {
+        GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+        GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+    }
+    UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+    FEditorDelegates::PostPIEStarted.Remove(PostPIEStartedHandle);
+    FEditorDelegates::EndPIE.Remove(EndPIEHandle);
+    bBound = false;
+
+    PendingEvents.Reset();
+    PendingMoves.Reset();
+    bSelectionChanged = false;
+    CompilingBlueprints.Reset();
+}
+
+void FMCPEventHub::AddEvent(EMCPEditorEvent Event, const TSharedPtr<FJsonObject>& Data)
+{
+    TSharedPtr<FJsonObject> Message = MakeShared<FJsonObject>();
+    Message->SetStringField(TEXT("event"), GetEventName(Event));
+    Message->SetObjectField(TEXT("data"), Data);
+
+    FPendingEvent& Pending = PendingEvents.AddDefaulted_GetRef();
+    Pending.Event = Event;
+    Pending.Message = Message;
+}
+
+TSharedPtr<FJsonObject> FMCPEventHub::MakeActorData(AActor* Actor, FName ActorName) const
+{
+    TSharedPtr<FJsonObject> Data = Actor ? FUnrealMCPCommonUtils::ActorToJsonObject(Actor) : MakeShared<FJsonObject>();
+    Data->SetStringField(TEXT("name"), ActorName.ToString());
+    Data->SetNumberField(TEXT("version"), (double)SceneChanges->GetVersion());
+    return Data;
+}
+
+void FMCPEventHub::OnActorChanged(EMCPActorChange Change, AActor* Actor, FName ActorName)
+{
+    switch (Change)
+    {
+    case EMCPActorChange::Added:
+        if (IsWanted(EMCPEditorEvent::ActorAdded))
+        {
+            AddEvent(EMCPEditorEvent::ActorAdded, MakeActorData(Actor, ActorName));
+        }
+        break;
+    case EMCPActorChange::Removed:
+        PendingMoves.Remove(ActorName);
+        if (IsWanted(EMCPEditorEvent::ActorRemoved))
+        {
+            AddEvent(EMCPEditorEvent::ActorRemoved, MakeActorData(nullptr, ActorName));
+        }
+        break;
+    case EMCPActorChange::Transformed:
+        if (IsWanted(EMCPEditorEvent::ActorMoved))
+        {
+            PendingMoves.Add(ActorName, Actor);
+        }
+        break;
+    case EMCPActorChange::Reset:
+        PendingMoves.Reset();
+        if (IsWanted(EMCPEditorEvent::LevelChanged))
+        {
+            TSharedPtr<FJsonObject> Data = MakeShared<FJsonObject>();
+            Data->SetNumberField(TEXT("version"), (double)SceneChanges->GetVersion());
+            AddEvent(EMCPEditorEvent::LevelChanged, Data);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void FMCPEventHub::OnSelectionChanged(UObject* Selection)
+{
+    // Every selection set broadcasts this; only the actor selection is reported
+    if (IsWanted(EMCPEditorEvent::SelectionChanged) && GEditor && Selection == GEditor->GetSelectedActors())
+    {
+        bSelectionChanged = true;
+    }
+}
+
+void FMCPEventHub::OnBlueprintPreCompile(UBlueprint* Blueprint)
+{
+    if (IsWanted(EMCPEditorEvent::BlueprintCompiled) && Blueprint)
+    {
+        CompilingBlueprints.AddUnique(Blueprint);
+    }
+}
+
+void FMCPEventHub::OnBlueprintCompiled()
+{
+    // Compiled is broadcast once for the whole batch; the blueprints in it were seen before they compiled
+    for (const TWeakObjectPtr<UBlueprint>& WeakBlueprint : CompilingBlueprints)
+    {
+        if (UBlueprint* Blueprint = WeakBlueprint.Get())
+        {
+            TSharedPtr<FJsonObject> Data = MakeShared<FJsonObject>();
+            Data->SetStringField(TEXT("name"), Blueprint->GetName());
+            Data->SetStringField(TEXT("path"), Blueprint->GetPathName());
+            Data->SetStringField(TEXT("status"), GetBlueprintStatusName(Blueprint->Status));
+            AddEvent(EMCPEditorEvent::BlueprintCompiled, Data);
+        }
+    }
+    CompilingBlueprints.Reset();
+}
+
+void FMCPEventHub::OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext)
+{
+    // Cooking writes packages too, but does not change the project
+    if (!IsWanted(EMCPEditorEvent::AssetSaved) || !Package || SaveContext.IsProceduralSave() || !IsInGameThread())
+    {
+        return;
+    }
+
+    TSharedPtr<FJsonObject> Data = MakeShared<FJsonObject>();
+    Data->SetStringField(TEXT("package"), Package->GetName());
+    Data->SetStringField(TEXT("filename"), PackageFileName);
+    AddEvent(EMCPEditorEvent::AssetSaved, Data);
+}
+
+void FMCPEventHub::OnPostPIEStarted(bool bIsSimulating)
+{
+    if (IsWanted(EMCPEditorEvent::PieStarted))
+    {
+        TSharedPtr<FJsonObject> Data = MakeShared<FJsonObject>();
+        Data->SetBoolField(TEXT("simulating"), bIsSimulating);
+        AddEvent(EMCPEditorEvent::PieStarted, Data);
+    }
+}
+
+void FMCPEventHub::OnEndPIE(bool bIsSimulating)
+{
+    if (IsWanted(EMCPEditorEvent::PieStopped))
+    {
+        TSharedPtr<FJsonObject> Data = MakeShared<FJsonObject>();
+        Data->SetBoolField(TEXT("simulating"), bIsSimulating);
+        AddEvent(EMCPEditorEvent::PieStopped, Data);
+    }
+}
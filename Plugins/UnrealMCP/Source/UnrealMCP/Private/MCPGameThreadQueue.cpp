@@ -0,0 +1,173 @@
+#include "MCPGameThreadQueue.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<float> CVarMCPGameThreadBudgetMs(
+    TEXT("UnrealMCP.GameThreadBudgetMs"),
+    4.0f,
+    TEXT("Game-thread time in milliseconds that MCP commands may use per editor frame. 0 runs every queued command in the next frame."),
+    ECVF_Default);
+
+// Admission limit of each lane, by priority class. Mutations legitimately arrive in large bursts;
+// control and read items should never pile up, and a deep bulk lane only adds latency.
+static const int32 MaxLaneDepths[(int32)EMCPCommandPriority::Num] = { 256, 1024, 4096, 256 };
+
+FMCPGameThreadQueue::FMCPGameThreadQueue()
+    : bAccepting(false)
+{
+    for (int32 Lane = 0; Lane < (int32)EMCPCommandPriority::Num; ++Lane)
+    {
+        Stats.Lanes[Lane].MaxDepth = MaxLaneDepths[Lane];
+    }
+}
+
+FMCPGameThreadQueue::~FMCPGameThreadQueue()
+{
+    Stop();
+}
+
+void FMCPGameThreadQueue::Start()
+{
+    check(IsInGameThread());
+
+    FScopeLock Lock(&AcceptLock);
+    if (!bAccepting)
+    {
+        bAccepting = true;
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMCPGameThreadQueue::Tick));
+    }
+}
+
+void FMCPGameThreadQueue::Stop()
+{
+    {
+        FScopeLock Lock(&AcceptLock);
+        if (!bAccepting)
+        {
+            return;
+        }
+        bAccepting = false;
+    }
+
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    TickerHandle.Reset();
+
+    // Nothing can be queued any more; run the rest so no worker waits out its timeout
+    const int32 Ran = Drain(0.0);
+    if (Ran > 0)
+    {
+        UE_LOG(LogTemp, Display, TEXT("MCPGameThreadQueue: Ran %d queued commands while stopping"), Ran);
+    }
+}
+
+EMCPEnqueueResult FMCPGameThreadQueue::Enqueue(TUniqueFunction<void()>&& Work, EMCPCommandPriority Priority)
+{
+    FScopeLock Lock(&AcceptLock);
+    if (!bAccepting)
+    {
+        return EMCPEnqueueResult::Stopped;
+    }
+
+    const int32 Lane = (int32)Priority;
+    {
+        // Counted before it becomes visible to the game thread, so the depth never goes negative
+        FScopeLock StatsScope(&StatsLock);
+        FMCPGameThreadLaneStats& LaneStats = Stats.Lanes[Lane];
+        if (LaneStats.Depth >= LaneStats.MaxDepth)
+        {
+            ++LaneStats.ItemsRejected;
+            return EMCPEnqueueResult::LaneFull;
+        }
+
+        ++LaneStats.Depth;
+        LaneStats.PeakDepth = FMath::Max(LaneStats.PeakDepth, LaneStats.Depth);
+        ++Stats.Depth;
+        Stats.PeakDepth = FMath::Max(Stats.PeakDepth, Stats.Depth);
+    }
+
+    FQueuedItem Item;
+    Item.Work = MoveTemp(Work);
+    Item.EnqueueTime = FPlatformTime::Seconds();
+    Lanes[Lane].Enqueue(MoveTemp(Item));
+    return EMCPEnqueueResult::Queued;
+}
+
+FMCPGameThreadQueueStats FMCPGameThreadQueue::GetStats() const
+{
+    FScopeLock Lock(&StatsLock);
+    FMCPGameThreadQueueStats Snapshot = Stats;
+    Snapshot.BudgetMs = CVarMCPGameThreadBudgetMs.GetValueOnAnyThread();
+    return Snapshot;
+}
+
+bool FMCPGameThreadQueue::Tick(float DeltaTime)
+{
+    const double BudgetSeconds = FMath::Max(0.0f, CVarMCPGameThreadBudgetMs.GetValueOnGameThread()) / 1000.0;
+    const double StartTime = FPlatformTime::Seconds();
+
+    const int32 Ran = Drain(BudgetSeconds > 0.0 ? StartTime + BudgetSeconds : 0.0);
+    if (Ran == 0)
+    {
+        return true;
+    }
+
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    const double OverrunMs = BudgetSeconds > 0.0 ? ElapsedMs - BudgetSeconds * 1000.0 : 0.0;
+
+    FScopeLock Lock(&StatsLock);
+    ++Stats.BusyFrames;
+    Stats.LastFrameMs = ElapsedMs;
+    Stats.MaxFrameMs = FMath::Max(Stats.MaxFrameMs, ElapsedMs);
+    if (OverrunMs > 0.0)
+    {
+        ++Stats.OverrunFrames;
+        Stats.TotalOverrunMs += OverrunMs;
+        Stats.MaxOverrunMs = FMath::Max(Stats.MaxOverrunMs, OverrunMs);
+    }
+    return true;
+}
+
+int32 FMCPGameThreadQueue::Drain(double Deadline)
+{
+    check(IsInGameThread());
+
+    int32 Ran = 0;
+    FQueuedItem Item;
+    int32 Lane = 0;
+    // The first item always runs, so one expensive command cannot stall the queue
+    while (DequeueNext(Ran == 0 || Deadline <= 0.0 || FPlatformTime::Seconds() < Deadline, Item, Lane))
+    {
+        const double WaitMs = (FPlatformTime::Seconds() - Item.EnqueueTime) * 1000.0;
+        {
+            FScopeLock Lock(&StatsLock);
+            FMCPGameThreadLaneStats& LaneStats = Stats.Lanes[Lane];
+            --LaneStats.Depth;
+            ++LaneStats.ItemsRun;
+            LaneStats.LastWaitMs = WaitMs;
+            LaneStats.MaxWaitMs = FMath::Max(LaneStats.MaxWaitMs, WaitMs);
+            --Stats.Depth;
+        }
+
+        Item.Work();
+        Item.Work.Reset();
+        ++Ran;
+    }
+
+    FScopeLock Lock(&StatsLock);
+    Stats.ItemsRun += Ran;
+    return Ran;
+}
+
+bool FMCPGameThreadQueue::DequeueNext(bool bWithinBudget, FQueuedItem& OutItem, int32& OutLane)
+{
+    const int32 LastLane = bWithinBudget ? (int32)EMCPCommandPriority::Num - 1 : (int32)EMCPCommandPriority::Control;
+    for (int32 Lane = 0; Lane <= LastLane; ++Lane)
+    {
+        if (Lanes[Lane].Dequeue(OutItem))
+        {
+            OutLane = Lane;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,245 @@
+#include "MCPJobManager.h"
+#include "HAL/PlatformTime.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+/** Name of a job state as it appears in job status */
+static const TCHAR* GetJobStateName(EMCPJobState State)
+{
+    switch (State)
+    {
+    case EMCPJobState::Queued: return TEXT("queued");
+    case EMCPJobState::Running: return TEXT("running");
+    case EMCPJobState::Succeeded: return TEXT("succeeded");
+    case EMCPJobState::Failed: return TEXT("failed");
+    default: return TEXT("cancelled");
+    }
+}
+
+FMCPJob::FMCPJob(const FString& InId, const FString& InCommandType, FMCPJobManager& InManager)
+    : Id(InId)
+    , CommandType(InCommandType)
+    , Manager(InManager)
+    , SubmitTime(FPlatformTime::Seconds())
+    , State(EMCPJobState::Queued)
+    , FinishedEvent(EEventMode::ManualReset)
+    , FinishTime(0.0)
+    , FinishedNode(nullptr)
+{
+}
+
+bool FMCPJob::IsFinished() const
+{
+    const EMCPJobState CurrentState = State;
+    return CurrentState != EMCPJobState::Queued && CurrentState != EMCPJobState::Running;
+}
+
+bool FMCPJob::TryStart()
+{
+    EMCPJobState Expected = EMCPJobState::Queued;
+    return State.CompareExchange(Expected, EMCPJobState::Running);
+}
+
+bool FMCPJob::TryCancel()
+{
+    EMCPJobState Expected = EMCPJobState::Queued;
+    if (!State.CompareExchange(Expected, EMCPJobState::Cancelled))
+    {
+        return false;
+    }
+
+    {
+        FScopeLock Lock(&ResponseLock);
+        FinishTime = FPlatformTime::Seconds();
+    }
+    NotifyFinished();
+    FinishedEvent->Trigger();
+    return true;
+}
+
+void FMCPJob::Finish(const TSharedPtr<FJsonObject>& InResponse)
+{
+    {
+        FScopeLock Lock(&ResponseLock);
+        Response = InResponse;
+        FinishTime = FPlatformTime::Seconds();
+    }
+
+    FString Status;
+    const bool bSucceeded = InResponse.IsValid() && InResponse->TryGetStringField(TEXT("status"), Status) && Status == TEXT("success");
+    State = bSucceeded ? EMCPJobState::Succeeded : EMCPJobState::Failed;
+    NotifyFinished();
+    FinishedEvent->Trigger();
+}
+
+void FMCPJob::FinishStreamed(const FMCPResultWriter& InResultWriter)
+{
+    {
+        FScopeLock Lock(&ResponseLock);
+        ResultWriter = InResultWriter;
+        FinishTime = FPlatformTime::Seconds();
+    }
+
+    State = EMCPJobState::Succeeded;
+    NotifyFinished();
+    FinishedEvent->Trigger();
+}
+
+void FMCPJob::NotifyFinished()
+{
+    // Ahead of the trigger, so a caller that waited and then removes the job finds it filed
+    Manager.OnJobFinished(Id);
+}
+
+bool FMCPJob::Wait(FTimespan Timeout)
+{
+    return IsFinished() || FinishedEvent->Wait(Timeout);
+}
+
+TSharedPtr<FJsonObject> FMCPJob::GetResponse() const
+{
+    FScopeLock Lock(&ResponseLock);
+    return Response;
+}
+
+FMCPResultWriter FMCPJob::GetResultWriter() const
+{
+    FScopeLock Lock(&ResponseLock);
+    return ResultWriter;
+}
+
+// A streamed result is only turned into a DOM when its caller stopped waiting and it is fetched as a job
+static TSharedPtr<FJsonObject> WriteResultObject(const FMCPResultWriter& ResultWriter)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Archive(Bytes);
+    TUniquePtr<FMCPResponseWriter> Writer = FMCPResponseWriter::Create(EMCPPayloadEncoding::Json, Archive);
+    Writer->WriteObjectStart();
+    ResultWriter(*Writer);
+    Writer->WriteObjectEnd();
+    Writer->Close();
+
+    TSharedPtr<FJsonObject> Result;
+    FUTF8ToTCHAR Converter((const ANSICHAR*)Bytes.GetData(), Bytes.Num());
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FString(Converter.Length(), Converter.Get()));
+    return FJsonSerializer::Deserialize(Reader, Result) ? Result : MakeShared<FJsonObject>();
+}
+
+double FMCPJob::GetSecondsSinceFinished() const
+{
+    FScopeLock Lock(&ResponseLock);
+    return FinishTime > 0.0 ? FPlatformTime::Seconds() - FinishTime : 0.0;
+}
+
+TSharedPtr<FJsonObject> FMCPJob::ToJson() const
+{
+    const EMCPJobState CurrentState = State;
+
+    TSharedPtr<FJsonObject> StatusJson = MakeShared<FJsonObject>();
+    StatusJson->SetStringField(TEXT("job_id"), Id);
+    StatusJson->SetStringField(TEXT("command"), CommandType);
+    StatusJson->SetStringField(TEXT("state"), GetJobStateName(CurrentState));
+
+    FScopeLock Lock(&ResponseLock);
+    const double EndTime = FinishTime > 0.0 ? FinishTime : FPlatformTime::Seconds();
+    StatusJson->SetNumberField(TEXT("elapsed_seconds"), EndTime - SubmitTime);
+
+    if (CurrentState == EMCPJobState::Succeeded && ResultWriter)
+    {
+        StatusJson->SetObjectField(TEXT("result"), WriteResultObject(ResultWriter));
+    }
+    else if (CurrentState == EMCPJobState::Succeeded && Response.IsValid())
+    {
+        const TSharedPtr<FJsonObject>* Result = nullptr;
+        if (Response->TryGetObjectField(TEXT("result"), Result))
+        {
+            StatusJson->SetObjectField(TEXT("result"), *Result);
+        }
+    }
+    else if (CurrentState == EMCPJobState::Failed && Response.IsValid())
+    {
+        StatusJson->SetStringField(TEXT("error"), Response->GetStringField(TEXT("error")));
+    }
+    return StatusJson;
+}
+
+FMCPJobManager::FMCPJobManager()
+    : RetentionSeconds(0.0)
+    , MaxFinishedJobs(0)
+    , NextJobNumber(0)
+{
+}
+
+void FMCPJobManager::Init(double InRetentionSeconds, int32 InMaxFinishedJobs)
+{
+    FScopeLock Lock(&JobsLock);
+    RetentionSeconds = InRetentionSeconds;
+    MaxFinishedJobs = InMaxFinishedJobs;
+}
+
+TSharedRef<FMCPJob> FMCPJobManager::CreateJob(const FString& CommandType)
+{
+    FScopeLock Lock(&JobsLock);
+    PruneFinishedJobs();
+
+    const FString Id = FString::Printf(TEXT("job-%llu"), ++NextJobNumber);
+    TSharedRef<FMCPJob> Job = MakeShared<FMCPJob>(Id, CommandType, *this);
+    Jobs.Add(Id, Job);
+    return Job;
+}
+
+TSharedPtr<FMCPJob> FMCPJobManager::FindJob(const FString& Id)
+{
+    FScopeLock Lock(&JobsLock);
+    PruneFinishedJobs();
+
+    const TSharedRef<FMCPJob>* Job = Jobs.Find(Id);
+    return Job ? TSharedPtr<FMCPJob>(*Job) : nullptr;
+}
+
+void FMCPJobManager::RemoveJob(const FString& Id)
+{
+    FScopeLock Lock(&JobsLock);
+    const TSharedRef<FMCPJob>* Job = Jobs.Find(Id);
+    if (!Job)
+    {
+        return;
+    }
+
+    if ((*Job)->FinishedNode)
+    {
+        FinishedJobIds.RemoveNode((*Job)->FinishedNode);
+        (*Job)->FinishedNode = nullptr;
+    }
+    Jobs.Remove(Id);
+}
+
+void FMCPJobManager::OnJobFinished(const FString& Id)
+{
+    FScopeLock Lock(&JobsLock);
+    const TSharedRef<FMCPJob>* Job = Jobs.Find(Id);
+    if (Job && !(*Job)->FinishedNode)
+    {
+        FinishedJobIds.AddTail(Id);
+        (*Job)->FinishedNode = FinishedJobIds.GetTail();
+    }
+}
+
+void FMCPJobManager::PruneFinishedJobs()
+{
+    // Jobs are listed as they finish, so the oldest come first and the first one kept ends the walk
+    while (TDoubleLinkedList<FString>::TDoubleLinkedListNode* Oldest = FinishedJobIds.GetHead())
+    {
+        const FString Id = Oldest->GetValue();
+        const TSharedRef<FMCPJob>& Job = Jobs.FindChecked(Id);
+        if (FinishedJobIds.Num() <= MaxFinishedJobs && Job->GetSecondsSinceFinished() <= RetentionSeconds)
+        {
+            break;
+        }
+
+        Job->FinishedNode = nullptr;
+        FinishedJobIds.RemoveNode(Oldest);
+        Jobs.Remove(Id);
+    }
+}
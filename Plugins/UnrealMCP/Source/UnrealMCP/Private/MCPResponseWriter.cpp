@@ -0,0 +1,91 @@
+#include "MCPResponseWriter.h"
+#include "MCPCbor.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Serialization/JsonSerializer.h"
+
+/** Writes condensed UTF-8 JSON through TJsonWriter */
+class FMCPJsonResponseWriter : public FMCPResponseWriter
+{
+public:
+    explicit FMCPJsonResponseWriter(FArchive& Archive)
+        : Writer(FMCPJsonWriterFactory::Create(&Archive))
+    {
+    }
+
+    virtual void WriteObjectStart() override { Writer->WriteObjectStart(); }
+    virtual void WriteObjectStart(FStringView Identifier) override { Writer->WriteObjectStart(Identifier); }
+    virtual void WriteObjectEnd() override { Writer->WriteObjectEnd(); }
+    virtual void WriteArrayStart() override { Writer->WriteArrayStart(); }
+    virtual void WriteArrayStart(FStringView Identifier) override { Writer->WriteArrayStart(Identifier); }
+    virtual void WriteArrayEnd() override { Writer->WriteArrayEnd(); }
+
+    virtual void WriteNumber(double Value) override { Writer->WriteValue(Value); }
+    virtual void WriteNumber(FStringView Identifier, double Value) override { Writer->WriteValue(Identifier, Value); }
+    virtual void WriteString(FStringView Value) override { Writer->WriteValue(Value); }
+    virtual void WriteString(FStringView Identifier, FStringView Value) override { Writer->WriteValue(Identifier, Value); }
+    virtual void WriteBool(FStringView Identifier, bool bValue) override { Writer->WriteValue(Identifier, bValue); }
+
+    virtual void WriteJsonValue(FStringView Identifier, const TSharedPtr<FJsonValue>& Value) override
+    {
+        FJsonSerializer::Serialize(Value, FString(Identifier), Writer, false);
+    }
+
+    virtual void WriteJsonObject(const TSharedPtr<FJsonObject>& Object) override
+    {
+        FJsonSerializer::Serialize(Object.ToSharedRef(), Writer, false);
+    }
+
+    virtual void Close() override { Writer->Close(); }
+
+private:
+    TSharedRef<FMCPJsonWriter> Writer;
+};
+
+/** Writes CBOR; streamed containers use indefinite lengths so nothing has to be counted first */
+class FMCPCborResponseWriter : public FMCPResponseWriter
+{
+public:
+    explicit FMCPCborResponseWriter(FArchive& Archive)
+        : Writer(Archive)
+    {
+    }
+
+    virtual void WriteObjectStart() override { Writer.WriteMapStart(); }
+    virtual void WriteObjectStart(FStringView Identifier) override { Writer.WriteString(Identifier); Writer.WriteMapStart(); }
+    virtual void WriteObjectEnd() override { Writer.WriteBreak(); }
+    virtual void WriteArrayStart() override { Writer.WriteArrayStart(); }
+    virtual void WriteArrayStart(FStringView Identifier) override { Writer.WriteString(Identifier); Writer.WriteArrayStart(); }
+    virtual void WriteArrayEnd() override { Writer.WriteBreak(); }
+
+    virtual void WriteNumber(double Value) override { Writer.WriteNumber(Value); }
+    virtual void WriteNumber(FStringView Identifier, double Value) override { Writer.WriteString(Identifier); Writer.WriteNumber(Value); }
+    virtual void WriteString(FStringView Value) override { Writer.WriteString(Value); }
+    virtual void WriteString(FStringView Identifier, FStringView Value) override { Writer.WriteString(Identifier); Writer.WriteString(Value); }
+    virtual void WriteBool(FStringView Identifier, bool bValue) override { Writer.WriteString(Identifier); Writer.WriteBool(bValue); }
+
+    virtual void WriteJsonValue(FStringView Identifier, const TSharedPtr<FJsonValue>& Value) override
+    {
+        Writer.WriteString(Identifier);
+        Writer.WriteJsonValue(Value);
+    }
+
+    virtual void WriteJsonObject(const TSharedPtr<FJsonObject>& Object) override
+    {
+        Writer.WriteJsonObject(Object);
+    }
+
+    virtual void Close() override {}
+
+private:
+    FMCPCborWriter Writer;
+};
+
+TUniquePtr<FMCPResponseWriter> FMCPResponseWriter::Create(EMCPPayloadEncoding Encoding, FArchive& Archive)
+{
+    if (Encoding == EMCPPayloadEncoding::Cbor)
+    {
+        return MakeUnique<FMCPCborResponseWriter>(Archive);
+    }
+    return MakeUnique<FMCPJsonResponseWriter>(Archive);
+}
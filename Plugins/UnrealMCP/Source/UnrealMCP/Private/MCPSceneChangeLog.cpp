@@ -0,0 +1,86 @@
+#include "MCPSceneChangeLog.h"
+#include "Misc/DateTime.h"
+
+FMCPSceneChangeLog::FMCPSceneChangeLog()
+    : ActorIndex(nullptr)
+    , Capacity(0)
+    , Version(0)
+    , ResyncVersion(0)
+{
+}
+
+FMCPSceneChangeLog::~FMCPSceneChangeLog()
+{
+    if (ActorIndex)
+    {
+        ActorIndex->OnActorChanged().Remove(ActorChangedHandle);
+    }
+}
+
+void FMCPSceneChangeLog::Init(FMCPActorIndex& InActorIndex, int32 InCapacity)
+{
+    check(!ActorIndex);
+    ActorIndex = &InActorIndex;
+    Capacity = InCapacity;
+
+    // Microseconds since the epoch: well within a JSON number's exact range, and past anything a previous session reached
+    Version = (uint64)((FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTicks() / ETimespan::TicksPerMicrosecond);
+    ResyncVersion = Version;
+
+    ActorChangedHandle = ActorIndex->OnActorChanged().AddRaw(this, &FMCPSceneChangeLog::OnActorChanged);
+}
+
+bool FMCPSceneChangeLog::GetChangesSince(uint64 SinceVersion, TArray<FMCPSceneChange>& OutChanges) const
+{
+    if (SinceVersion < ResyncVersion || SinceVersion > Version)
+    {
+        return false;
+    }
+
+    // Versions grow along the log, so the changes wanted are a run at its end
+    int32 First = Changes.Num();
+    while (First > 0 && Changes[First - 1].Version > SinceVersion)
+    {
+        --First;
+    }
+
+    OutChanges.Reserve(OutChanges.Num() + Changes.Num() - First);
+    for (int32 Index = First; Index < Changes.Num(); ++Index)
+    {
+        OutChanges.Add(Changes[Index]);
+    }
+    return true;
+}
+
+void FMCPSceneChangeLog::OnActorChanged(EMCPActorChange Change, AActor* Actor, FName ActorName)
+{
+    ++Version;
+
+    if (Change == EMCPActorChange::Reset)
+    {
+        // Nothing logged for the old world applies any more
+        Changes.Empty();
+        ResyncVersion = Version;
+        return;
+    }
+
+    // A drag or a slider sends the same change over and over; only the latest needs keeping
+    if (!Changes.IsEmpty() && Changes.Last().ActorName == ActorName && Changes.Last().Change == Change)
+    {
+        Changes.Last().Version = Version;
+        Changes.Last().Actor = Actor;
+        return;
+    }
+
+    if (Changes.Num() >= Capacity)
+    {
+        ResyncVersion = Changes.First().Version;
+        Changes.PopFront();
+    }
+
+    FMCPSceneChange& Entry = Changes.Emplace_GetRef();
+    Entry.Version = Version;
+    Entry.Change = Change;
+    Entry.ActorName = ActorName;
+    Entry.Actor = Actor;
+}
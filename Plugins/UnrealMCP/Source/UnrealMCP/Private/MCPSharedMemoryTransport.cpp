@@ -0,0 +1,511 @@
+#include "MCPSharedMemoryTransport.h"
+
+#if MCP_WITH_SHARED_MEMORY
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Segment layout, shared with the Python client (unreal_mcp_server.SharedMemoryStream).
+// Every field has a single writer, so neither side needs atomic read-modify-write on the
+// other's fields; the producer and consumer fields of a ring sit on separate cache lines.
+struct FMCPSharedMemoryRing
+{
+    // Total bytes ever written; written by the producer only
+    alignas(64) volatile int64 Head;
+    // Total bytes ever read; written by the consumer only
+    alignas(64) volatile int64 Tail;
+    // Bumped by the producer after writing; the consumer sleeps on it while the ring is empty
+    alignas(64) volatile int32 DataDoorbell;
+    volatile int32 bConsumerWaiting;
+    // Bumped by the consumer after reading; the producer sleeps on it while the ring is full
+    alignas(64) volatile int32 SpaceDoorbell;
+    volatile int32 bProducerWaiting;
+};
+
+struct FMCPSharedMemoryHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint32 RingCapacity;
+    uint32 Reserved;
+    // Written by the server: the last session it accepted, and whether it is serving it
+    volatile int32 ServerSession;
+    volatile int32 bServerServing;
+    // Written by the client: the session it claims, the session it has detached from, and its pid
+    volatile int32 ClientSession;
+    volatile int32 ClientDetachedSession;
+    volatile int32 ClientProcessId;
+    // Requests flow client -> server, responses server -> client
+    alignas(64) FMCPSharedMemoryRing Requests;
+    FMCPSharedMemoryRing Responses;
+};
+
+static_assert(sizeof(FMCPSharedMemoryRing) == 256, "Ring layout is shared with the client");
+static_assert(sizeof(FMCPSharedMemoryHeader) == 576, "Header layout is shared with the client");
+
+// 'UMCP'
+const uint32 SharedMemoryMagic = 0x50434D55;
+const uint32 SharedMemoryVersion = 1;
+
+// Ring data starts on its own page after the header: requests first, then responses
+const SIZE_T SharedMemoryDataOffset = 4096;
+
+const int32 MinRingCapacity = 64 * 1024;
+const int32 MaxRingCapacity = 256 * 1024 * 1024;
+
+// Polls before sleeping on a doorbell; at high message rates the other side usually answers first
+const int32 DoorbellSpinCount = 64;
+
+// Longest a blocked call sleeps before checking that the client process still exists
+const double LivenessCheckIntervalSeconds = 0.1;
+
+static FMCPSharedMemoryHeader* GetHeader(const FMCPSharedMemorySegment& Segment)
+{
+    return (FMCPSharedMemoryHeader*)Segment.GetBase();
+}
+
+static void FutexWait(volatile int32* Address, int32 ExpectedValue, double TimeoutSeconds)
+{
+    timespec Timeout;
+    Timeout.tv_sec = (time_t)TimeoutSeconds;
+    Timeout.tv_nsec = (long)((TimeoutSeconds - (double)Timeout.tv_sec) * 1e9);
+    syscall(SYS_futex, Address, FUTEX_WAIT, ExpectedValue, &Timeout, nullptr, 0);
+}
+
+static void FutexWake(volatile int32* Address)
+{
+    syscall(SYS_futex, Address, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/** Tells the other side something changed, making the wake-up syscall only if it is asleep */
+static void RingDoorbell(volatile int32* Doorbell, volatile int32* bWaiting)
+{
+    // Full barrier: the ring update is visible before the flag is read
+    FPlatformAtomics::InterlockedIncrement(Doorbell);
+    if (FPlatformAtomics::AtomicRead(bWaiting))
+    {
+        FutexWake(Doorbell);
+    }
+}
+
+/** Waits until Ready() holds, the doorbell rings or the timeout expires; returns Ready() */
+template <typename PredicateType>
+static bool WaitOnDoorbell(volatile int32* Doorbell, volatile int32* bWaiting, double TimeoutSeconds, PredicateType Ready)
+{
+    for (int32 Spin = 0; Spin < DoorbellSpinCount; ++Spin)
+    {
+        if (Ready())
+        {
+            return true;
+        }
+        FPlatformProcess::Yield();
+    }
+
+    // Announce the sleep before the final check; a producer that misses the flag has already
+    // bumped the doorbell, so the futex sees a changed value and returns at once
+    FPlatformAtomics::AtomicStore(bWaiting, 1);
+    const int32 Sequence = FPlatformAtomics::AtomicRead(Doorbell);
+    if (!Ready())
+    {
+        FutexWait(Doorbell, Sequence, TimeoutSeconds);
+    }
+    FPlatformAtomics::AtomicStore(bWaiting, 0);
+    return Ready();
+}
+
+/** Copies between a linear buffer and a ring position, wrapping at the end of the ring */
+static void CopyFromRing(uint8* Dest, const uint8* RingData, int64 Capacity, int64 Position, int64 Count)
+{
+    const int64 Offset = Position & (Capacity - 1);
+    const int64 FirstPart = FMath::Min(Count, Capacity - Offset);
+    FMemory::Memcpy(Dest, RingData + Offset, FirstPart);
+    FMemory::Memcpy(Dest + FirstPart, RingData, Count - FirstPart);
+}
+
+static void CopyToRing(uint8* RingData, const uint8* Source, int64 Capacity, int64 Position, int64 Count)
+{
+    const int64 Offset = Position & (Capacity - 1);
+    const int64 FirstPart = FMath::Min(Count, Capacity - Offset);
+    FMemory::Memcpy(RingData + Offset, Source, FirstPart);
+    FMemory::Memcpy(RingData, Source + FirstPart, Count - FirstPart);
+}
+
+FMCPSharedMemorySegment::FMCPSharedMemorySegment(uint8* InBase, SIZE_T InSize, int64 InRingCapacity)
+    : Base(InBase)
+    , Size(InSize)
+    , RingCapacity(InRingCapacity)
+{
+}
+
+FMCPSharedMemorySegment::~FMCPSharedMemorySegment()
+{
+    munmap(Base, Size);
+}
+
+FMCPSharedMemoryTransport::FMCPSharedMemoryTransport(TSharedRef<FMCPSharedMemorySegment> InSegment, int32 InSession, int32 InClientProcessId)
+    : Segment(InSegment)
+    , Session(InSession)
+    , ClientProcessId(InClientProcessId)
+    , Capacity(InSegment->GetRingCapacity())
+    , RequestTail(0)
+    , ResponseHead(0)
+    , bShutdown(false)
+    , RingAccessCount(0)
+    , bReleased(false)
+{
+}
+
+FMCPSharedMemoryTransport::~FMCPSharedMemoryTransport()
+{
+    Close();
+}
+
+bool FMCPSharedMemoryTransport::IsClientAttached() const
+{
+    return !bShutdown && FPlatformAtomics::AtomicRead(&GetHeader(*Segment)->ClientDetachedSession) != Session;
+}
+
+bool FMCPSharedMemoryTransport::IsClientProcessAlive() const
+{
+    // EPERM still means the process exists
+    return kill(ClientProcessId, 0) == 0 || errno == EPERM;
+}
+
+void FMCPSharedMemoryTransport::HandleCorruptRing(const TCHAR* RingName, int64 Value)
+{
+    UE_LOG(LogTemp, Error, TEXT("MCPSharedMemoryTransport: The client left the %s ring with %lld bytes of a %lld-byte ring, ending session %d"), RingName, Value, Capacity, Session);
+    Shutdown(ESocketShutdownMode::ReadWrite);
+}
+
+bool FMCPSharedMemoryTransport::BeginRingAccess()
+{
+    // Paired with Shutdown: either it sees this call and leaves the release to EndRingAccess,
+    // or this call sees the shutdown and keeps off the rings
+    ++RingAccessCount;
+    if (bShutdown)
+    {
+        EndRingAccess();
+        return false;
+    }
+    return true;
+}
+
+void FMCPSharedMemoryTransport::EndRingAccess()
+{
+    if (--RingAccessCount == 0 && bShutdown)
+    {
+        ReleaseSegment();
+    }
+}
+
+void FMCPSharedMemoryTransport::ReleaseSegment()
+{
+    if (bReleased.Exchange(true))
+    {
+        return;
+    }
+
+    // Only now may a new client claim the segment and reset the rings
+    FMCPSharedMemoryHeader* Header = GetHeader(*Segment);
+    FPlatformAtomics::AtomicStore(&Header->bServerServing, 0);
+    FutexWake(&Header->bServerServing);
+}
+
+bool FMCPSharedMemoryTransport::WaitForRead(FTimespan Timeout)
+{
+    if (!BeginRingAccess())
+    {
+        return true;
+    }
+
+    FMCPSharedMemoryRing& Ring = GetHeader(*Segment)->Requests;
+    const int64 Tail = RequestTail;
+    auto IsReadable = [&Ring, Tail, this]() { return FPlatformAtomics::AtomicRead(&Ring.Head) != Tail || !IsClientAttached(); };
+
+    bool bReadable = true;
+    const double Deadline = FPlatformTime::Seconds() + Timeout.GetTotalSeconds();
+    while (!IsReadable())
+    {
+        const double Remaining = Deadline - FPlatformTime::Seconds();
+        if (Remaining <= 0.0)
+        {
+            bReadable = false;
+            break;
+        }
+        if (!WaitOnDoorbell(&Ring.DataDoorbell, &Ring.bConsumerWaiting, FMath::Min(Remaining, LivenessCheckIntervalSeconds), IsReadable)
+            && !IsClientProcessAlive())
+        {
+            // Report the dead client as end of stream on the next read
+            break;
+        }
+    }
+
+    EndRingAccess();
+    return bReadable;
+}
+
+bool FMCPSharedMemoryTransport::Recv(uint8* Data, int32 Size, int32& BytesRead)
+{
+    BytesRead = 0;
+    if (!BeginRingAccess())
+    {
+        return true;
+    }
+
+    FMCPSharedMemoryRing& Ring = GetHeader(*Segment)->Requests;
+    const uint8* RingData = Segment->GetBase() + SharedMemoryDataOffset;
+
+    bool bSucceeded = true;
+    while (BytesRead < Size)
+    {
+        const int64 Tail = RequestTail;
+        const int64 Available = FPlatformAtomics::AtomicRead(&Ring.Head) - Tail;
+        if (Available < 0 || Available > Capacity)
+        {
+            HandleCorruptRing(TEXT("requests"), Available);
+            bSucceeded = false;
+            break;
+        }
+        if (Available > 0)
+        {
+            const int64 Count = FMath::Min<int64>(Available, Size - BytesRead);
+            CopyFromRing(Data + BytesRead, RingData, Capacity, Tail, Count);
+            RequestTail = Tail + Count;
+            FPlatformAtomics::AtomicStore(&Ring.Tail, RequestTail);
+            RingDoorbell(&Ring.SpaceDoorbell, &Ring.bProducerWaiting);
+            BytesRead += (int32)Count;
+            continue;
+        }
+
+        // Everything the client sent has been read; a detached client is the end of the stream
+        if (!IsClientAttached())
+        {
+            break;
+        }
+
+        auto HasData = [&Ring, Tail, this]() { return FPlatformAtomics::AtomicRead(&Ring.Head) != Tail || !IsClientAttached(); };
+        if (!WaitOnDoorbell(&Ring.DataDoorbell, &Ring.bConsumerWaiting, LivenessCheckIntervalSeconds, HasData) && !IsClientProcessAlive())
+        {
+            break;
+        }
+    }
+
+    EndRingAccess();
+    return bSucceeded;
+}
+
+bool FMCPSharedMemoryTransport::Send(const uint8* Data, int32 Size, int32& BytesSent)
+{
+    BytesSent = 0;
+    if (!BeginRingAccess())
+    {
+        return false;
+    }
+
+    FMCPSharedMemoryRing& Ring = GetHeader(*Segment)->Responses;
+    uint8* RingData = Segment->GetBase() + SharedMemoryDataOffset + Capacity;
+
+    bool bSent = false;
+    while (!bShutdown)
+    {
+        const int64 Head = ResponseHead;
+        const int64 Tail = FPlatformAtomics::AtomicRead(&Ring.Tail);
+        const int64 Used = Head - Tail;
+        if (Used < 0 || Used > Capacity)
+        {
+            HandleCorruptRing(TEXT("responses"), Used);
+            break;
+        }
+        const int64 FreeSpace = Capacity - Used;
+        if (FreeSpace > 0)
+        {
+            const int64 Count = FMath::Min<int64>(FreeSpace, Size);
+            CopyToRing(RingData, Data, Capacity, Head, Count);
+            ResponseHead = Head + Count;
+            FPlatformAtomics::AtomicStore(&Ring.Head, ResponseHead);
+            RingDoorbell(&Ring.DataDoorbell, &Ring.bConsumerWaiting);
+            BytesSent = (int32)Count;
+            bSent = true;
+            break;
+        }
+
+        // The ring is full and nobody will drain it any more
+        if (!IsClientAttached())
+        {
+            break;
+        }
+
+        auto HasSpace = [&Ring, Tail, this]() { return FPlatformAtomics::AtomicRead(&Ring.Tail) != Tail || !IsClientAttached(); };
+        if (!WaitOnDoorbell(&Ring.SpaceDoorbell, &Ring.bProducerWaiting, LivenessCheckIntervalSeconds, HasSpace) && !IsClientProcessAlive())
+        {
+            break;
+        }
+    }
+
+    EndRingAccess();
+    return bSent;
+}
+
+bool FMCPSharedMemoryTransport::IsConnected()
+{
+    return IsClientAttached() && IsClientProcessAlive();
+}
+
+void FMCPSharedMemoryTransport::Shutdown(ESocketShutdownMode Mode)
+{
+    // The rings have no half-close: once either direction is shut down the session is over
+    if (bShutdown.Exchange(true))
+    {
+        return;
+    }
+
+    // Wake every sleeper on both sides so each one notices. This may run on another thread
+    // than the session's, so only doorbells the server owns are bumped.
+    FMCPSharedMemoryHeader* Header = GetHeader(*Segment);
+    FPlatformAtomics::InterlockedIncrement(&Header->Requests.SpaceDoorbell);
+    FPlatformAtomics::InterlockedIncrement(&Header->Responses.DataDoorbell);
+    FutexWake(&Header->Requests.DataDoorbell);
+    FutexWake(&Header->Requests.SpaceDoorbell);
+    FutexWake(&Header->Responses.DataDoorbell);
+    FutexWake(&Header->Responses.SpaceDoorbell);
+
+    // A call still inside Recv or Send hands the segment back as it leaves
+    if (RingAccessCount == 0)
+    {
+        ReleaseSegment();
+    }
+}
+
+void FMCPSharedMemoryTransport::Close()
+{
+    // Frees the segment for the next client once the session thread is done with the rings
+    Shutdown(ESocketShutdownMode::ReadWrite);
+}
+
+TSharedPtr<FMCPSharedMemoryListener> FMCPSharedMemoryListener::Create(const FString& Name, int32 RingCapacity)
+{
+    const FTCHARToUTF8 NameUtf8(*Name);
+    if (NameUtf8.Length() < 2 || NameUtf8.Get()[0] != '/' || FCStringAnsi::Strchr(NameUtf8.Get() + 1, '/') != nullptr)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPSharedMemoryListener: '%s' is not a valid segment name, it must look like /name"), *Name);
+        return nullptr;
+    }
+
+    const int32 Capacity = (int32)FMath::RoundUpToPowerOfTwo(FMath::Clamp(RingCapacity, MinRingCapacity, MaxRingCapacity));
+    const SIZE_T SegmentSize = SharedMemoryDataOffset + 2 * (SIZE_T)Capacity;
+
+    // Replace a segment left behind by an editor that did not shut down cleanly. The segment is
+    // created owner-only, so another user can neither attach to it nor claim its sessions.
+    shm_unlink(NameUtf8.Get());
+    const int FileDescriptor = shm_open(NameUtf8.Get(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (FileDescriptor < 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPSharedMemoryListener: Failed to create segment %s (errno %d)"), *Name, errno);
+        return nullptr;
+    }
+
+    if (ftruncate(FileDescriptor, (off_t)SegmentSize) != 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPSharedMemoryListener: Failed to size segment %s to %llu bytes (errno %d)"), *Name, (uint64)SegmentSize, errno);
+        close(FileDescriptor);
+        shm_unlink(NameUtf8.Get());
+        return nullptr;
+    }
+
+    void* Base = mmap(nullptr, SegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, 0);
+    close(FileDescriptor);
+    if (Base == MAP_FAILED)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPSharedMemoryListener: Failed to map segment %s (errno %d)"), *Name, errno);
+        shm_unlink(NameUtf8.Get());
+        return nullptr;
+    }
+
+    // A fresh segment is zero-filled; only the identification fields need setting
+    FMCPSharedMemoryHeader* Header = (FMCPSharedMemoryHeader*)Base;
+    Header->RingCapacity = (uint32)Capacity;
+    Header->Version = SharedMemoryVersion;
+    FPlatformAtomics::AtomicStore((volatile int32*)&Header->Magic, (int32)SharedMemoryMagic);
+
+    TSharedRef<FMCPSharedMemorySegment> Segment = MakeShared<FMCPSharedMemorySegment>((uint8*)Base, SegmentSize, Capacity);
+    return TSharedPtr<FMCPSharedMemoryListener>(new FMCPSharedMemoryListener(Segment, Name));
+}
+
+FMCPSharedMemoryListener::FMCPSharedMemoryListener(TSharedRef<FMCPSharedMemorySegment> InSegment, const FString& InName)
+    : Segment(InSegment)
+    , Name(InName)
+    , bStopped(false)
+{
+}
+
+FMCPSharedMemoryListener::~FMCPSharedMemoryListener()
+{
+    Stop();
+}
+
+bool FMCPSharedMemoryListener::WaitForConnection(FTimespan Timeout)
+{
+    FMCPSharedMemoryHeader* Header = GetHeader(*Segment);
+    auto HasClaim = [Header, this]()
+    {
+        return !bStopped
+            && !FPlatformAtomics::AtomicRead(&Header->bServerServing)
+            && FPlatformAtomics::AtomicRead(&Header->ClientSession) != FPlatformAtomics::AtomicRead(&Header->ServerSession);
+    };
+
+    // Clients claim the segment by bumping ClientSession and waking this futex
+    const int32 ClaimedSession = FPlatformAtomics::AtomicRead(&Header->ClientSession);
+    if (!HasClaim() && !bStopped)
+    {
+        FutexWait(&Header->ClientSession, ClaimedSession, Timeout.GetTotalSeconds());
+    }
+    return HasClaim();
+}
+
+TSharedPtr<FMCPTransport> FMCPSharedMemoryListener::Accept()
+{
+    FMCPSharedMemoryHeader* Header = GetHeader(*Segment);
+    if (FPlatformAtomics::AtomicRead(&Header->bServerServing))
+    {
+        return nullptr;
+    }
+
+    const int32 Session = FPlatformAtomics::AtomicRead(&Header->ClientSession);
+    const int32 ClientProcessId = FPlatformAtomics::AtomicRead(&Header->ClientProcessId);
+    if (Session == FPlatformAtomics::AtomicRead(&Header->ServerSession))
+    {
+        return nullptr;
+    }
+
+    // The client reset the rings before claiming; tell it the session is live
+    FPlatformAtomics::AtomicStore(&Header->ServerSession, Session);
+    FPlatformAtomics::AtomicStore(&Header->bServerServing, 1);
+    FutexWake(&Header->bServerServing);
+
+    return MakeShared<FMCPSharedMemoryTransport>(Segment, Session, ClientProcessId);
+}
+
+void FMCPSharedMemoryListener::Stop()
+{
+    if (bStopped.Exchange(true))
+    {
+        return;
+    }
+
+    // New clients can no longer find the segment; the mapping stays valid until the last
+    // session using it has closed
+    shm_unlink(TCHAR_TO_UTF8(*Name));
+    FutexWake(&GetHeader(*Segment)->ClientSession);
+}
+
+#endif
@@ -0,0 +1,318 @@
+#include "MCPTransport.h"
+#include "Sockets.h"
+
+#if MCP_WITH_UNIX_SOCKETS
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Kernel buffer size requested for accepted TCP clients
+const int32 SocketBufferSize = 65536;
+
+FMCPSocketTransport::FMCPSocketTransport(TSharedPtr<FSocket> InSocket)
+    : Socket(InSocket)
+{
+}
+
+bool FMCPSocketTransport::WaitForRead(FTimespan Timeout)
+{
+    return Socket->Wait(ESocketWaitConditions::WaitForRead, Timeout);
+}
+
+bool FMCPSocketTransport::Recv(uint8* Data, int32 Size, int32& BytesRead)
+{
+    return Socket->Recv(Data, Size, BytesRead, ESocketReceiveFlags::WaitAll);
+}
+
+bool FMCPSocketTransport::Send(const uint8* Data, int32 Size, int32& BytesSent)
+{
+    return Socket->Send(Data, Size, BytesSent);
+}
+
+bool FMCPSocketTransport::IsConnected()
+{
+    return Socket.IsValid() && Socket->GetConnectionState() == ESocketConnectionState::SCS_Connected;
+}
+
+void FMCPSocketTransport::Shutdown(ESocketShutdownMode Mode)
+{
+    Socket->Shutdown(Mode);
+}
+
+void FMCPSocketTransport::Close()
+{
+    Socket->Close();
+}
+
+FMCPSocketListener::FMCPSocketListener(TSharedPtr<FSocket> InListenerSocket, const FString& InDescription)
+    : ListenerSocket(InListenerSocket)
+    , Description(InDescription)
+{
+}
+
+bool FMCPSocketListener::WaitForConnection(FTimespan Timeout)
+{
+    return ListenerSocket->Wait(ESocketWaitConditions::WaitForRead, Timeout);
+}
+
+TSharedPtr<FMCPTransport> FMCPSocketListener::Accept()
+{
+    FSocket* AcceptedSocket = ListenerSocket->Accept(TEXT("MCPClient"));
+    if (!AcceptedSocket)
+    {
+        return nullptr;
+    }
+
+    // Wrap in a TSharedPtr for automatic memory management
+    TSharedPtr<FSocket> ClientSocket = MakeShareable(AcceptedSocket);
+
+    // Set socket to blocking mode for reliable communication
+    ClientSocket->SetNonBlocking(false);
+
+    // Set socket options to improve connection stability
+    int32 ActualSize = 0;
+    ClientSocket->SetNoDelay(true);
+    ClientSocket->SetSendBufferSize(SocketBufferSize, ActualSize);
+    ClientSocket->SetReceiveBufferSize(SocketBufferSize, ActualSize);
+
+    return MakeShared<FMCPSocketTransport>(ClientSocket);
+}
+
+void FMCPSocketListener::Stop()
+{
+    // Shutting the listener down wakes the thread blocked waiting for a connection
+    ListenerSocket->Shutdown(ESocketShutdownMode::ReadWrite);
+    ListenerSocket->Close();
+}
+
+#if MCP_WITH_UNIX_SOCKETS
+
+/** Polls a descriptor for readability, retrying when interrupted by a signal */
+static bool PollForRead(int32 FileDescriptor, FTimespan Timeout)
+{
+    if (FileDescriptor < 0)
+    {
+        return false;
+    }
+
+    pollfd PollDescriptor;
+    PollDescriptor.fd = FileDescriptor;
+    PollDescriptor.events = POLLIN;
+    PollDescriptor.revents = 0;
+
+    int Result;
+    do
+    {
+        Result = poll(&PollDescriptor, 1, (int)Timeout.GetTotalMilliseconds());
+    }
+    while (Result < 0 && errno == EINTR);
+
+    // Hang-up and error count as readable so the next read reports them
+    return Result > 0;
+}
+
+/** Keeps the descriptor from leaking into processes the editor spawns */
+static void SetCloseOnExec(int32 FileDescriptor)
+{
+    fcntl(FileDescriptor, F_SETFD, fcntl(FileDescriptor, F_GETFD) | FD_CLOEXEC);
+}
+
+FMCPUnixSocketTransport::FMCPUnixSocketTransport(int32 InFileDescriptor)
+    : FileDescriptor(InFileDescriptor)
+{
+    SetCloseOnExec(InFileDescriptor);
+#if PLATFORM_MAC
+    // macOS has no MSG_NOSIGNAL; a write to a closed peer must fail instead of raising SIGPIPE
+    int NoSigPipe = 1;
+    setsockopt(InFileDescriptor, SOL_SOCKET, SO_NOSIGPIPE, &NoSigPipe, sizeof(NoSigPipe));
+#endif
+}
+
+FMCPUnixSocketTransport::~FMCPUnixSocketTransport()
+{
+    Close();
+}
+
+bool FMCPUnixSocketTransport::WaitForRead(FTimespan Timeout)
+{
+    return PollForRead(FileDescriptor, Timeout);
+}
+
+bool FMCPUnixSocketTransport::Recv(uint8* Data, int32 Size, int32& BytesRead)
+{
+    BytesRead = 0;
+    ssize_t Result;
+    do
+    {
+        Result = recv(FileDescriptor, Data, Size, MSG_WAITALL);
+    }
+    while (Result < 0 && errno == EINTR);
+
+    if (Result < 0)
+    {
+        return false;
+    }
+    BytesRead = (int32)Result;
+    return true;
+}
+
+bool FMCPUnixSocketTransport::Send(const uint8* Data, int32 Size, int32& BytesSent)
+{
+#ifdef MSG_NOSIGNAL
+    const int Flags = MSG_NOSIGNAL;
+#else
+    const int Flags = 0;
+#endif
+
+    BytesSent = 0;
+    ssize_t Result;
+    do
+    {
+        Result = send(FileDescriptor, Data, Size, Flags);
+    }
+    while (Result < 0 && errno == EINTR);
+
+    if (Result < 0)
+    {
+        return false;
+    }
+    BytesSent = (int32)Result;
+    return true;
+}
+
+bool FMCPUnixSocketTransport::IsConnected()
+{
+    // A closed peer shows up as end of stream on the next read
+    return FileDescriptor >= 0;
+}
+
+void FMCPUnixSocketTransport::Shutdown(ESocketShutdownMode Mode)
+{
+    const int How = Mode == ESocketShutdownMode::Read ? SHUT_RD : (Mode == ESocketShutdownMode::Write ? SHUT_WR : SHUT_RDWR);
+    shutdown(FileDescriptor, How);
+}
+
+void FMCPUnixSocketTransport::Close()
+{
+    const int32 OldFileDescriptor = FileDescriptor.Exchange(-1);
+    if (OldFileDescriptor >= 0)
+    {
+        close(OldFileDescriptor);
+    }
+}
+
+TSharedPtr<FMCPUnixSocketListener> FMCPUnixSocketListener::Create(const FString& Path, int32 Backlog)
+{
+    const FTCHARToUTF8 PathUtf8(*Path);
+
+    sockaddr_un Address;
+    FMemory::Memzero(Address);
+    Address.sun_family = AF_UNIX;
+    if (PathUtf8.Length() <= 0 || PathUtf8.Length() >= (int32)sizeof(Address.sun_path))
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPUnixSocketListener: Socket path '%s' is empty or longer than %d bytes"), *Path, (int32)sizeof(Address.sun_path) - 1);
+        return nullptr;
+    }
+    FMemory::Memcpy(Address.sun_path, PathUtf8.Get(), PathUtf8.Length());
+
+    // A socket file left behind by an editor that did not shut down cleanly blocks bind;
+    // only ever remove sockets, never a regular file that happens to sit at the path
+    struct stat PathStat;
+    if (lstat(Address.sun_path, &PathStat) == 0)
+    {
+        if (!S_ISSOCK(PathStat.st_mode))
+        {
+            UE_LOG(LogTemp, Error, TEXT("MCPUnixSocketListener: '%s' exists and is not a socket"), *Path);
+            return nullptr;
+        }
+        unlink(Address.sun_path);
+    }
+
+    const int32 FileDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (FileDescriptor < 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPUnixSocketListener: Failed to create socket (errno %d)"), errno);
+        return nullptr;
+    }
+    SetCloseOnExec(FileDescriptor);
+
+    // Create the socket file owner-only from the start so there is no window where
+    // another user could connect; the umask is process-wide, so restore it at once
+    const mode_t PreviousMask = umask(0177);
+    const int BindResult = bind(FileDescriptor, (const sockaddr*)&Address, sizeof(Address));
+    umask(PreviousMask);
+
+    if (BindResult != 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPUnixSocketListener: Failed to bind '%s' (errno %d)"), *Path, errno);
+        close(FileDescriptor);
+        return nullptr;
+    }
+
+    // Connecting needs write permission on the socket file, so this limits clients to the editor's user
+    chmod(Address.sun_path, S_IRUSR | S_IWUSR);
+
+    if (listen(FileDescriptor, Backlog) != 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("MCPUnixSocketListener: Failed to listen on '%s' (errno %d)"), *Path, errno);
+        close(FileDescriptor);
+        unlink(Address.sun_path);
+        return nullptr;
+    }
+
+    return TSharedPtr<FMCPUnixSocketListener>(new FMCPUnixSocketListener(FileDescriptor, Path));
+}
+
+FMCPUnixSocketListener::FMCPUnixSocketListener(int32 InFileDescriptor, const FString& InPath)
+    : FileDescriptor(InFileDescriptor)
+    , Path(InPath)
+    , bStopped(false)
+{
+}
+
+FMCPUnixSocketListener::~FMCPUnixSocketListener()
+{
+    Stop();
+    close(FileDescriptor);
+}
+
+bool FMCPUnixSocketListener::WaitForConnection(FTimespan Timeout)
+{
+    return !bStopped && PollForRead(FileDescriptor, Timeout);
+}
+
+TSharedPtr<FMCPTransport> FMCPUnixSocketListener::Accept()
+{
+    int32 ClientFileDescriptor;
+    do
+    {
+        ClientFileDescriptor = accept(FileDescriptor, nullptr, nullptr);
+    }
+    while (ClientFileDescriptor < 0 && errno == EINTR);
+
+    if (ClientFileDescriptor < 0)
+    {
+        return nullptr;
+    }
+    return MakeShared<FMCPUnixSocketTransport>(ClientFileDescriptor);
+}
+
+void FMCPUnixSocketListener::Stop()
+{
+    if (bStopped.Exchange(true))
+    {
+        return;
+    }
+
+    // Remove the path first so no new client can find us, then wake the accept thread.
+    // The descriptor itself stays open until the accept thread is gone.
+    unlink(TCHAR_TO_UTF8(*Path));
+    shutdown(FileDescriptor, SHUT_RDWR);
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MCPActorIndex.h"
+#include "Editor.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+namespace MCPActorSearchTest
+{
+    const TCHAR* const ActorNames[] = { TEXT("MCPSearchTest_Wall_13"), TEXT("MCPSearchTest_Wall_7"), TEXT("MCPSearchTest_Door_2") };
+
+    /** Names of the test's actors that match Pattern as a regular expression, sorted */
+    static FString SearchTestActors(FMCPActorIndex& Index, const FString& Pattern)
+    {
+        TArray<FMCPActorSearchMatch> Matches;
+        Index.SearchActors(Pattern, EMCPActorSearchMode::Regex, ESearchCase::CaseSensitive, Matches);
+
+        TArray<FString> Names;
+        for (const FMCPActorSearchMatch& Match : Matches)
+        {
+            const FString Name = Match.Actor->GetName();
+            if (Name.StartsWith(TEXT("MCPSearchTest_")))
+            {
+                Names.Add(Name);
+            }
+        }
+        Names.Sort();
+        return FString::Join(Names, TEXT(","));
+    }
+}
+
+/**
+ * Regex search only compares actors holding the trigrams of the pattern's literal text. Text
+ * that a match need not contain (quantifier counts, optional characters, alternatives) must not
+ * be taken for it, or actors that match are never compared.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMCPActorSearchTest, "UnrealMCP.ActorSearch.RegexLiterals",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FMCPActorSearchTest::RunTest(const FString& Parameters)
+{
+    using namespace MCPActorSearchTest;
+
+    UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+    if (!TestNotNull(TEXT("Editor world"), World))
+    {
+        return false;
+    }
+
+    TArray<AActor*> Actors;
+    for (const TCHAR* Name : ActorNames)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.Name = Name;
+        SpawnParams.ObjectFlags = RF_Transient;
+        SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Required_ReturnNull;
+        if (AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams))
+        {
+            Actors.Add(Actor);
+        }
+    }
+
+    if (TestEqual(TEXT("Spawned the test actors"), Actors.Num(), (int32)UE_ARRAY_COUNT(ActorNames)))
+    {
+        // Built after the spawns, so it holds the actors without depending on editor events
+        FMCPActorIndex Index;
+        TestEqual(TEXT("Counted quantifier"), SearchTestActors(Index, TEXT("Wall_\\d{2}")), FString(TEXT("MCPSearchTest_Wall_13")));
+        TestEqual(TEXT("Counted quantifier with a range"), SearchTestActors(Index, TEXT("Wall_\\d{1,2}$")), FString(TEXT("MCPSearchTest_Wall_13,MCPSearchTest_Wall_7")));
+        TestEqual(TEXT("Literal repeated by a quantifier"), SearchTestActors(Index, TEXT("Wall_1{1}3")), FString(TEXT("MCPSearchTest_Wall_13")));
+        TestEqual(TEXT("Character repeated zero or more times"), SearchTestActors(Index, TEXT("Wallx{0,2}_13")), FString(TEXT("MCPSearchTest_Wall_13")));
+        TestEqual(TEXT("Optional character"), SearchTestActors(Index, TEXT("MCPSearchTest_Wall_1?7")), FString(TEXT("MCPSearchTest_Wall_7")));
+        TestEqual(TEXT("Starred character"), SearchTestActors(Index, TEXT("MCPSearchTest_Wall_x*13")), FString(TEXT("MCPSearchTest_Wall_13")));
+        TestEqual(TEXT("Alternation"), SearchTestActors(Index, TEXT("MCPSearchTest_Wall_7|MCPSearchTest_Door")), FString(TEXT("MCPSearchTest_Door_2,MCPSearchTest_Wall_7")));
+        TestEqual(TEXT("Alternation in a group"), SearchTestActors(Index, TEXT("MCPSearchTest_(Wall|Door)_\\d$")), FString(TEXT("MCPSearchTest_Door_2,MCPSearchTest_Wall_7")));
+    }
+
+    for (AActor* Actor : Actors)
+    {
+        World->EditorDestroyActor(Actor, false);
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "UnrealMCPBridge.h"
+#include "MCPTransport.h"
+#include "Editor.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace MCPAnyThreadCommandsTest
+{
+    const int32 NumQueries = 1000;
+    // Below the session's limit for pipelined reads, so the session never stops reading while
+    // this thread is busy sending, and the responses in flight always fit the socket buffers
+    const int32 MaxInFlight = 32;
+    const double TimeoutSeconds = 60.0;
+
+    static bool SendRequest(FMCPTransport& Transport, int32 Id)
+    {
+        TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+        Params->SetStringField(TEXT("path"), TEXT("/Engine/BasicShapes"));
+        TSharedPtr<FJsonObject> Request = MakeShared<FJsonObject>();
+        Request->SetStringField(TEXT("command"), TEXT("find_assets"));
+        Request->SetObjectField(TEXT("params"), Params);
+        Request->SetNumberField(TEXT("id"), Id);
+
+        FString Json;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+        FJsonSerializer::Serialize(Request.ToSharedRef(), Writer);
+        FTCHARToUTF8 Utf8(*Json);
+
+        // One frame: 4-byte little-endian length, then the payload
+        TArray<uint8> Frame;
+        const uint32 Length = (uint32)Utf8.Length();
+        Frame.Append((const uint8*)&Length, sizeof(Length));
+        Frame.Append((const uint8*)Utf8.Get(), Utf8.Length());
+
+        int32 Offset = 0;
+        while (Offset < Frame.Num())
+        {
+            int32 BytesSent = 0;
+            if (!Transport.Send(Frame.GetData() + Offset, Frame.Num() - Offset, BytesSent))
+            {
+                return false;
+            }
+            Offset += BytesSent;
+        }
+        return true;
+    }
+
+    /** Reads one single-frame response; the session only chunks responses after 'hello' */
+    static TSharedPtr<FJsonObject> ReceiveResponse(FMCPTransport& Transport, double Deadline)
+    {
+        const FTimespan Timeout = FTimespan::FromSeconds(FMath::Max(0.0, Deadline - FPlatformTime::Seconds()));
+        uint32 Header = 0;
+        int32 BytesRead = 0;
+        if (!Transport.WaitForRead(Timeout) || !Transport.Recv((uint8*)&Header, sizeof(Header), BytesRead) || BytesRead != sizeof(Header))
+        {
+            return nullptr;
+        }
+
+        TArray<uint8> Payload;
+        Payload.SetNumUninitialized(Header & 0x3FFFFFFF);
+        if (!Transport.Recv(Payload.GetData(), Payload.Num(), BytesRead) || BytesRead != Payload.Num())
+        {
+            return nullptr;
+        }
+
+        TSharedPtr<FJsonObject> Response;
+        FUTF8ToTCHAR Converter((const ANSICHAR*)Payload.GetData(), Payload.Num());
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FString(Converter.Length(), Converter.Get()));
+        return FJsonSerializer::Deserialize(Reader, Response) ? Response : nullptr;
+    }
+}
+
+/**
+ * Pipelines many find_assets queries to the running MCP server over TCP while the test keeps the
+ * game thread blocked, so every one of them has to be answered by the session and its request
+ * workers alone. A query that needed the game thread would never come back within the timeout.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMCPAnyThreadCommandsTest, "UnrealMCP.AnyThreadCommands",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FMCPAnyThreadCommandsTest::RunTest(const FString& Parameters)
+{
+    using namespace MCPAnyThreadCommandsTest;
+
+    UUnrealMCPBridge* Bridge = GEditor ? GEditor->GetEditorSubsystem<UUnrealMCPBridge>() : nullptr;
+    if (!TestTrue(TEXT("The MCP server is running"), Bridge && Bridge->IsRunning()))
+    {
+        return false;
+    }
+
+    const FMCPCommandInfo* Command = Bridge->GetCommandRegistry().Find(TEXT("find_assets"));
+    if (!TestTrue(TEXT("find_assets is an any-thread command"), Command && !Command->bGameThread))
+    {
+        return false;
+    }
+
+    ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+    TSharedPtr<FSocket> Socket = MakeShareable(SocketSubsystem->CreateSocket(NAME_Stream, TEXT("UnrealMCPTestClient"), false), [SocketSubsystem](FSocket* InSocket)
+    {
+        SocketSubsystem->DestroySocket(InSocket);
+    });
+    if (!TestTrue(TEXT("Connected to the MCP server"), Socket.IsValid() && Socket->Connect(*Bridge->GetServerEndpoint().ToInternetAddr())))
+    {
+        return false;
+    }
+    FMCPSocketTransport Transport(Socket);
+
+    int32 Sent = 0;
+    int32 Succeeded = 0;
+    int32 Failed = 0;
+    TArray<double> SentAt;
+    TArray<double> LatenciesMs;
+    SentAt.SetNumZeroed(NumQueries);
+
+    const double StartTime = FPlatformTime::Seconds();
+    const double Deadline = StartTime + TimeoutSeconds;
+    while (Succeeded + Failed < NumQueries)
+    {
+        while (Sent < NumQueries && Sent - Succeeded - Failed < MaxInFlight)
+        {
+            SentAt[Sent] = FPlatformTime::Seconds();
+            if (!SendRequest(Transport, Sent))
+            {
+                AddError(FString::Printf(TEXT("Sending query %d failed"), Sent));
+                return false;
+            }
+            ++Sent;
+        }
+
+        const TSharedPtr<FJsonObject> Response = ReceiveResponse(Transport, Deadline);
+        if (!Response.IsValid())
+        {
+            AddError(FString::Printf(TEXT("%d of %d queries unanswered after %.0f s with the game thread blocked"), NumQueries - Succeeded - Failed, NumQueries, TimeoutSeconds));
+            return false;
+        }
+
+        const int32 Id = (int32)Response->GetNumberField(TEXT("id"));
+        if (SentAt.IsValidIndex(Id))
+        {
+            LatenciesMs.Add((FPlatformTime::Seconds() - SentAt[Id]) * 1000.0);
+        }
+        if (Response->GetStringField(TEXT("status")) == TEXT("success"))
+        {
+            ++Succeeded;
+        }
+        else
+        {
+            ++Failed;
+            AddError(FString::Printf(TEXT("Query %d failed: %s"), Id, *Response->GetStringField(TEXT("error"))));
+        }
+    }
+    const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+    LatenciesMs.Sort();
+    AddInfo(FString::Printf(TEXT("%d find_assets queries with the game thread blocked: %.1f ms total, %.0f queries/s, latency median %.2f ms, max %.2f ms"),
+        NumQueries, ElapsedSeconds * 1000.0, NumQueries / ElapsedSeconds, LatenciesMs[LatenciesMs.Num() / 2], LatenciesMs.Last()));
+
+    return Failed == 0;
+}
+
+#endif
@@ -1,8 +1,13 @@
 #include "UnrealMCPBridge.h"
 #include "MCPServerRunnable.h"
+#include "MCPConnectionManager.h"
+#include "MCPTransport.h"
+#include "MCPSharedMemoryTransport.h"
 #include "Sockets.h"
 #include "SocketSubsystem.h"
 #include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "Interfaces/IPv4/IPv4Address.h"
 #include "Interfaces/IPv4/IPv4Endpoint.h"
 #include "Dom/JsonObject.h"
@@ -21,7 +26,6 @@
 #include "GameFramework/Actor.h"
 #include "Engine/Selection.h"
 #include "Kismet/GameplayStatics.h"
-#include "Async/Async.h"
 // Add Blueprint related includes
 #include "Engine/Blueprint.h"
 #include "Engine/BlueprintGeneratedClass.h"
@@ -57,18 +61,137 @@
 #include "Commands/UnrealMCPProjectCommands.h"
 #include "Commands/UnrealMCPCommonUtils.h"
 #include "Commands/UnrealMCPUMGCommands.h"
+#include "MCPCommandRegistry.h"
+#include "ScopedTransaction.h"
 
 // Default settings
 #define MCP_SERVER_HOST "127.0.0.1"
 #define MCP_SERVER_PORT 55557
+#define MCP_SERVER_LISTEN_BACKLOG 16
+#define MCP_MAX_CLIENT_CONNECTIONS 16
+#define MCP_REQUEST_WORKER_THREADS 8
+// Separate workers for control and interactive reads, so they never wait behind long commands.
+// Any-thread reads run on these workers themselves, so there are enough to keep several going.
+#define MCP_INTERACTIVE_WORKER_THREADS 4
+// Used when the editor is started with -MCPUnixSocket; -MCPUnixSocket=<path> picks another path
+#define MCP_UNIX_SOCKET_PATH "/tmp/unreal-mcp.sock"
+// Used when the editor is started with -MCPSharedMemory; -MCPSharedMemory=/<name> picks another segment
+#define MCP_SHARED_MEMORY_NAME "/unreal-mcp"
+#define MCP_SHARED_MEMORY_RING_SIZE (4 * 1024 * 1024)
+// Most sub-commands one batch may hold, so a single request cannot hold the game thread indefinitely
+#define MCP_MAX_BATCH_COMMANDS 1000
+// How long a worker waits for a whole batch
+#define MCP_BATCH_TIMEOUT_SECONDS 60.0f
+// How long a finished job's result is kept for get_job_status, and how many finished jobs at most
+#define MCP_JOB_RETENTION_SECONDS 300.0
+#define MCP_MAX_FINISHED_JOBS 256
+// Longest a get_job_status call may wait for its job
+#define MCP_JOB_MAX_WAIT_SECONDS 30.0f
+// Most actor changes kept for get_scene_changes_since; clients further behind must resync
+#define MCP_SCENE_CHANGE_LOG_CAPACITY 16384
 
 UUnrealMCPBridge::UUnrealMCPBridge()
 {
-    EditorCommands = MakeShared<FUnrealMCPEditorCommands>();
+    EditorCommands = MakeShared<FUnrealMCPEditorCommands>(ActorIndex, SceneChanges);
     BlueprintCommands = MakeShared<FUnrealMCPBlueprintCommands>();
     BlueprintNodeCommands = MakeShared<FUnrealMCPBlueprintNodeCommands>();
     ProjectCommands = MakeShared<FUnrealMCPProjectCommands>();
     UMGCommands = MakeShared<FUnrealMCPUMGCommands>();
+
+    // Ping doesn't access Unreal Engine APIs, so it's answered on the worker thread
+    CommandRegistry.Register(TEXT("ping"), [](const TSharedPtr<FJsonObject>& Params)
+    {
+        TSharedPtr<FJsonObject> ResultJson = MakeShareable(new FJsonObject);
+        ResultJson->SetStringField(TEXT("message"), TEXT("pong"));
+        return ResultJson;
+    })
+        .AnyThread()
+        .ReadOnly()
+        .Priority(EMCPCommandPriority::Control);
+
+    // Echo returns its params unchanged; used to exercise the transport with large payloads
+    CommandRegistry.Register(TEXT("echo"), [](const TSharedPtr<FJsonObject>& Params)
+    {
+        return Params.IsValid() ? Params : MakeShared<FJsonObject>();
+    })
+        .AnyThread()
+        .ReadOnly()
+        .Streamed([](const TSharedPtr<FJsonObject>& Params, FString& OutError) -> FMCPResultWriter
+        {
+            // The params DOM is written out as is rather than copied into a response object
+            TSharedPtr<FJsonObject> EchoParams = Params.IsValid() ? Params : MakeShared<FJsonObject>();
+            return [EchoParams](FMCPResponseWriter& Writer)
+            {
+                for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : EchoParams->Values)
+                {
+                    Writer.WriteJsonValue(Field.Key, Field.Value);
+                }
+            };
+        });
+
+    // Game-thread queue depth and frame budget overruns, answered without waiting for the queue
+    CommandRegistry.Register(TEXT("get_queue_stats"), [this](const TSharedPtr<FJsonObject>& Params)
+    {
+        const FMCPGameThreadQueueStats Stats = GameThreadQueue.GetStats();
+        TSharedPtr<FJsonObject> ResultJson = MakeShared<FJsonObject>();
+        ResultJson->SetNumberField(TEXT("depth"), Stats.Depth);
+        ResultJson->SetNumberField(TEXT("peak_depth"), Stats.PeakDepth);
+        ResultJson->SetNumberField(TEXT("budget_ms"), Stats.BudgetMs);
+        ResultJson->SetNumberField(TEXT("items_run"), (double)Stats.ItemsRun);
+        ResultJson->SetNumberField(TEXT("busy_frames"), (double)Stats.BusyFrames);
+        ResultJson->SetNumberField(TEXT("overrun_frames"), (double)Stats.OverrunFrames);
+        ResultJson->SetNumberField(TEXT("last_frame_ms"), Stats.LastFrameMs);
+        ResultJson->SetNumberField(TEXT("max_frame_ms"), Stats.MaxFrameMs);
+        ResultJson->SetNumberField(TEXT("max_overrun_ms"), Stats.MaxOverrunMs);
+        ResultJson->SetNumberField(TEXT("total_overrun_ms"), Stats.TotalOverrunMs);
+
+        TSharedPtr<FJsonObject> LanesJson = MakeShared<FJsonObject>();
+        for (int32 Lane = 0; Lane < (int32)EMCPCommandPriority::Num; ++Lane)
+        {
+            const FMCPGameThreadLaneStats& LaneStats = Stats.Lanes[Lane];
+            TSharedPtr<FJsonObject> LaneJson = MakeShared<FJsonObject>();
+            LaneJson->SetNumberField(TEXT("depth"), LaneStats.Depth);
+            LaneJson->SetNumberField(TEXT("peak_depth"), LaneStats.PeakDepth);
+            LaneJson->SetNumberField(TEXT("max_depth"), LaneStats.MaxDepth);
+            LaneJson->SetNumberField(TEXT("items_run"), (double)LaneStats.ItemsRun);
+            LaneJson->SetNumberField(TEXT("items_rejected"), (double)LaneStats.ItemsRejected);
+            LaneJson->SetNumberField(TEXT("last_wait_ms"), LaneStats.LastWaitMs);
+            LaneJson->SetNumberField(TEXT("max_wait_ms"), LaneStats.MaxWaitMs);
+            LanesJson->SetObjectField(LexToString((EMCPCommandPriority)Lane), LaneJson);
+        }
+        ResultJson->SetObjectField(TEXT("lanes"), LanesJson);
+        return ResultJson;
+    })
+        .AnyThread()
+        .ReadOnly()
+        .Priority(EMCPCommandPriority::Control);
+
+    // Many commands in one game-thread hop; see HandleBatch
+    CommandRegistry.Register(TEXT("batch"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleBatch(Params); })
+        .Timeout(MCP_BATCH_TIMEOUT_SECONDS)
+        .Priority(EMCPCommandPriority::Bulk)
+        .Require(TEXT("commands"), EJson::Array);
+
+    // Jobs: long commands run in the background and are polled for; see StartJob
+    CommandRegistry.Register(TEXT("start_job"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleStartJob(Params); })
+        .AnyThread()
+        .Require(TEXT("command"));
+    // It may wait for its job, so it is kept off the interactive workers
+    CommandRegistry.Register(TEXT("get_job_status"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleGetJobStatus(Params); })
+        .AnyThread()
+        .ReadOnly()
+        .Priority(EMCPCommandPriority::Mutation)
+        .Require(TEXT("job_id"));
+    CommandRegistry.Register(TEXT("cancel_job"), [this](const TSharedPtr<FJsonObject>& Params) { return HandleCancelJob(Params); })
+        .AnyThread()
+        .Priority(EMCPCommandPriority::Control)
+        .Require(TEXT("job_id"));
+
+    EditorCommands->RegisterCommands(CommandRegistry);
+    BlueprintCommands->RegisterCommands(CommandRegistry);
+    BlueprintNodeCommands->RegisterCommands(CommandRegistry);
+    ProjectCommands->RegisterCommands(CommandRegistry);
+    UMGCommands->RegisterCommands(CommandRegistry);
 }
 
 UUnrealMCPBridge::~UUnrealMCPBridge()
@@ -89,8 +212,13 @@ void UUnrealMCPBridge::Initialize(FSubsystemCollectionBase& Collection)
     ListenerSocket = nullptr;
     ConnectionSocket = nullptr;
     ServerThread = nullptr;
+    ServerRunnable = nullptr;
+    ConnectionManager = nullptr;
     Port = MCP_SERVER_PORT;
     FIPv4Address::Parse(MCP_SERVER_HOST, ServerAddress);
+    JobManager.Init(MCP_JOB_RETENTION_SECONDS, MCP_MAX_FINISHED_JOBS);
+    SceneChanges.Init(ActorIndex, MCP_SCENE_CHANGE_LOG_CAPACITY);
+    EventHub.Init(ActorIndex, SceneChanges);
 
     // Start the server automatically
     StartServer();
@@ -101,6 +229,7 @@ void UUnrealMCPBridge::Deinitialize()
 {
     UE_LOG(LogTemp, Display, TEXT("UnrealMCPBridge: Shutting down"));
     StopServer();
+    ActorIndex.Reset();
 }
 
 // Start the MCP server
@@ -141,19 +270,24 @@ void UUnrealMCPBridge::StartServer()
     }
 
     // Start listening
-    if (!NewListenerSocket->Listen(5))
+    if (!NewListenerSocket->Listen(MCP_SERVER_LISTEN_BACKLOG))
     {
         UE_LOG(LogTemp, Error, TEXT("UnrealMCPBridge: Failed to start listening"));
         return;
     }
 
     ListenerSocket = NewListenerSocket;
+    ConnectionManager = MakeShared<FMCPConnectionManager>(this, MCP_MAX_CLIENT_CONNECTIONS, MCP_REQUEST_WORKER_THREADS, MCP_INTERACTIVE_WORKER_THREADS);
+    GameThreadQueue.Start();
+    EventHub.Start();
     bIsRunning = true;
     UE_LOG(LogTemp, Display, TEXT("UnrealMCPBridge: Server started on %s:%d"), *ServerAddress.ToString(), Port);
 
     // Start server thread
+    const FString TcpDescription = FString::Printf(TEXT("%s:%d"), *ServerAddress.ToString(), Port);
+    ServerRunnable = new FMCPServerRunnable(this, MakeShared<FMCPSocketListener>(ListenerSocket, TcpDescription), ConnectionManager);
     ServerThread = FRunnableThread::Create(
-        new FMCPServerRunnable(this, ListenerSocket),
+        ServerRunnable,
         TEXT("UnrealMCPServerThread"),
         0, TPri_Normal
     );
@@ -164,6 +298,78 @@ void UUnrealMCPBridge::StartServer()
         StopServer();
         return;
     }
+
+    StartLocalListeners();
+}
+
+// Serve same-host clients over the optional local transports the command line asks for
+void UUnrealMCPBridge::StartLocalListeners()
+{
+    FString SocketPath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("MCPUnixSocket="), SocketPath) || FParse::Param(FCommandLine::Get(), TEXT("MCPUnixSocket")))
+    {
+        if (SocketPath.IsEmpty())
+        {
+            SocketPath = TEXT(MCP_UNIX_SOCKET_PATH);
+        }
+#if MCP_WITH_UNIX_SOCKETS
+        StartLocalListener(FMCPUnixSocketListener::Create(SocketPath, MCP_SERVER_LISTEN_BACKLOG), TEXT("UnrealMCPUnixServerThread"));
+#else
+        UE_LOG(LogTemp, Warning, TEXT("UnrealMCPBridge: Unix domain sockets are not supported on this platform, ignoring -MCPUnixSocket"));
+#endif
+    }
+
+    FString SegmentName;
+    if (FParse::Value(FCommandLine::Get(), TEXT("MCPSharedMemory="), SegmentName) || FParse::Param(FCommandLine::Get(), TEXT("MCPSharedMemory")))
+    {
+        if (SegmentName.IsEmpty())
+        {
+            SegmentName = TEXT(MCP_SHARED_MEMORY_NAME);
+        }
+#if MCP_WITH_SHARED_MEMORY
+        StartLocalListener(FMCPSharedMemoryListener::Create(SegmentName, MCP_SHARED_MEMORY_RING_SIZE), TEXT("UnrealMCPSharedMemoryServerThread"));
+#else
+        UE_LOG(LogTemp, Warning, TEXT("UnrealMCPBridge: Shared memory transport is not supported on this platform, ignoring -MCPSharedMemory"));
+#endif
+    }
+}
+
+void UUnrealMCPBridge::StartLocalListener(TSharedPtr<FMCPListener> Listener, const TCHAR* ThreadName)
+{
+    if (!Listener.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("UnrealMCPBridge: Failed to start %s, its transport is unavailable"), ThreadName);
+        return;
+    }
+
+    // Sessions from every listener share the connection limit and the request pool
+    FMCPListenerThread& ListenerThread = LocalListenerThreads.AddDefaulted_GetRef();
+    ListenerThread.Runnable = new FMCPServerRunnable(this, Listener, ConnectionManager);
+    ListenerThread.Thread = FRunnableThread::Create(ListenerThread.Runnable, ThreadName, 0, TPri_Normal);
+
+    if (!ListenerThread.Thread)
+    {
+        UE_LOG(LogTemp, Error, TEXT("UnrealMCPBridge: Failed to create %s"), ThreadName);
+        delete ListenerThread.Runnable;
+        LocalListenerThreads.Pop();
+        return;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("UnrealMCPBridge: Also serving on %s"), *Listener->GetDescription());
+}
+
+// Stop an accept thread and free its runnable; killing it calls Stop(), which wakes the listener
+static void StopServerThread(FRunnableThread*& Thread, FMCPServerRunnable*& Runnable)
+{
+    if (Thread)
+    {
+        Thread->Kill(true);
+        delete Thread;
+        Thread = nullptr;
+    }
+
+    delete Runnable;
+    Runnable = nullptr;
 }
 
 // Stop the MCP server
@@ -176,13 +382,25 @@ void UUnrealMCPBridge::StopServer()
 
     bIsRunning = false;
 
-    // Clean up thread
-    if (ServerThread)
+    // Clean up threads
+    StopServerThread(ServerThread, ServerRunnable);
+    for (FMCPListenerThread& ListenerThread : LocalListenerThreads)
     {
-        ServerThread->Kill(true);
-        delete ServerThread;
-        ServerThread = nullptr;
+        StopServerThread(ListenerThread.Thread, ListenerThread.Runnable);
     }
+    LocalListenerThreads.Reset();
+
+    // Run the commands already queued for the game thread, which is blocked here, so
+    // sessions waiting for them finish promptly instead of waiting out their timeouts
+    GameThreadQueue.Stop();
+
+    // Stop client sessions once no new ones can be accepted
+    if (ConnectionManager.IsValid())
+    {
+        ConnectionManager->StopAll();
+        ConnectionManager.Reset();
+    }
+    EventHub.Stop();
 
     // Close sockets
     if (ConnectionSocket.IsValid())
@@ -193,179 +411,614 @@ void UUnrealMCPBridge::StopServer()
 
     if (ListenerSocket.IsValid())
     {
-        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenerSocket.Get());
+        // Already closed by the server runnable's Stop(); the last reference deletes it
         ListenerSocket.Reset();
     }
 
     UE_LOG(LogTemp, Display, TEXT("UnrealMCPBridge: Server stopped"));
 }
 
+// Build the response envelope for a failed command
+static TSharedPtr<FJsonObject> CreateErrorResponseJson(const FString& ErrorMessage)
+{
+    TSharedPtr<FJsonObject> ResponseJson = MakeShareable(new FJsonObject);
+    ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
+    ResponseJson->SetStringField(TEXT("error"), ErrorMessage);
+    return ResponseJson;
+}
+
+// Error message for game-thread work its priority lane had no room for
+static FString GetLaneFullError(EMCPCommandPriority Priority)
+{
+    return FString::Printf(TEXT("Server busy: too many %s commands are queued for the game thread"), LexToString(Priority));
+}
+
+// Build the error envelope for a command that outlived its caller's wait and carries on as a job
+static TSharedPtr<FJsonObject> CreateJobContinuesErrorJson(const FMCPCommandInfo& Command, const FMCPJob& Job)
+{
+    TSharedPtr<FJsonObject> ResponseJson = CreateErrorResponseJson(FString::Printf(
+        TEXT("Command did not finish within %g seconds; it continues as job %s"), Command.TimeoutSeconds, *Job.GetId()));
+    ResponseJson->SetStringField(TEXT("job_id"), Job.GetId());
+    return ResponseJson;
+}
+
 // Execute a command received from a client
 FString UUnrealMCPBridge::ExecuteCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params)
+{
+    TSharedPtr<FJsonObject> ResponseJson = ExecuteCommandJson(CommandType, Params);
+
+    FString ResultString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultString);
+    FJsonSerializer::Serialize(ResponseJson.ToSharedRef(), Writer);
+    return ResultString;
+}
+
+// Execute a command and return the response envelope without serializing it
+TSharedPtr<FJsonObject> UUnrealMCPBridge::ExecuteCommandJson(const FString& CommandType, const TSharedPtr<FJsonObject>& Params)
 {
     UE_LOG(LogTemp, Display, TEXT("UnrealMCPBridge: Executing command: %s"), *CommandType);
+
+    const FMCPCommandInfo* Command = CommandRegistry.Find(CommandType);
+    if (!Command)
+    {
+        return CreateErrorResponseJson(FString::Printf(TEXT("Unknown command: %s"), *CommandType));
+    }
+
+    FString ParamsError;
+    if (!Command->ValidateParams(Params, ParamsError))
+    {
+        return CreateErrorResponseJson(ParamsError);
+    }
+
+    // Commands that don't need the game thread, or callers already on it, run directly
+    if (!Command->bGameThread || IsInGameThread())
+    {
+        return RunCommand(*Command, Params);
+    }
+
+    // We're not on the Game Thread, so queue the execution within the frame budget as a job and
+    // wait for it with the command's timeout. The response object is handed back unserialized so
+    // the calling worker thread pays for serialization.
+    TSharedRef<FMCPJob> Job = StartJob(*Command, Params);
+    if (Job->Wait(FTimespan::FromSeconds(Command->TimeoutSeconds)))
+    {
+        JobManager.RemoveJob(Job->GetId());
+        return Job->GetResponse();
+    }
+
+    // Rather than dropping the command, leave it queued or running and let the client follow the job
+    return CreateJobContinuesErrorJson(*Command, *Job);
+}
+
+bool UUnrealMCPBridge::SupportsStreamedResult(const FString& CommandType) const
+{
+    const FMCPCommandInfo* Command = CommandRegistry.Find(CommandType);
+    return Command && Command->StreamedHandler;
+}
+
+// Execute a command whose result is written directly into the response stream
+TSharedPtr<FJsonObject> UUnrealMCPBridge::ExecuteCommandStreamed(const FString& CommandType, const TSharedPtr<FJsonObject>& Params, FMCPResultWriter& OutResultWriter)
+{
+    UE_LOG(LogTemp, Display, TEXT("UnrealMCPBridge: Executing streamed command: %s"), *CommandType);
+
+    const FMCPCommandInfo* Command = CommandRegistry.Find(CommandType);
+    if (!Command || !Command->StreamedHandler)
+    {
+        return CreateErrorResponseJson(FString::Printf(TEXT("Command cannot be streamed: %s"), *CommandType));
+    }
+
+    FString ParamsError;
+    if (!Command->ValidateParams(Params, ParamsError))
+    {
+        return CreateErrorResponseJson(ParamsError);
+    }
+
+    // Only the snapshot is taken on the game thread; writing it out happens on the worker
+    if (!Command->bGameThread || IsInGameThread())
+    {
+        FString Error;
+        OutResultWriter = Command->StreamedHandler(Params, Error);
+        return OutResultWriter ? nullptr : CreateErrorResponseJson(Error);
+    }
+
+    // Queued as a job like any other game-thread command, so a slow snapshot can be followed or cancelled
+    TSharedRef<FMCPJob> Job = StartJob(*Command, Params, true);
+    if (Job->Wait(FTimespan::FromSeconds(Command->TimeoutSeconds)))
+    {
+        JobManager.RemoveJob(Job->GetId());
+        OutResultWriter = Job->GetResultWriter();
+        return OutResultWriter ? nullptr : Job->GetResponse();
+    }
+
+    return CreateJobContinuesErrorJson(*Command, *Job);
+}
+
+TSharedPtr<FJsonObject> UUnrealMCPBridge::RunCommand(const FMCPCommandInfo& Command, const TSharedPtr<FJsonObject>& Params)
+{
+    check(!Command.bGameThread || IsInGameThread());
+
+    TSharedPtr<FJsonObject> ResponseJson = MakeShareable(new FJsonObject);
     
-    // For ping command, we can handle it directly since it doesn't access Unreal Engine APIs
-    if (CommandType == TEXT("ping"))
+    try
     {
-        TSharedPtr<FJsonObject> ResponseJson = MakeShareable(new FJsonObject);
-        ResponseJson->SetStringField(TEXT("status"), TEXT("success"));
+        TSharedPtr<FJsonObject> ResultJson = Command.Handler(Params);
         
-        TSharedPtr<FJsonObject> ResultJson = MakeShareable(new FJsonObject);
-        ResultJson->SetStringField(TEXT("message"), TEXT("pong"));
-        ResponseJson->SetObjectField(TEXT("result"), ResultJson);
+        // Check if the result contains an error
+        bool bSuccess = true;
+        FString ErrorMessage;
+        
+        if (ResultJson->HasField(TEXT("success")))
+        {
+            bSuccess = ResultJson->GetBoolField(TEXT("success"));
+            if (!bSuccess && ResultJson->HasField(TEXT("error")))
+            {
+                ErrorMessage = ResultJson->GetStringField(TEXT("error"));
+            }
+        }
         
-        FString ResultString;
-        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultString);
-        FJsonSerializer::Serialize(ResponseJson.ToSharedRef(), Writer);
-        return ResultString;
+        if (bSuccess)
+        {
+            // Set success status and include the result
+            ResponseJson->SetStringField(TEXT("status"), TEXT("success"));
+            ResponseJson->SetObjectField(TEXT("result"), ResultJson);
+        }
+        else
+        {
+            // Set error status and include the error message
+            ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
+            ResponseJson->SetStringField(TEXT("error"), ErrorMessage);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
+        ResponseJson->SetStringField(TEXT("error"), UTF8_TO_TCHAR(e.what()));
     }
     
-    // For all other commands, we need to execute them on the Game Thread
-    // Check if we're already on the Game Thread
-    if (IsInGameThread())
+    return ResponseJson;
+}
+
+TSharedRef<FMCPJob> UUnrealMCPBridge::StartJob(const FMCPCommandInfo& Command, const TSharedPtr<FJsonObject>& Params, bool bStreamed)
+{
+    TSharedRef<FMCPJob> Job = JobManager.CreateJob(Command.Name.ToString());
+
+    if (!Command.bGameThread)
     {
-        // Execute directly if we're already on the Game Thread
-        TSharedPtr<FJsonObject> ResponseJson = MakeShareable(new FJsonObject);
-        
-        try
+        Job->TryStart();
+        RunJob(*Job, Command, Params, bStreamed);
+        return Job;
+    }
+
+    // Registry entries live as long as the bridge. A job cancelled while queued is skipped.
+    const FMCPCommandInfo* CommandPtr = &Command;
+    const EMCPEnqueueResult EnqueueResult = GameThreadQueue.Enqueue([this, Job, CommandPtr, Params, bStreamed]()
         {
-            TSharedPtr<FJsonObject> ResultJson;
-            
-            // Editor Commands (including actor manipulation)
-            if (CommandType == TEXT("get_actors_in_level") || 
-                CommandType == TEXT("find_actors_by_name") ||
-                CommandType == TEXT("spawn_actor") ||
-                CommandType == TEXT("create_actor") ||
-                CommandType == TEXT("delete_actor") || 
-                CommandType == TEXT("set_actor_transform") ||
-                CommandType == TEXT("get_actor_properties") ||
-                CommandType == TEXT("set_actor_property") ||
-                CommandType == TEXT("spawn_blueprint_actor") ||
-                CommandType == TEXT("focus_viewport") || 
-                CommandType == TEXT("take_screenshot"))
+            if (Job->TryStart())
             {
-                ResultJson = EditorCommands->HandleCommand(CommandType, Params);
+                RunJob(*Job, *CommandPtr, Params, bStreamed);
             }
-            // Blueprint Commands
-            else if (CommandType == TEXT("create_blueprint") || 
-                     CommandType == TEXT("add_component_to_blueprint") || 
-                     CommandType == TEXT("set_component_property") || 
-                     CommandType == TEXT("set_physics_properties") || 
-                     CommandType == TEXT("compile_blueprint") || 
-                     CommandType == TEXT("set_blueprint_property") || 
-                     CommandType == TEXT("set_static_mesh_properties") ||
-                     CommandType == TEXT("set_pawn_properties"))
+        }, Command.PriorityClass);
+
+    if (EnqueueResult != EMCPEnqueueResult::Queued)
+    {
+        Job->TryStart();
+        Job->Finish(CreateErrorResponseJson(EnqueueResult == EMCPEnqueueResult::LaneFull ? GetLaneFullError(Command.PriorityClass) : FString(TEXT("MCP server is not running"))));
+    }
+    return Job;
+}
+
+void UUnrealMCPBridge::RunJob(FMCPJob& Job, const FMCPCommandInfo& Command, const TSharedPtr<FJsonObject>& Params, bool bStreamed)
+{
+    if (!bStreamed)
+    {
+        Job.Finish(RunCommand(Command, Params));
+        return;
+    }
+
+    // Only the snapshot is taken here; the writer runs later on whichever thread collects the job
+    FString Error;
+    FMCPResultWriter ResultWriter = Command.StreamedHandler(Params, Error);
+    if (ResultWriter)
+    {
+        Job.FinishStreamed(ResultWriter);
+    }
+    else
+    {
+        Job.Finish(CreateErrorResponseJson(Error));
+    }
+}
+
+TSharedPtr<FJsonObject> UUnrealMCPBridge::HandleStartJob(const TSharedPtr<FJsonObject>& Params)
+{
+    const FString CommandType = Params->GetStringField(TEXT("command"));
+    const FMCPCommandInfo* Command = CommandRegistry.Find(CommandType);
+    if (!Command)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown command: %s"), *CommandType));
+    }
+
+    const TSharedPtr<FJsonObject>* CommandParamsObject = nullptr;
+    TSharedPtr<FJsonObject> CommandParams = Params->TryGetObjectField(TEXT("params"), CommandParamsObject) ? *CommandParamsObject : MakeShared<FJsonObject>();
+
+    // Bad params fail here rather than later in the job
+    FString ParamsError;
+    if (!Command->ValidateParams(CommandParams, ParamsError))
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(ParamsError);
+    }
+
+    return StartJob(*Command, CommandParams)->ToJson();
+}
+
+TSharedPtr<FJsonObject> UUnrealMCPBridge::HandleGetJobStatus(const TSharedPtr<FJsonObject>& Params)
+{
+    const FString JobId = Params->GetStringField(TEXT("job_id"));
+    TSharedPtr<FMCPJob> Job = JobManager.FindJob(JobId);
+    if (!Job.IsValid())
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown or expired job: %s"), *JobId));
+    }
+
+    // Never block the game thread, which may be the one that has to run the job
+    double WaitSeconds = 0.0;
+    if (Params->TryGetNumberField(TEXT("wait_seconds"), WaitSeconds) && WaitSeconds > 0.0 && !IsInGameThread())
+    {
+        Job->Wait(FTimespan::FromSeconds(FMath::Min(WaitSeconds, (double)MCP_JOB_MAX_WAIT_SECONDS)));
+    }
+    return Job->ToJson();
+}
+
+TSharedPtr<FJsonObject> UUnrealMCPBridge::HandleCancelJob(const TSharedPtr<FJsonObject>& Params)
+{
+    const FString JobId = Params->GetStringField(TEXT("job_id"));
+    TSharedPtr<FMCPJob> Job = JobManager.FindJob(JobId);
+    if (!Job.IsValid())
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Unknown or expired job: %s"), *JobId));
+    }
+
+    // Commands cannot be interrupted, so only a job still waiting for the game thread can be cancelled
+    const bool bCancelled = Job->TryCancel();
+    TSharedPtr<FJsonObject> ResultJson = Job->ToJson();
+    ResultJson->SetBoolField(TEXT("cancelled"), bCancelled);
+    return ResultJson;
+}
+
+/** One sub-command of a batch */
+struct FMCPBatchItem
+{
+    FString Id;
+    FString CommandType;
+    TSharedPtr<FJsonObject> Params;
+    /** Positions of the items whose results this one's params reference */
+    TArray<int32> Dependencies;
+    bool bHasReferences = false;
+};
+
+/** The item id a "$ref" path starts with: "n1" for "n1.node_id" */
+static FString GetReferencedId(const FString& Reference)
+{
+    int32 DotIndex;
+    return Reference.FindChar(TEXT('.'), DotIndex) ? Reference.Left(DotIndex) : Reference;
+}
+
+/** True if Value is a {"$ref": "..."} object, whose path is returned in OutPath */
+static bool GetReferencePath(const TSharedPtr<FJsonValue>& Value, FString& OutPath)
+{
+    const TSharedPtr<FJsonObject>* Object = nullptr;
+    if (Value->Type == EJson::Object && Value->TryGetObject(Object) && (*Object)->Values.Num() == 1)
+    {
+        const TSharedPtr<FJsonValue>* Path = (*Object)->Values.Find(TEXT("$ref"));
+        if (Path && (*Path)->Type == EJson::String)
+        {
+            OutPath = (*Path)->AsString();
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Adds the ids referenced anywhere inside Value */
+static void CollectReferencedIds(const TSharedPtr<FJsonValue>& Value, TArray<FString>& OutIds)
+{
+    FString Path;
+    if (GetReferencePath(Value, Path))
+    {
+        OutIds.AddUnique(GetReferencedId(Path));
+    }
+    else if (Value->Type == EJson::Object)
+    {
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Value->AsObject()->Values)
+        {
+            CollectReferencedIds(Field.Value, OutIds);
+        }
+    }
+    else if (Value->Type == EJson::Array)
+    {
+        for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+        {
+            CollectReferencedIds(Element, OutIds);
+        }
+    }
+}
+
+/**
+ * Copy of Value with every {"$ref": "id.field.0.field"} replaced by that value of an earlier
+ * result. Objects and arrays are rebuilt; other values are shared with the original.
+ */
+static TSharedPtr<FJsonValue> ResolveReferences(const TSharedPtr<FJsonValue>& Value, const TMap<FString, TSharedPtr<FJsonObject>>& ResultsById, FString& OutError)
+{
+    FString Path;
+    if (GetReferencePath(Value, Path))
+    {
+        TArray<FString> Segments;
+        Path.ParseIntoArray(Segments, TEXT("."));
+        const TSharedPtr<FJsonObject>* Result = Segments.Num() > 0 ? ResultsById.Find(Segments[0]) : nullptr;
+        if (!Result)
+        {
+            OutError = FString::Printf(TEXT("Cannot resolve $ref '%s'"), *Path);
+            return nullptr;
+        }
+
+        TSharedPtr<FJsonValue> Target = MakeShared<FJsonValueObject>(*Result);
+        for (int32 SegmentIndex = 1; SegmentIndex < Segments.Num() && Target.IsValid(); ++SegmentIndex)
+        {
+            const FString& Segment = Segments[SegmentIndex];
+            if (Target->Type == EJson::Object)
             {
-                ResultJson = BlueprintCommands->HandleCommand(CommandType, Params);
+                Target = Target->AsObject()->TryGetField(Segment);
             }
-            // Blueprint Node Commands
-            else if (CommandType == TEXT("connect_blueprint_nodes") || 
-                     CommandType == TEXT("add_blueprint_get_self_component_reference") ||
-                     CommandType == TEXT("add_blueprint_self_reference") ||
-                     CommandType == TEXT("find_blueprint_nodes") ||
-                     CommandType == TEXT("add_blueprint_event_node") ||
-                     CommandType == TEXT("add_blueprint_input_action_node") ||
-                     CommandType == TEXT("add_blueprint_function_node") ||
-                     CommandType == TEXT("add_blueprint_get_component_node") ||
-                     CommandType == TEXT("add_blueprint_variable"))
+            else if (Target->Type == EJson::Array && Segment.IsNumeric())
             {
-                ResultJson = BlueprintNodeCommands->HandleCommand(CommandType, Params);
+                const TArray<TSharedPtr<FJsonValue>>& Elements = Target->AsArray();
+                const int32 ElementIndex = FCString::Atoi(*Segment);
+                Target = Elements.IsValidIndex(ElementIndex) ? Elements[ElementIndex] : nullptr;
             }
-            // Project Commands
-            else if (CommandType == TEXT("create_input_mapping"))
+            else
             {
-                ResultJson = ProjectCommands->HandleCommand(CommandType, Params);
+                Target = nullptr;
             }
-            // UMG Commands
-            else if (CommandType == TEXT("create_umg_widget_blueprint") ||
-                     CommandType == TEXT("add_text_block_to_widget") ||
-                     CommandType == TEXT("add_button_to_widget") ||
-                     CommandType == TEXT("bind_widget_event") ||
-                     CommandType == TEXT("set_text_block_binding") ||
-                     CommandType == TEXT("add_widget_to_viewport"))
+        }
+
+        if (!Target.IsValid())
+        {
+            OutError = FString::Printf(TEXT("Cannot resolve $ref '%s'"), *Path);
+        }
+        return Target;
+    }
+
+    if (Value->Type == EJson::Object)
+    {
+        TSharedPtr<FJsonObject> Resolved = MakeShared<FJsonObject>();
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Value->AsObject()->Values)
+        {
+            TSharedPtr<FJsonValue> ResolvedField = ResolveReferences(Field.Value, ResultsById, OutError);
+            if (!ResolvedField.IsValid())
             {
-                ResultJson = UMGCommands->HandleCommand(CommandType, Params);
+                return nullptr;
             }
-            else
+            Resolved->SetField(Field.Key, ResolvedField);
+        }
+        return MakeShared<FJsonValueObject>(Resolved);
+    }
+
+    if (Value->Type == EJson::Array)
+    {
+        TArray<TSharedPtr<FJsonValue>> Resolved;
+        Resolved.Reserve(Value->AsArray().Num());
+        for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+        {
+            TSharedPtr<FJsonValue> ResolvedElement = ResolveReferences(Element, ResultsById, OutError);
+            if (!ResolvedElement.IsValid())
             {
-                ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
-                ResponseJson->SetStringField(TEXT("error"), FString::Printf(TEXT("Unknown command: %s"), *CommandType));
-                
-                FString ResultString;
-                TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultString);
-                FJsonSerializer::Serialize(ResponseJson.ToSharedRef(), Writer);
-                return ResultString;
+                return nullptr;
             }
-            
-            // Check if the result contains an error
-            bool bSuccess = true;
-            FString ErrorMessage;
-            
-            if (ResultJson->HasField(TEXT("success")))
+            Resolved.Add(ResolvedElement);
+        }
+        return MakeShared<FJsonValueArray>(Resolved);
+    }
+
+    return Value;
+}
+
+// Run a list of commands in one game-thread slice.
+// Params: "commands" is an array of {"command": ..., "params": {...}} objects, each with an optional
+// "id". A param value of {"$ref": "<id>.<field>..."} is replaced by that field of the result of the
+// item with that id, so a whole graph of dependent commands fits in one request; items run in
+// their given order except where a reference requires an earlier start. "on_error" is "stop"
+// (default) or "continue"; "transaction" (a description, or true) records the whole batch as a
+// single undo step. The result lists one response envelope per command that ran, in the order
+// they ran, each with the "index" of its item (and its "id" when it has one).
+TSharedPtr<FJsonObject> UUnrealMCPBridge::HandleBatch(const TSharedPtr<FJsonObject>& Params)
+{
+    check(IsInGameThread());
+
+    const TArray<TSharedPtr<FJsonValue>>& Commands = Params->GetArrayField(TEXT("commands"));
+    if (Commands.Num() > MCP_MAX_BATCH_COMMANDS)
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("A batch may hold at most %d commands, got %d"), MCP_MAX_BATCH_COMMANDS, Commands.Num()));
+    }
+
+    FString OnError = TEXT("stop");
+    Params->TryGetStringField(TEXT("on_error"), OnError);
+    if (OnError != TEXT("stop") && OnError != TEXT("continue"))
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Invalid on_error '%s', expected 'stop' or 'continue'"), *OnError));
+    }
+    const bool bStopOnError = OnError == TEXT("stop");
+
+    // Read every item and check the reference graph before running anything, so a
+    // malformed graph fails as a whole instead of part way through
+    TArray<FMCPBatchItem> Items;
+    Items.SetNum(Commands.Num());
+    TMap<FString, int32> IndexById;
+    for (int32 Index = 0; Index < Commands.Num(); ++Index)
+    {
+        FMCPBatchItem& Item = Items[Index];
+        const TSharedPtr<FJsonObject>* ItemObject = nullptr;
+        if (!Commands[Index]->TryGetObject(ItemObject) || !(*ItemObject)->TryGetStringField(TEXT("command"), Item.CommandType))
+        {
+            return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Batch item %d has no 'command'"), Index));
+        }
+
+        const TSharedPtr<FJsonObject>* ItemParams = nullptr;
+        Item.Params = (*ItemObject)->TryGetObjectField(TEXT("params"), ItemParams) ? *ItemParams : MakeShared<FJsonObject>();
+
+        if ((*ItemObject)->TryGetStringField(TEXT("id"), Item.Id))
+        {
+            if (Item.Id.IsEmpty() || Item.Id.Contains(TEXT(".")) || IndexById.Contains(Item.Id))
             {
-                bSuccess = ResultJson->GetBoolField(TEXT("success"));
-                if (!bSuccess && ResultJson->HasField(TEXT("error")))
-                {
-                    ErrorMessage = ResultJson->GetStringField(TEXT("error"));
-                }
+                return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Batch item %d has an empty, dotted or duplicate id '%s'"), Index, *Item.Id));
             }
-            
-            if (bSuccess)
+            IndexById.Add(Item.Id, Index);
+        }
+    }
+
+    TArray<TArray<int32>> Dependents;
+    Dependents.SetNum(Items.Num());
+    TArray<int32> PendingDependencies;
+    PendingDependencies.SetNumZeroed(Items.Num());
+    for (int32 Index = 0; Index < Items.Num(); ++Index)
+    {
+        TArray<FString> ReferencedIds;
+        CollectReferencedIds(MakeShared<FJsonValueObject>(Items[Index].Params), ReferencedIds);
+        Items[Index].bHasReferences = ReferencedIds.Num() > 0;
+
+        for (const FString& ReferencedId : ReferencedIds)
+        {
+            const int32* Dependency = IndexById.Find(ReferencedId);
+            if (!Dependency)
             {
-                // Set success status and include the result
-                ResponseJson->SetStringField(TEXT("status"), TEXT("success"));
-                ResponseJson->SetObjectField(TEXT("result"), ResultJson);
+                return FUnrealMCPCommonUtils::CreateErrorResponse(FString::Printf(TEXT("Batch item %d references unknown id '%s'"), Index, *ReferencedId));
             }
-            else
+            Items[Index].Dependencies.Add(*Dependency);
+            Dependents[*Dependency].Add(Index);
+            ++PendingDependencies[Index];
+        }
+    }
+
+    // Kahn's algorithm, always taking the lowest ready position so that batches
+    // without references run exactly in the order they were given
+    TArray<int32> Order;
+    Order.Reserve(Items.Num());
+    TArray<int32> Ready;
+    for (int32 Index = 0; Index < Items.Num(); ++Index)
+    {
+        if (PendingDependencies[Index] == 0)
+        {
+            Ready.HeapPush(Index);
+        }
+    }
+    while (Ready.Num() > 0)
+    {
+        int32 Index;
+        Ready.HeapPop(Index);
+        Order.Add(Index);
+        for (int32 Dependent : Dependents[Index])
+        {
+            if (--PendingDependencies[Dependent] == 0)
             {
-                // Set error status and include the error message
-                ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
-                ResponseJson->SetStringField(TEXT("error"), ErrorMessage);
+                Ready.HeapPush(Dependent);
             }
         }
-        catch (const std::exception& e)
+    }
+    if (Order.Num() < Items.Num())
+    {
+        return FUnrealMCPCommonUtils::CreateErrorResponse(TEXT("Batch references form a cycle"));
+    }
+
+    // The transaction stays open until the last command has run, so undo reverts all of them together
+    TUniquePtr<FScopedTransaction> Transaction;
+    const TSharedPtr<FJsonValue> TransactionValue = Params->TryGetField(TEXT("transaction"));
+    if (TransactionValue.IsValid())
+    {
+        if (TransactionValue->Type == EJson::String)
         {
-            ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
-            ResponseJson->SetStringField(TEXT("error"), UTF8_TO_TCHAR(e.what()));
+            Transaction = MakeUnique<FScopedTransaction>(FText::FromString(TransactionValue->AsString()));
+        }
+        else if (TransactionValue->Type == EJson::Boolean && TransactionValue->AsBool())
+        {
+            Transaction = MakeUnique<FScopedTransaction>(FText::FromString(TEXT("MCP Batch")));
         }
-        
-        FString ResultString;
-        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultString);
-        FJsonSerializer::Serialize(ResponseJson.ToSharedRef(), Writer);
-        return ResultString;
     }
-    else
+
+    const FName BatchCommandName(TEXT("batch"));
+    TMap<FString, TSharedPtr<FJsonObject>> ResultsById;
+    TArray<bool> Succeeded;
+    Succeeded.SetNumZeroed(Items.Num());
+    TArray<TSharedPtr<FJsonValue>> Results;
+    Results.Reserve(Items.Num());
+    int32 FailedCount = 0;
+
+    for (int32 Index : Order)
     {
-        // We're not on the Game Thread, so we need to queue the execution
-        // Use a promise/future pattern to wait for the result
-        TPromise<FString> Promise;
-        TFuture<FString> Future = Promise.GetFuture();
-        
-        // Queue execution on Game Thread
-        AsyncTask(ENamedThreads::GameThread, [this, CommandType, Params, Promise = MoveTemp(Promise)]() mutable
+        const FMCPBatchItem& Item = Items[Index];
+        TSharedPtr<FJsonObject> ItemResponse;
+
+        const int32* FailedDependency = Item.Dependencies.FindByPredicate([&Succeeded](int32 Dependency) { return !Succeeded[Dependency]; });
+        const FMCPCommandInfo* Command = CommandRegistry.Find(Item.CommandType);
+        TSharedPtr<FJsonObject> ItemParams = Item.Params;
+        FString ParamsError;
+
+        if (FailedDependency)
         {
-            // Execute the command on the Game Thread
-            FString Result = ExecuteCommand(CommandType, Params);
-            Promise.SetValue(Result);
-        });
-        
-        // Wait for the result with a timeout
-        if (Future.WaitFor(FTimespan::FromSeconds(5.0)))
+            ItemResponse = CreateErrorResponseJson(FString::Printf(TEXT("Depends on '%s', which failed"), *Items[*FailedDependency].Id));
+        }
+        else if (!Command)
+        {
+            ItemResponse = CreateErrorResponseJson(FString::Printf(TEXT("Unknown command: %s"), *Item.CommandType));
+        }
+        else if (Command->Name == BatchCommandName)
         {
-            return Future.Get();
+            ItemResponse = CreateErrorResponseJson(TEXT("Batches cannot be nested"));
         }
         else
         {
-            // Timeout occurred
-            TSharedPtr<FJsonObject> ResponseJson = MakeShareable(new FJsonObject);
-            ResponseJson->SetStringField(TEXT("status"), TEXT("error"));
-            ResponseJson->SetStringField(TEXT("error"), TEXT("Command execution timed out"));
-            
-            FString ResultString;
-            TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultString);
-            FJsonSerializer::Serialize(ResponseJson.ToSharedRef(), Writer);
-            return ResultString;
+            if (Item.bHasReferences)
+            {
+                TSharedPtr<FJsonValue> Resolved = ResolveReferences(MakeShared<FJsonValueObject>(Item.Params), ResultsById, ParamsError);
+                ItemParams = Resolved.IsValid() ? Resolved->AsObject() : nullptr;
+            }
+
+            // References are checked once resolved, since a $ref object stands in for a value of any type
+            if (ItemParams.IsValid() && Command->ValidateParams(ItemParams, ParamsError))
+            {
+                ItemResponse = RunCommand(*Command, ItemParams);
+            }
+            else
+            {
+                ItemResponse = CreateErrorResponseJson(ParamsError);
+            }
+        }
+
+        const bool bItemSucceeded = ItemResponse->GetStringField(TEXT("status")) == TEXT("success");
+        Succeeded[Index] = bItemSucceeded;
+        if (bItemSucceeded && !Item.Id.IsEmpty())
+        {
+            ResultsById.Add(Item.Id, ItemResponse->GetObjectField(TEXT("result")));
+        }
+
+        ItemResponse->SetNumberField(TEXT("index"), Index);
+        if (!Item.Id.IsEmpty())
+        {
+            ItemResponse->SetStringField(TEXT("id"), Item.Id);
+        }
+        Results.Add(MakeShared<FJsonValueObject>(ItemResponse));
+
+        if (!bItemSucceeded)
+        {
+            ++FailedCount;
+            if (bStopOnError)
+            {
+                break;
+            }
         }
     }
-}
\ No newline at end of file
+
+    TSharedPtr<FJsonObject> ResultJson = MakeShared<FJsonObject>();
+    ResultJson->SetArrayField(TEXT("results"), Results);
+    ResultJson->SetNumberField(TEXT("total"), Commands.Num());
+    ResultJson->SetNumberField(TEXT("completed"), Results.Num());
+    ResultJson->SetNumberField(TEXT("failed"), FailedCount);
+    return ResultJson;
+}
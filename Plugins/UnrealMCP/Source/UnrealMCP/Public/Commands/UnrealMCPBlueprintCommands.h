@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "Json.h"
 
+class FMCPCommandRegistry;
+
 /**
  * Handler class for Blueprint-related MCP commands
  */
@@ -11,8 +13,8 @@ class UNREALMCP_API FUnrealMCPBlueprintCommands
 public:
     FUnrealMCPBlueprintCommands();
 
-    // Handle blueprint commands
-    TSharedPtr<FJsonObject> HandleCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params);
+    // Register the blueprint commands with the bridge's dispatch table
+    void RegisterCommands(FMCPCommandRegistry& Registry);
 
 private:
     // Specific blueprint command handlers
@@ -2,6 +2,12 @@
 
 #include "CoreMinimal.h"
 #include "Json.h"
+#include "MCPResponseWriter.h"
+
+class FMCPCommandRegistry;
+class FMCPActorIndex;
+class FMCPSceneChangeLog;
+struct FMCPActorListing;
 
 /**
  * Handler class for Editor-related MCP commands
@@ -10,21 +16,39 @@
 class UNREALMCP_API FUnrealMCPEditorCommands
 {
 public:
-    FUnrealMCPEditorCommands();
+    FUnrealMCPEditorCommands(FMCPActorIndex& InActorIndex, FMCPSceneChangeLog& InSceneChanges);
+
+    // Register the editor commands with the bridge's dispatch table
+    void RegisterCommands(FMCPCommandRegistry& Registry);
 
-    // Handle editor commands
-    TSharedPtr<FJsonObject> HandleCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params);
+    // Snapshot the level's actors on the game thread; the returned writer streams them out later, none on bad params
+    FMCPResultWriter CaptureActorsInLevel(const TSharedPtr<FJsonObject>& Params, FString& OutError);
 
 private:
+    // Every actor lookup goes through the bridge's index rather than scanning the level
+    FMCPActorIndex& ActorIndex;
+    FMCPSceneChangeLog& SceneChanges;
+
+    // Filters, sorts and pages the level's actors for get_actors_in_level; false with OutError on bad params
+    bool ListActors(const TSharedPtr<FJsonObject>& Params, FMCPActorListing& OutListing, FString& OutError);
+
     // Actor manipulation commands
     TSharedPtr<FJsonObject> HandleGetActorsInLevel(const TSharedPtr<FJsonObject>& Params);
     TSharedPtr<FJsonObject> HandleFindActorsByName(const TSharedPtr<FJsonObject>& Params);
+    TSharedPtr<FJsonObject> HandleGetSceneChangesSince(const TSharedPtr<FJsonObject>& Params);
     TSharedPtr<FJsonObject> HandleSpawnActor(const TSharedPtr<FJsonObject>& Params);
     TSharedPtr<FJsonObject> HandleDeleteActor(const TSharedPtr<FJsonObject>& Params);
     TSharedPtr<FJsonObject> HandleSetActorTransform(const TSharedPtr<FJsonObject>& Params);
+    // Moves many actors in one game-thread slice and answers with a bitmap of those it moved
+    TSharedPtr<FJsonObject> HandleSetActorTransforms(const TSharedPtr<FJsonObject>& Params);
     TSharedPtr<FJsonObject> HandleGetActorProperties(const TSharedPtr<FJsonObject>& Params);
     TSharedPtr<FJsonObject> HandleSetActorProperty(const TSharedPtr<FJsonObject>& Params);
 
+    // Spatial queries, answered from the actor index's octree
+    TSharedPtr<FJsonObject> HandleQueryActorsInSphere(const TSharedPtr<FJsonObject>& Params);
+    TSharedPtr<FJsonObject> HandleQueryActorsInBox(const TSharedPtr<FJsonObject>& Params);
+    TSharedPtr<FJsonObject> HandleQueryActorsInFrustum(const TSharedPtr<FJsonObject>& Params);
+
     // Blueprint actor spawning
     TSharedPtr<FJsonObject> HandleSpawnBlueprintActor(const TSharedPtr<FJsonObject>& Params);
 
@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "Json.h"
 
+class FMCPCommandRegistry;
+
 /**
  * Handler class for Project-wide MCP commands
  */
@@ -11,10 +13,14 @@ class UNREALMCP_API FUnrealMCPProjectCommands
 public:
     FUnrealMCPProjectCommands();
 
-    // Handle project commands
-    TSharedPtr<FJsonObject> HandleCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params);
+    // Register the project commands with the bridge's dispatch table
+    void RegisterCommands(FMCPCommandRegistry& Registry);
 
 private:
     // Specific project command handlers
     TSharedPtr<FJsonObject> HandleCreateInputMapping(const TSharedPtr<FJsonObject>& Params);
+
+    // Read-only queries that are safe off the game thread
+    TSharedPtr<FJsonObject> HandleFindAssets(const TSharedPtr<FJsonObject>& Params);
+    TSharedPtr<FJsonObject> HandleGetConfigValue(const TSharedPtr<FJsonObject>& Params);
 }; 
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/GenericOctree.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UWorld;
+struct FPropertyChangedEvent;
+
+/** How an actor of the indexed world changed */
+enum class EMCPActorChange : uint8
+{
+	Added,
+	Removed,
+	Transformed,
+	/** A property or the label changed */
+	Modified,
+	/** The editor world itself was replaced, e.g. by loading a map; reported without an actor */
+	Reset
+};
+
+/** Change, the actor (null once removed) and its name */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnMCPActorChanged, EMCPActorChange, AActor*, FName);
+
+/** How SearchActors compares a pattern with actor names and labels */
+enum class EMCPActorSearchMode : uint8
+{
+	/** The pattern appears anywhere in the name or label */
+	Substring,
+	/** The whole name or label matches, with * for any run of characters and ? for any one */
+	Glob,
+	/** An ICU regular expression found anywhere in the name or label */
+	Regex,
+	/** The pattern's characters appear in order; matches are scored by how closely */
+	Fuzzy
+};
+
+/** An actor found by SearchActors; the score is only set by fuzzy searches, higher is closer */
+struct FMCPActorSearchMatch
+{
+	AActor* Actor = nullptr;
+	float Score = 0.0f;
+};
+
+/** An actor and the bounds the spatial index holds for it */
+struct FMCPActorBounds
+{
+	AActor* Actor = nullptr;
+	FBox Bounds;
+};
+
+/**
+ * The editor world's actors by name, label and class, so single-actor commands are a
+ * hash lookup instead of a scan of the level, by bounds in an octree for spatial queries,
+ * and by the trigrams of their names and labels for text search.
+ * Kept up to date from the engine's level actor events; anything that changes actors
+ * in bulk (map loads, undo, blueprint reinstancing) marks it stale and it is rebuilt on
+ * the next lookup. Game thread only.
+ *
+ * Every change it sees is also reported through OnActorChanged. Actors added or removed
+ * while the index was stale are found by comparing the rebuilt index with the old one.
+ */
+class UNREALMCP_API FMCPActorIndex
+{
+public:
+	FMCPActorIndex();
+	~FMCPActorIndex();
+
+	/** Unsubscribes from engine events and forgets every actor */
+	void Reset();
+
+	/** Subscribes on first use and rebuilds when stale or when the editor world changed */
+	void EnsureUpToDate();
+
+	FOnMCPActorChanged& OnActorChanged() { return ActorChangedEvent; }
+
+	/** The actor with this object name, or null */
+	AActor* FindActorByName(const FString& Name);
+	/** Actors whose editor label is Label, compared case-insensitively */
+	void FindActorsByLabel(const FString& Label, TArray<AActor*>& OutActors);
+	/** Actors whose class has this short name, e.g. "StaticMeshActor"; subclasses are not included */
+	void FindActorsOfClass(FName ClassName, TArray<AActor*>& OutActors);
+	/** Every live actor of the editor world, in no particular order */
+	void GetAllActors(TArray<AActor*>& OutActors);
+	/** Actors whose bounds overlap Box, in no particular order */
+	void FindActorsInBox(const FBox& Box, TArray<FMCPActorBounds>& OutActors);
+	/**
+	 * Actors whose name or label matches Pattern, in no particular order. Only actors holding
+	 * every trigram of the pattern's literal text are compared with it, so patterns with a
+	 * few characters of plain text skip most of the level.
+	 */
+	void SearchActors(const FString& Pattern, EMCPActorSearchMode Mode, ESearchCase::Type SearchCase, TArray<FMCPActorSearchMatch>& OutMatches);
+
+	/**
+	 * Refiles an actor in the octree and reports the change. Editor moves and property edits
+	 * are picked up on their own; code that changes actors directly calls this. Added only
+	 * indexes and reports actors the index does not hold yet.
+	 */
+	void NotifyActorChanged(AActor* Actor, EMCPActorChange Change);
+
+	int32 Num();
+
+private:
+	/** The keys an actor was indexed under, so it can be removed after they change */
+	struct FIndexedKeys
+	{
+		FName Name;
+		FString Label;
+		FName ClassName;
+		/** Shared with the actor's octree element, which the octree keeps up to date as it moves elements */
+		TSharedPtr<FOctreeElementId2> OctreeId;
+		int32 SearchId = INDEX_NONE;
+	};
+
+	/** An actor's name and label as text search sees them */
+	struct FSearchEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FString Name;
+		FString Label;
+		/** The characters in either, folded into 64 bits, to rule entries out without comparing text */
+		uint64 CharacterMask = 0;
+	};
+
+	struct FOctreeElement
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FBox Bounds;
+		TSharedPtr<FOctreeElementId2> Id;
+	};
+
+	struct FOctreeSemantics
+	{
+		enum { MaxElementsPerLeaf = 16 };
+		enum { MinInclusiveElementsPerNode = 7 };
+		enum { MaxNodeDepth = 12 };
+
+		typedef TInlineAllocator<MaxElementsPerLeaf> ElementAllocator;
+
+		static FBoxCenterAndExtent GetBoundingBox(const FOctreeElement& Element) { return FBoxCenterAndExtent(Element.Bounds); }
+		static bool AreElementsEqual(const FOctreeElement& A, const FOctreeElement& B) { return A.Id == B.Id; }
+		static void SetElementId(const FOctreeElement& Element, FOctreeElementId2 Id) { *Element.Id = Id; }
+	};
+
+	typedef TOctree2<FOctreeElement, FOctreeSemantics> FActorOctree;
+
+	void Rebuild(UWorld* World);
+	void AddActor(AActor* Actor);
+	void RemoveActor(const AActor* Actor);
+	void AddToOctree(AActor* Actor, const FIndexedKeys& Keys);
+	/** Refiles an actor in the octree after it moved or changed shape */
+	void UpdateActorBounds(AActor* Actor);
+	void AddSearchEntry(AActor* Actor, FIndexedKeys& Keys);
+	void RemoveSearchEntry(int32 SearchId);
+	/** Search entries holding every one of the sorted Trigrams; all entries when there are none */
+	void FindSearchCandidates(const TArray<uint64>& Trigrams, TArray<int32>& OutCandidates) const;
+
+	void OnLevelActorAdded(AActor* Actor);
+	void OnLevelActorDeleted(AActor* Actor);
+	void OnActorLabelChanged(AActor* Actor);
+	void OnActorMoved(AActor* Actor);
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+	/** Reports a change to an actor of the indexed world; others are ignored */
+	void BroadcastChange(EMCPActorChange Change, AActor* Actor);
+	void MarkStale();
+
+	TWeakObjectPtr<UWorld> IndexedWorld;
+	bool bStale;
+	bool bSubscribed;
+
+	TMap<FName, TWeakObjectPtr<AActor>> ActorsByName;
+	TMap<FString, TArray<TWeakObjectPtr<AActor>>> ActorsByLabel;
+	TMap<FName, TArray<TWeakObjectPtr<AActor>>> ActorsByClass;
+	TMap<TObjectKey<AActor>, FIndexedKeys> KeysByActor;
+	TUniquePtr<FActorOctree> Octree;
+	TSparseArray<FSearchEntry> SearchEntries;
+	/** Search entries by the lowercase trigrams of their name and label, each list sorted */
+	TMap<uint64, TArray<int32>> SearchEntriesByTrigram;
+
+	FDelegateHandle ActorAddedHandle;
+	FDelegateHandle ActorDeletedHandle;
+	FDelegateHandle ActorListChangedHandle;
+	FDelegateHandle ActorLabelChangedHandle;
+	FDelegateHandle MapChangeHandle;
+	FDelegateHandle ObjectsReplacedHandle;
+	FDelegateHandle ActorMovedHandle;
+	FDelegateHandle ObjectPropertyChangedHandle;
+
+	FOnMCPActorChanged ActorChangedEvent;
+};
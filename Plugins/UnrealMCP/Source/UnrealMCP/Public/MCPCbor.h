@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+
+class FJsonObject;
+class FJsonValue;
+
+/**
+ * Encodes CBOR (RFC 8949) into an archive, as the binary alternative to JSON.
+ * Covers the JSON data model only. Containers may be written with an
+ * indefinite length and closed with WriteBreak, so streamed results can be
+ * encoded without counting their items first. Numbers use the smallest
+ * exact form: integers when the value is integral, otherwise single or
+ * double precision floats.
+ */
+class FMCPCborWriter
+{
+public:
+	explicit FMCPCborWriter(FArchive& InArchive);
+
+	void WriteNull();
+	void WriteBool(bool bValue);
+	void WriteNumber(double Value);
+	void WriteString(FStringView Value);
+
+	/** Starts an array of Num items, or of unknown length when Num is negative */
+	void WriteArrayStart(int32 Num = -1);
+	/** Starts a map of Num key/value pairs, or of unknown length when Num is negative */
+	void WriteMapStart(int32 Num = -1);
+	/** Closes the innermost container started with an unknown length */
+	void WriteBreak();
+
+	void WriteJsonValue(const TSharedPtr<FJsonValue>& Value);
+	void WriteJsonObject(const TSharedPtr<FJsonObject>& Object);
+
+private:
+	void WriteHeader(uint8 MajorType, uint64 Argument);
+
+	FArchive& Archive;
+};
+
+/** Decodes CBOR requests into the same DOM the JSON path produces */
+class FMCPCborReader
+{
+public:
+	/** Decodes one message whose top-level item must be a map with text keys */
+	static bool DeserializeObject(const uint8* Data, int32 Size, TSharedPtr<FJsonObject>& OutObject, FString& OutError);
+
+private:
+	FMCPCborReader(const uint8* InData, int32 InSize);
+
+	TSharedPtr<FJsonValue> ReadValue(int32 Depth);
+	bool ReadHeader(uint8& OutMajorType, uint8& OutAdditional, uint64& OutArgument);
+	bool ReadText(uint8 Additional, uint64 Length, FString& OutText);
+	bool IsBreak() const;
+	bool Fail(const TCHAR* Message);
+
+	const uint8* Data;
+	int32 Size;
+	int32 Offset;
+	FString Error;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "MCPTransport.h"
+#include "MCPResponseWriter.h"
+
+class UUnrealMCPBridge;
+class FJsonObject;
+class FJsonValue;
+class FQueuedThreadPool;
+class FRunnableThread;
+class FMCPEventSubscription;
+class FMCPEventSender;
+
+/**
+ * Serves one client session on its own worker thread.
+ * Reads length-prefixed JSON requests, parses them off the game thread and
+ * hands each command to the bridge, which only marshals the work that needs
+ * the game thread.
+ *
+ * A message is one or more frames: a 4-byte little-endian header (30-bit
+ * length, top bit set when more frames follow, next bit set when the frame is
+ * compressed) and the frame payload. Chunked responses are only sent after the
+ * client opts in with 'hello', which can also switch the session's payloads
+ * from JSON to CBOR and compress frames above a size threshold.
+ *
+ * Requests carrying an "id" field are pipelined: they run on the shared
+ * request pool while the session keeps reading, and their responses are
+ * tagged with the same id and may arrive out of order. Requests without an
+ * id are executed in order, one at a time, as before. Pipelined requests are
+ * routed by the command's priority class: control commands are answered on
+ * the session thread at once, reads go to the interactive pool, and the rest
+ * to the shared request pool.
+ *
+ * After 'subscribe' the session also receives editor events it did not ask for
+ * in a request: messages with an "event" field and its "data" instead of a
+ * status, sent between responses. A thread of the session's own sends them as
+ * soon as the event hub queues them, so they never wait for a request the
+ * session is executing. A subscribed session is not closed for inactivity.
+ */
+class FMCPClientConnection : public FRunnable, public TSharedFromThis<FMCPClientConnection>
+{
+public:
+	FMCPClientConnection(UUnrealMCPBridge* InBridge, TSharedPtr<FMCPTransport> InTransport, int32 InConnectionId, FQueuedThreadPool* InRequestPool, FQueuedThreadPool* InInteractivePool);
+	virtual ~FMCPClientConnection();
+
+	// FRunnable interface
+	virtual bool Init() override;
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	virtual void Exit() override;
+
+	/** True once the session has ended and the worker thread can be reclaimed */
+	bool IsFinished() const { return bFinished; }
+	int32 GetConnectionId() const { return ConnectionId; }
+
+	/** Executes one command and sends its response, tagged with RequestId when present */
+	void ExecuteRequest(const FString& CommandType, const TSharedPtr<FJsonObject>& Params, const TSharedPtr<FJsonValue>& RequestId);
+
+	/** Called by the request pool when a pipelined request has been answered or abandoned */
+	void OnPipelinedRequestFinished();
+
+	/** Sends a single error frame to a client that is about to be disconnected */
+	static void RejectClient(const TSharedPtr<FMCPTransport>& Client, const FString& ErrorMessage);
+
+	static TSharedPtr<FJsonObject> CreateErrorResponse(const FString& ErrorMessage, const TSharedPtr<FJsonValue>& RequestId = nullptr);
+
+	/** Parses a request directly from its received UTF-8 bytes */
+	static bool DeserializeRequest(const uint8* Data, int32 Size, TSharedPtr<FJsonObject>& OutObject, FString& OutError);
+
+protected:
+	enum class EMCPReceiveResult : uint8
+	{
+		Success,
+		Closed,
+		Error,
+		/** The frame header was malformed; the stream is out of sync */
+		BadFrame,
+		/** The message exceeded the size limit and was discarded */
+		TooLarge
+	};
+
+	/** Serves framed requests until the session ends */
+	void HandleClientConnection();
+	void ProcessMessage(const TSharedPtr<FJsonObject>& JsonObject);
+
+	/** Reads one message, reassembling it from continuation frames */
+	EMCPReceiveResult ReceiveMessage(TArray<uint8>& OutMessage);
+
+	/** Negotiates per-session options such as chunked response frames */
+	void HandleHello(const TSharedPtr<FJsonObject>& Params, const TSharedPtr<FJsonValue>& RequestId);
+
+	/** Adds events to the session's subscription, or removes them; removing them all ends it */
+	void HandleSubscription(const TSharedPtr<FJsonObject>& Params, const TSharedPtr<FJsonValue>& RequestId, bool bSubscribe);
+
+	/** Starts the thread that sends the subscription's events as they are queued */
+	bool StartEventDelivery();
+	/** Stops that thread once the subscription ends */
+	void StopEventDelivery();
+	/** Sends the events queued for the session since the last call; runs on the event thread */
+	void SendPendingEvents(FMCPEventSubscription& Subscription);
+
+	/** Blocks until fewer than Limit pipelined requests are outstanding, or the session stops */
+	void WaitForPipelinedRequests(int32 Limit);
+
+	/** Serializes and sends one response; frames from concurrent requests never interleave */
+	bool SendResponseObject(const TSharedPtr<FJsonObject>& ResponseJson);
+
+	/** Sends a success envelope whose result fields are written by ResultWriter as they are produced */
+	bool SendStreamedResponse(const FMCPResultWriter& ResultWriter, const TSharedPtr<FJsonValue>& RequestId);
+
+	/** Writes one message using the session's framing. Caller must hold SendLock. */
+	bool SendMessage(const uint8* Data, int64 Length);
+
+	/** Writes one frame, compressed when negotiated and worthwhile. Caller must hold SendLock. */
+	bool SendPayloadFrame(const uint8* Data, uint32 Length, uint32 Flags);
+
+	/** Reads exactly Size bytes, distinguishing a clean close before the first byte from an error */
+	static EMCPReceiveResult ReceiveExactly(const TSharedPtr<FMCPTransport>& Client, uint8* Data, int32 Size);
+	static bool SendFrame(const TSharedPtr<FMCPTransport>& Client, const uint8* Data, uint32 Length, uint32 Flags);
+	static bool SendAll(const TSharedPtr<FMCPTransport>& Client, const uint8* Data, int64 Length);
+
+private:
+	friend class FMCPResponseStream;
+	friend class FMCPEventSender;
+
+	UUnrealMCPBridge* Bridge;
+	TSharedPtr<FMCPTransport> Transport;
+	int32 ConnectionId;
+	FQueuedThreadPool* RequestPool;
+	/** Runs pipelined control and interactive requests; null to use RequestPool for them too */
+	FQueuedThreadPool* InteractivePool;
+	TAtomic<bool> bRunning;
+	TAtomic<bool> bFinished;
+
+	/** Guards the socket's write side and the negotiated framing below */
+	FCriticalSection SendLock;
+	bool bChunkedResponses;
+	int32 MaxFrameSize;
+	EMCPPayloadEncoding PayloadEncoding;
+	/** NAME_None until 'hello' negotiates a format */
+	FName CompressionFormat;
+	int32 CompressionThreshold;
+	/** Scratch space for compressing outgoing frames */
+	TArray<uint8> CompressionBuffer;
+
+	/** Pipelined requests queued or executing for this session */
+	FThreadSafeCounter PipelinedRequests;
+	FEvent* PipelinedRequestFinishedEvent;
+
+	/** Editor events the client subscribed to; only used on the session thread */
+	TSharedPtr<FMCPEventSubscription> EventSubscription;
+	/** Sends the subscription's events while there is one */
+	FMCPEventSender* EventSender;
+	FRunnableThread* EventSenderThread;
+};
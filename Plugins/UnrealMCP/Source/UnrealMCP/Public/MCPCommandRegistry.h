@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "MCPResponseWriter.h"
+
+/** Runs a command and returns its result object; failures carry "success": false and "error" */
+typedef TFunction<TSharedPtr<FJsonObject>(const TSharedPtr<FJsonObject>& Params)> FMCPCommandHandler;
+
+/**
+ * Captures a command's result on the command's thread and returns a writer the worker runs later.
+ * Returning no writer fails the command with OutError, e.g. over bad params.
+ */
+typedef TFunction<FMCPResultWriter(const TSharedPtr<FJsonObject>& Params, FString& OutError)> FMCPStreamedCommandHandler;
+
+/**
+ * Scheduling class of a command. Each class has its own request workers and game-thread
+ * lane with their own limits, and lower classes are always served first, so health checks
+ * and interactive reads do not wait behind a bulk import.
+ */
+enum class EMCPCommandPriority : uint8
+{
+	/** Health checks and server introspection; answered without queueing */
+	Control,
+	/** Cheap reads a user is waiting on */
+	Interactive,
+	/** Edits to the level, assets or project */
+	Mutation,
+	/** Compiles, batches and other long work */
+	Bulk,
+	Num
+};
+
+/** Name of a priority class as it appears in queue stats */
+UNREALMCP_API const TCHAR* LexToString(EMCPCommandPriority Priority);
+
+/** A parameter a command cannot run without */
+struct FMCPCommandParam
+{
+	FString Name;
+	/** Expected JSON type, or EJson::None to accept any value */
+	EJson Type;
+};
+
+/**
+ * A registered command and how it has to be run.
+ * Registration returns it so the metadata can be chained on:
+ *
+ *     Registry.Register(TEXT("delete_actor"), Handler).Require(TEXT("name"));
+ */
+struct UNREALMCP_API FMCPCommandInfo
+{
+	FName Name;
+	FMCPCommandHandler Handler;
+	/** Set for commands whose potentially large result is streamed instead of built as a DOM */
+	FMCPStreamedCommandHandler StreamedHandler;
+	/** Commands touching UObjects must run on the game thread; the rest run on the calling worker */
+	bool bGameThread = true;
+	/** Leaves the level, assets and project settings unchanged */
+	bool bReadOnly = false;
+	/** How long a worker waits for the game thread to run the command */
+	float TimeoutSeconds = 5.0f;
+	/** Mutation unless set; read-only commands default to Interactive */
+	EMCPCommandPriority PriorityClass = EMCPCommandPriority::Mutation;
+	TArray<FMCPCommandParam> RequiredParams;
+
+	FMCPCommandInfo& AnyThread() { bGameThread = false; return *this; }
+	FMCPCommandInfo& ReadOnly();
+	FMCPCommandInfo& Timeout(float Seconds) { TimeoutSeconds = Seconds; return *this; }
+	FMCPCommandInfo& Priority(EMCPCommandPriority InPriority) { PriorityClass = InPriority; return *this; }
+	FMCPCommandInfo& Require(const TCHAR* ParamName, EJson Type = EJson::String);
+	FMCPCommandInfo& Streamed(FMCPStreamedCommandHandler InStreamedHandler);
+
+	/** Checks Params against RequiredParams; on failure describes the first problem in OutError */
+	bool ValidateParams(const TSharedPtr<FJsonObject>& Params, FString& OutError) const;
+};
+
+/**
+ * Commands by name, so dispatch is a single hash lookup.
+ * Each handler class registers its own commands when the bridge is created; the
+ * registry is not modified afterwards, so lookups are safe from any thread.
+ */
+class UNREALMCP_API FMCPCommandRegistry
+{
+public:
+	/**
+	 * Adds a command, replacing an earlier one of the same name. The returned reference
+	 * is only valid until the next registration.
+	 */
+	FMCPCommandInfo& Register(const TCHAR* Name, FMCPCommandHandler Handler);
+
+	/** Null for unknown commands. Names never seen before are not added to the name table. */
+	const FMCPCommandInfo* Find(const FString& Name) const;
+
+	int32 Num() const { return Commands.Num(); }
+
+private:
+	TMap<FName, FMCPCommandInfo> Commands;
+};
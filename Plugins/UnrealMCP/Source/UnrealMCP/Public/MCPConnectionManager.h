@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPTransport.h"
+
+class UUnrealMCPBridge;
+class FMCPClientConnection;
+class FRunnableThread;
+class FQueuedThreadPool;
+
+/**
+ * Owns the active client sessions.
+ * Each accepted client gets a worker thread from a bounded set; clients
+ * beyond the limit are told the server is busy and disconnected. Pipelined
+ * requests from every session share two bounded request pools: a small one
+ * for interactive reads and one for mutations and bulk work, so reads never
+ * wait for a worker held by a long command.
+ */
+class FMCPConnectionManager
+{
+public:
+	FMCPConnectionManager(UUnrealMCPBridge* InBridge, int32 InMaxConnections, int32 InNumRequestWorkers, int32 InNumInteractiveWorkers);
+	~FMCPConnectionManager();
+
+	/** Starts serving an accepted client. Returns false if the client was rejected. */
+	bool AddConnection(TSharedPtr<FMCPTransport> ClientTransport);
+
+	/** Stops every session and waits for the worker threads to exit */
+	void StopAll();
+
+	int32 GetNumActiveConnections();
+
+private:
+	struct FConnectionSlot
+	{
+		TSharedPtr<FMCPClientConnection> Connection;
+		FRunnableThread* Thread = nullptr;
+	};
+
+	/** Reclaims worker threads whose sessions have ended. Caller must hold ConnectionsLock. */
+	void ReapFinishedConnections();
+
+	UUnrealMCPBridge* Bridge;
+	int32 MaxConnections;
+	int32 NextConnectionId;
+	bool bAcceptingConnections;
+	FQueuedThreadPool* RequestPool;
+	FQueuedThreadPool* InteractivePool;
+	TArray<FConnectionSlot> Connections;
+	FCriticalSection ConnectionsLock;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "HAL/Event.h"
+#include "MCPActorIndex.h"
+
+class FMCPSceneChangeLog;
+class UBlueprint;
+class UPackage;
+class FObjectPostSaveContext;
+
+/** Editor events clients can subscribe to */
+enum class EMCPEditorEvent : uint8
+{
+	ActorAdded,
+	ActorRemoved,
+	/** Sent once per actor per frame, with the transform it ended the frame with */
+	ActorMoved,
+	/** The editor world was replaced, e.g. by loading a map; actors known before are gone */
+	LevelChanged,
+	SelectionChanged,
+	BlueprintCompiled,
+	AssetSaved,
+	PieStarted,
+	PieStopped,
+	Num
+};
+
+/**
+ * One client's subscription: the events it wants and those waiting to be sent to it.
+ * The hub pushes events on the game thread, and every push wakes the thread that sends
+ * them to the client. A client that stops reading only fills its own queue, after which
+ * its events are counted and dropped instead of piling up.
+ */
+class UNREALMCP_API FMCPEventSubscription
+{
+public:
+	explicit FMCPEventSubscription(int32 InMaxPendingEvents);
+
+	/** One bit per EMCPEditorEvent */
+	uint32 GetEventMask() const { return EventMask; }
+	void SetEventMask(uint32 InEventMask) { EventMask = InEventMask; }
+	bool IsSubscribed(EMCPEditorEvent Event) const { return (EventMask.Load() & (1u << (uint32)Event)) != 0; }
+
+	/** Queues an event message, or drops it when the client is too far behind */
+	void Push(const TSharedPtr<FJsonObject>& Message);
+	/** Takes the queued messages and the number dropped since the last call */
+	void TakePending(TArray<TSharedPtr<FJsonObject>>& OutMessages, int32& OutDropped);
+
+	/** Blocks until something was pushed since the last wait, or Wake is called */
+	void WaitForEvents() { EventsPushed->Wait(); }
+	/** Releases a thread blocked in WaitForEvents, e.g. to stop it */
+	void Wake() { EventsPushed->Trigger(); }
+
+private:
+	TAtomic<uint32> EventMask;
+	int32 MaxPendingEvents;
+
+	FCriticalSection PendingLock;
+	TArray<TSharedPtr<FJsonObject>> PendingMessages;
+	int32 DroppedEvents;
+
+	FEventRef EventsPushed;
+};
+
+/**
+ * Turns editor events into messages for the subscribed clients.
+ * Editor delegates are only bound while some client wants their events. Events are
+ * collected over a frame and handed to the subscriptions at its end, so an actor dragged
+ * through many positions in one frame yields a single actor_moved. Actor events carry the
+ * scene change log's version, so a client that missed some can catch up with
+ * get_scene_changes_since.
+ */
+class UNREALMCP_API FMCPEventHub
+{
+public:
+	FMCPEventHub();
+	~FMCPEventHub();
+
+	/** Sets where actor events come from. Call once, before Start. */
+	void Init(FMCPActorIndex& InActorIndex, FMCPSceneChangeLog& InSceneChanges);
+
+	/** Starts delivering events at the end of every frame. Game thread only. */
+	void Start();
+	/** Stops delivering, unbinds from the editor and forgets every subscription. Game thread only. */
+	void Stop();
+
+	/** Safe to call from any thread; takes effect from the next frame */
+	void AddSubscription(const TSharedRef<FMCPEventSubscription>& Subscription);
+	void RemoveSubscription(const TSharedRef<FMCPEventSubscription>& Subscription);
+
+	/** Name of an event in subscribe requests and event messages, e.g. "actor_moved" */
+	static const TCHAR* GetEventName(EMCPEditorEvent Event);
+	static bool FindEvent(const FString& Name, EMCPEditorEvent& OutEvent);
+
+private:
+	struct FPendingEvent
+	{
+		EMCPEditorEvent Event;
+		TSharedPtr<FJsonObject> Message;
+	};
+
+	void OnEndFrame();
+	void BindEditorEvents();
+	void UnbindEditorEvents();
+	bool IsWanted(EMCPEditorEvent Event) const { return (WantedEvents & (1u << (uint32)Event)) != 0; }
+	void AddEvent(EMCPEditorEvent Event, const TSharedPtr<FJsonObject>& Data);
+	/** Data of an actor event: the actor's state, or just its name once it is gone */
+	TSharedPtr<FJsonObject> MakeActorData(AActor* Actor, FName ActorName) const;
+
+	void OnActorChanged(EMCPActorChange Change, AActor* Actor, FName ActorName);
+	void OnSelectionChanged(UObject* Selection);
+	void OnBlueprintPreCompile(UBlueprint* Blueprint);
+	void OnBlueprintCompiled();
+	void OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext);
+	void OnPostPIEStarted(bool bIsSimulating);
+	void OnEndPIE(bool bIsSimulating);
+
+	/** Null until Init */
+	FMCPActorIndex* ActorIndex;
+	FMCPSceneChangeLog* SceneChanges;
+
+	FCriticalSection SubscriptionsLock;
+	TArray<TSharedRef<FMCPEventSubscription>> Subscriptions;
+
+	/** Union of the subscriptions' masks as of the last frame */
+	uint32 WantedEvents;
+	bool bBound;
+
+	/** Events of the current frame, in the order they happened */
+	TArray<FPendingEvent> PendingEvents;
+	/** Actors moved during the current frame, reported once each at its end */
+	TMap<FName, TWeakObjectPtr<AActor>> PendingMoves;
+	bool bSelectionChanged;
+	/** Blueprints compiled since the last compile finished */
+	TArray<TWeakObjectPtr<UBlueprint>> CompilingBlueprints;
+
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle ActorChangedHandle;
+	FDelegateHandle SelectionChangedHandle;
+	FDelegateHandle BlueprintPreCompileHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+	FDelegateHandle PackageSavedHandle;
+	FDelegateHandle PostPIEStartedHandle;
+	FDelegateHandle EndPIEHandle;
+};
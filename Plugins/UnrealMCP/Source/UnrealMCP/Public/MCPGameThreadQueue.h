@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "MCPCommandRegistry.h"
+
+/** Counters of one priority lane; times in milliseconds */
+struct FMCPGameThreadLaneStats
+{
+	int32 Depth = 0;
+	int32 PeakDepth = 0;
+	/** Admission limit: items beyond this many queued are rejected */
+	int32 MaxDepth = 0;
+	uint64 ItemsRun = 0;
+	uint64 ItemsRejected = 0;
+	/** Time the last and the slowest item spent queued before it started */
+	double LastWaitMs = 0.0;
+	double MaxWaitMs = 0.0;
+};
+
+/** Counters of an FMCPGameThreadQueue; times in milliseconds */
+struct FMCPGameThreadQueueStats
+{
+	int32 Depth = 0;
+	int32 PeakDepth = 0;
+	float BudgetMs = 0.0f;
+	uint64 ItemsRun = 0;
+	/** Frames that ran at least one item */
+	uint64 BusyFrames = 0;
+	/** Busy frames that ran past the budget, because a single item took longer than what was left */
+	uint64 OverrunFrames = 0;
+	double LastFrameMs = 0.0;
+	double MaxFrameMs = 0.0;
+	double MaxOverrunMs = 0.0;
+	double TotalOverrunMs = 0.0;
+	FMCPGameThreadLaneStats Lanes[(int32)EMCPCommandPriority::Num];
+};
+
+/** Whether Enqueue took the work */
+enum class EMCPEnqueueResult : uint8
+{
+	Queued,
+	/** The queue is stopped */
+	Stopped,
+	/** The work's lane is at its admission limit */
+	LaneFull
+};
+
+/**
+ * Game-thread work submitted by MCP worker threads.
+ * Drained from a core ticker, one item after another until the frame's time budget
+ * (console variable UnrealMCP.GameThreadBudgetMs) is spent, so a burst of commands
+ * is spread over several frames instead of stalling one. At least one item runs per
+ * frame; an item is never interrupted, so a slow one can still overrun the budget.
+ *
+ * Each priority class has its own lane with its own admission limit. Lanes are drained
+ * in priority order, so a queued interactive read starts before any queued mutation or
+ * bulk work; control items run every frame even once the budget is spent.
+ */
+class UNREALMCP_API FMCPGameThreadQueue
+{
+public:
+	FMCPGameThreadQueue();
+	~FMCPGameThreadQueue();
+
+	/** Starts accepting and draining work. Game thread only. */
+	void Start();
+
+	/** Stops accepting work and runs what is still queued at once. Game thread only. */
+	void Stop();
+
+	/** Queues Work in its priority's lane. Unless the result is Queued, Work is left untouched. */
+	EMCPEnqueueResult Enqueue(TUniqueFunction<void()>&& Work, EMCPCommandPriority Priority);
+
+	FMCPGameThreadQueueStats GetStats() const;
+
+private:
+	struct FQueuedItem
+	{
+		TUniqueFunction<void()> Work;
+		double EnqueueTime = 0.0;
+	};
+
+	bool Tick(float DeltaTime);
+	/** Runs queued items until the queue is empty or, when given, the deadline passes */
+	int32 Drain(double Deadline);
+	/** Takes the next item from the highest-priority lane that has one; control only once over budget */
+	bool DequeueNext(bool bWithinBudget, FQueuedItem& OutItem, int32& OutLane);
+
+	TQueue<FQueuedItem, EQueueMode::Mpsc> Lanes[(int32)EMCPCommandPriority::Num];
+	FTSTicker::FDelegateHandle TickerHandle;
+	/** Taken to enqueue and to stop, so nothing is queued after the final drain */
+	FCriticalSection AcceptLock;
+	bool bAccepting;
+
+	mutable FCriticalSection StatsLock;
+	FMCPGameThreadQueueStats Stats;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "HAL/Event.h"
+#include "Containers/List.h"
+#include "MCPResponseWriter.h"
+
+class FMCPJobManager;
+
+enum class EMCPJobState : uint8
+{
+	Queued,
+	Running,
+	Succeeded,
+	Failed,
+	Cancelled
+};
+
+/** One command run in the background; its response is kept until the job expires */
+class UNREALMCP_API FMCPJob
+{
+public:
+	FMCPJob(const FString& InId, const FString& InCommandType, FMCPJobManager& InManager);
+
+	const FString& GetId() const { return Id; }
+	EMCPJobState GetState() const { return State; }
+	bool IsFinished() const;
+
+	/** Marks a queued job as running; false if it was cancelled first */
+	bool TryStart();
+	/** Cancels a job that has not started yet; false once it has */
+	bool TryCancel();
+	/** Stores the command's response envelope and wakes every waiter */
+	void Finish(const TSharedPtr<FJsonObject>& InResponse);
+	/** Succeeds with a streamed command's result writer instead of a result object */
+	void FinishStreamed(const FMCPResultWriter& InResultWriter);
+	/** True if the job finished within Timeout */
+	bool Wait(FTimespan Timeout);
+
+	/** The response envelope once finished, null before and for streamed results */
+	TSharedPtr<FJsonObject> GetResponse() const;
+	/** A streamed command's result writer once it succeeded, unset otherwise */
+	FMCPResultWriter GetResultWriter() const;
+	/** Seconds since the job finished, or 0 while it runs */
+	double GetSecondsSinceFinished() const;
+	/** Status as reported by get_job_status, with the result or error once finished */
+	TSharedPtr<FJsonObject> ToJson() const;
+
+private:
+	friend class FMCPJobManager;
+
+	/** Files the job with its manager as finished, before any waiter is woken */
+	void NotifyFinished();
+
+	FString Id;
+	FString CommandType;
+	FMCPJobManager& Manager;
+	double SubmitTime;
+	TAtomic<EMCPJobState> State;
+	FEventRef FinishedEvent;
+
+	mutable FCriticalSection ResponseLock;
+	TSharedPtr<FJsonObject> Response;
+	FMCPResultWriter ResultWriter;
+	double FinishTime;
+
+	/** The job's place among the manager's finished jobs, null until then; guarded by the manager's lock */
+	TDoubleLinkedList<FString>::TDoubleLinkedListNode* FinishedNode;
+};
+
+/**
+ * Jobs by id.
+ * Finished jobs are kept for a bounded time, and only so many of them, for
+ * clients to collect; unfinished jobs are always kept.
+ */
+class UNREALMCP_API FMCPJobManager
+{
+public:
+	FMCPJobManager();
+
+	/** Sets how long finished jobs are kept, and how many at most. Call before the first job is created. */
+	void Init(double InRetentionSeconds, int32 InMaxFinishedJobs);
+
+	TSharedRef<FMCPJob> CreateJob(const FString& CommandType);
+	/** Null for unknown and expired jobs */
+	TSharedPtr<FMCPJob> FindJob(const FString& Id);
+	/** Forgets a job whose result was already handed back to its caller */
+	void RemoveJob(const FString& Id);
+
+private:
+	friend class FMCPJob;
+
+	/** Queues a job that just finished for expiry */
+	void OnJobFinished(const FString& Id);
+	/** Expires the oldest finished jobs while past their retention or beyond the limit. Caller must hold JobsLock. */
+	void PruneFinishedJobs();
+
+	double RetentionSeconds;
+	int32 MaxFinishedJobs;
+	uint64 NextJobNumber;
+	TMap<FString, TSharedRef<FMCPJob>> Jobs;
+	/** Ids of the finished jobs in Jobs, in the order they finished */
+	TDoubleLinkedList<FString> FinishedJobIds;
+	FCriticalSection JobsLock;
+};
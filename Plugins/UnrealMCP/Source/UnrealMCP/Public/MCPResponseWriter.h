@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+class FArchive;
+class FJsonObject;
+class FJsonValue;
+
+/** Writes compact UTF-8 JSON straight into a response stream */
+typedef TJsonWriter<UTF8CHAR, TCondensedJsonPrintPolicy<UTF8CHAR>> FMCPJsonWriter;
+typedef TJsonWriterFactory<UTF8CHAR, TCondensedJsonPrintPolicy<UTF8CHAR>> FMCPJsonWriterFactory;
+
+/** Payload encodings a session can negotiate with 'hello' */
+enum class EMCPPayloadEncoding : uint8
+{
+	Json,
+	Cbor
+};
+
+/**
+ * Writes a response in the session's payload encoding.
+ * Follows the shape of TJsonWriter, so a streamed result is written once and
+ * comes out as JSON or CBOR depending on what the client negotiated.
+ */
+class FMCPResponseWriter
+{
+public:
+	virtual ~FMCPResponseWriter() {}
+
+	virtual void WriteObjectStart() = 0;
+	virtual void WriteObjectStart(FStringView Identifier) = 0;
+	virtual void WriteObjectEnd() = 0;
+	virtual void WriteArrayStart() = 0;
+	virtual void WriteArrayStart(FStringView Identifier) = 0;
+	virtual void WriteArrayEnd() = 0;
+
+	virtual void WriteNumber(double Value) = 0;
+	virtual void WriteNumber(FStringView Identifier, double Value) = 0;
+	virtual void WriteString(FStringView Value) = 0;
+	virtual void WriteString(FStringView Identifier, FStringView Value) = 0;
+	virtual void WriteBool(FStringView Identifier, bool bValue) = 0;
+
+	/** Writes an existing DOM value, such as a field taken from the request */
+	virtual void WriteJsonValue(FStringView Identifier, const TSharedPtr<FJsonValue>& Value) = 0;
+	virtual void WriteJsonObject(const TSharedPtr<FJsonObject>& Object) = 0;
+
+	/** Completes the message once the outermost object has been closed */
+	virtual void Close() = 0;
+
+	/** Creates a writer that encodes into Archive */
+	static TUniquePtr<FMCPResponseWriter> Create(EMCPPayloadEncoding Encoding, FArchive& Archive);
+};
+
+/**
+ * Writes the fields of a command's "result" object directly into the response.
+ * Runs on the connection's worker thread once any game-thread work is done, so
+ * it may only read data it owns, and it cannot fail: part of the response may
+ * already be on the wire by the time it returns.
+ */
+typedef TFunction<void(FMCPResponseWriter& Writer)> FMCPResultWriter;
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/RingBuffer.h"
+#include "MCPActorIndex.h"
+
+/** One entry of the scene change log */
+struct FMCPSceneChange
+{
+	uint64 Version = 0;
+	EMCPActorChange Change = EMCPActorChange::Modified;
+	FName ActorName;
+	/** Null once the actor is gone */
+	TWeakObjectPtr<AActor> Actor;
+};
+
+/**
+ * The editor world's changes, numbered with a version that only ever grows.
+ * Fed by the actor index; keeps the most recent changes only, so a client that falls
+ * too far behind, or that saw a world that has since been replaced, must resync.
+ * Versions start from the wall clock, so they also keep growing across editor sessions.
+ * Game thread only.
+ */
+class UNREALMCP_API FMCPSceneChangeLog
+{
+public:
+	FMCPSceneChangeLog();
+	~FMCPSceneChangeLog();
+
+	/** Starts logging the changes the index reports, keeping the latest InCapacity of them */
+	void Init(FMCPActorIndex& InActorIndex, int32 InCapacity);
+
+	/** Version of the latest change */
+	uint64 GetVersion() const { return Version; }
+
+	/**
+	 * Appends the changes made after SinceVersion, oldest first. False if some of them are
+	 * no longer in the log, in which case the client has to fetch the whole scene again.
+	 */
+	bool GetChangesSince(uint64 SinceVersion, TArray<FMCPSceneChange>& OutChanges) const;
+
+private:
+	void OnActorChanged(EMCPActorChange Change, AActor* Actor, FName ActorName);
+
+	/** Null until Init */
+	FMCPActorIndex* ActorIndex;
+	FDelegateHandle ActorChangedHandle;
+
+	TRingBuffer<FMCPSceneChange> Changes;
+	int32 Capacity;
+	uint64 Version;
+	/** Clients older than this have missed changes: they rolled out of the log or the world was replaced */
+	uint64 ResyncVersion;
+};
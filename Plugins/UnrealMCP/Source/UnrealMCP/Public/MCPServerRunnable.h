@@ -6,14 +6,17 @@
 #include "Interfaces/IPv4/IPv4Address.h"
 
 class UUnrealMCPBridge;
+class FMCPConnectionManager;
+class FMCPListener;
 
 /**
  * Runnable class for the MCP server thread
+ * Accepts client connections from one listener and hands them to the connection manager.
  */
 class FMCPServerRunnable : public FRunnable
 {
 public:
-	FMCPServerRunnable(UUnrealMCPBridge* InBridge, TSharedPtr<FSocket> InListenerSocket);
+	FMCPServerRunnable(UUnrealMCPBridge* InBridge, TSharedPtr<FMCPListener> InListener, TSharedPtr<FMCPConnectionManager> InConnectionManager);
 	virtual ~FMCPServerRunnable();
 
 	// FRunnable interface
@@ -22,12 +25,9 @@ public:
 	virtual void Stop() override;
 	virtual void Exit() override;
 
-protected:
-	void HandleClientConnection(TSharedPtr<FSocket> ClientSocket);
-	void ProcessMessage(TSharedPtr<FSocket> Client, const TSharedPtr<FJsonObject>& JsonObject);
-
 private:
 	UUnrealMCPBridge* Bridge;
-	TSharedPtr<FSocket> ListenerSocket;
+	TSharedPtr<FMCPListener> Listener;
+	TSharedPtr<FMCPConnectionManager> ConnectionManager;
 	bool bRunning;
 }; 
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPTransport.h"
+
+// The shared-memory transport needs futexes on memory shared between processes
+#define MCP_WITH_SHARED_MEMORY PLATFORM_LINUX
+
+#if MCP_WITH_SHARED_MEMORY
+
+/** A mapped shared-memory segment; outlives the listener while a session still uses it */
+class FMCPSharedMemorySegment
+{
+public:
+	FMCPSharedMemorySegment(uint8* InBase, SIZE_T InSize, int64 InRingCapacity);
+	~FMCPSharedMemorySegment();
+
+	uint8* GetBase() const { return Base; }
+	/** Size of each ring as the server created it; the copy in the header is client-writable */
+	int64 GetRingCapacity() const { return RingCapacity; }
+
+private:
+	uint8* Base;
+	SIZE_T Size;
+	int64 RingCapacity;
+};
+
+/**
+ * Byte stream over a pair of single-producer single-consumer ring buffers in
+ * a shared-memory segment: one carries requests from the client, the other
+ * responses back. Each side sleeps on a futex doorbell only when its ring is
+ * empty (or full), and the server only makes the wake-up syscall when it sees
+ * a sleeper, so a busy stream costs it no syscalls at all.
+ *
+ * The segment is writable by the client, so the server keeps its own ring
+ * positions and checks the client's against them; a client that reports
+ * more data or space than a ring can hold ends its session.
+ */
+class FMCPSharedMemoryTransport : public FMCPTransport
+{
+public:
+	FMCPSharedMemoryTransport(TSharedRef<FMCPSharedMemorySegment> InSegment, int32 InSession, int32 InClientProcessId);
+	virtual ~FMCPSharedMemoryTransport();
+
+	virtual bool WaitForRead(FTimespan Timeout) override;
+	virtual bool Recv(uint8* Data, int32 Size, int32& BytesRead) override;
+	virtual bool Send(const uint8* Data, int32 Size, int32& BytesSent) override;
+	virtual bool IsConnected() override;
+	virtual void Shutdown(ESocketShutdownMode Mode) override;
+	virtual void Close() override;
+
+private:
+	/** True until either side ends the session */
+	bool IsClientAttached() const;
+	/** Checked when a wait times out, since a client that crashed never detaches */
+	bool IsClientProcessAlive() const;
+	/** Ends the session over ring positions no well-behaved client can produce */
+	void HandleCorruptRing(const TCHAR* RingName, int64 Value);
+
+	/** Marks a call using the rings; false once the session is shut down */
+	bool BeginRingAccess();
+	/** Ends it, handing the segment back if the session was shut down meanwhile */
+	void EndRingAccess();
+	/** Lets the next client claim the segment, once no call uses the rings any more */
+	void ReleaseSegment();
+
+	TSharedRef<FMCPSharedMemorySegment> Segment;
+	int32 Session;
+	int32 ClientProcessId;
+	int64 Capacity;
+	/** The server's own positions: bytes read from the requests, bytes written to the responses */
+	int64 RequestTail;
+	int64 ResponseHead;
+	TAtomic<bool> bShutdown;
+	TAtomic<int32> RingAccessCount;
+	TAtomic<bool> bReleased;
+};
+
+/**
+ * Listener on a named shared-memory segment (shm_open).
+ * The segment serves one session at a time: a client claims it, the listener
+ * accepts it, and it becomes free again when the session ends. The segment is
+ * created readable and writable by the editor's user only.
+ */
+class FMCPSharedMemoryListener : public FMCPListener
+{
+public:
+	/** Creates the segment, replacing one left behind by an earlier run. Returns null on failure. */
+	static TSharedPtr<FMCPSharedMemoryListener> Create(const FString& Name, int32 RingCapacity);
+	virtual ~FMCPSharedMemoryListener();
+
+	virtual bool WaitForConnection(FTimespan Timeout) override;
+	virtual TSharedPtr<FMCPTransport> Accept() override;
+	virtual void Stop() override;
+	virtual FString GetDescription() const override { return FString::Printf(TEXT("shm:%s"), *Name); }
+
+private:
+	FMCPSharedMemoryListener(TSharedRef<FMCPSharedMemorySegment> InSegment, const FString& InName);
+
+	TSharedRef<FMCPSharedMemorySegment> Segment;
+	FString Name;
+	TAtomic<bool> bStopped;
+};
+
+#endif
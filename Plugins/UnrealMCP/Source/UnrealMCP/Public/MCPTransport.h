@@ -0,0 +1,125 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Sockets.h"
+
+// Unix domain sockets are served on POSIX editor platforms only
+#define MCP_WITH_UNIX_SOCKETS (PLATFORM_LINUX || PLATFORM_MAC)
+
+/**
+ * Connected byte stream a client session runs over.
+ * Lets one session implementation serve TCP clients and, where available,
+ * Unix domain socket clients with the same framing and dispatch.
+ */
+class FMCPTransport
+{
+public:
+	virtual ~FMCPTransport() {}
+
+	/** Blocks until data (or end of stream) can be read, or the timeout expires */
+	virtual bool WaitForRead(FTimespan Timeout) = 0;
+	/** Reads up to Size bytes, blocking until all have arrived or the peer closes. False on error. */
+	virtual bool Recv(uint8* Data, int32 Size, int32& BytesRead) = 0;
+	/** Writes up to Size bytes, returning how many were accepted. False on error. */
+	virtual bool Send(const uint8* Data, int32 Size, int32& BytesSent) = 0;
+	virtual bool IsConnected() = 0;
+	/** Shuts down one or both directions; safe to call from another thread to wake a blocked reader */
+	virtual void Shutdown(ESocketShutdownMode Mode) = 0;
+	virtual void Close() = 0;
+};
+
+/**
+ * Listening endpoint that produces transports for accepted clients.
+ */
+class FMCPListener
+{
+public:
+	virtual ~FMCPListener() {}
+
+	/** Blocks until a client is waiting to be accepted, or the timeout expires */
+	virtual bool WaitForConnection(FTimespan Timeout) = 0;
+	/** Accepts a waiting client; null if it went away before it could be accepted */
+	virtual TSharedPtr<FMCPTransport> Accept() = 0;
+	/** Stops accepting and wakes a thread blocked in WaitForConnection */
+	virtual void Stop() = 0;
+	/** Where clients connect, for logging */
+	virtual FString GetDescription() const = 0;
+};
+
+/** Transport over an engine socket */
+class FMCPSocketTransport : public FMCPTransport
+{
+public:
+	explicit FMCPSocketTransport(TSharedPtr<FSocket> InSocket);
+
+	virtual bool WaitForRead(FTimespan Timeout) override;
+	virtual bool Recv(uint8* Data, int32 Size, int32& BytesRead) override;
+	virtual bool Send(const uint8* Data, int32 Size, int32& BytesSent) override;
+	virtual bool IsConnected() override;
+	virtual void Shutdown(ESocketShutdownMode Mode) override;
+	virtual void Close() override;
+
+private:
+	TSharedPtr<FSocket> Socket;
+};
+
+/** Listener over an engine TCP socket that is already bound and listening */
+class FMCPSocketListener : public FMCPListener
+{
+public:
+	FMCPSocketListener(TSharedPtr<FSocket> InListenerSocket, const FString& InDescription);
+
+	virtual bool WaitForConnection(FTimespan Timeout) override;
+	virtual TSharedPtr<FMCPTransport> Accept() override;
+	virtual void Stop() override;
+	virtual FString GetDescription() const override { return Description; }
+
+private:
+	TSharedPtr<FSocket> ListenerSocket;
+	FString Description;
+};
+
+#if MCP_WITH_UNIX_SOCKETS
+/** Transport over a connected Unix domain socket descriptor, which it owns */
+class FMCPUnixSocketTransport : public FMCPTransport
+{
+public:
+	explicit FMCPUnixSocketTransport(int32 InFileDescriptor);
+	virtual ~FMCPUnixSocketTransport();
+
+	virtual bool WaitForRead(FTimespan Timeout) override;
+	virtual bool Recv(uint8* Data, int32 Size, int32& BytesRead) override;
+	virtual bool Send(const uint8* Data, int32 Size, int32& BytesSent) override;
+	virtual bool IsConnected() override;
+	virtual void Shutdown(ESocketShutdownMode Mode) override;
+	virtual void Close() override;
+
+private:
+	TAtomic<int32> FileDescriptor;
+};
+
+/**
+ * Listener on a Unix domain socket path.
+ * The socket file is created readable and writable by the editor's user only,
+ * so access is controlled by filesystem permissions; it is removed on shutdown.
+ */
+class FMCPUnixSocketListener : public FMCPListener
+{
+public:
+	/** Binds and listens on Path, replacing a stale socket file. Returns null on failure. */
+	static TSharedPtr<FMCPUnixSocketListener> Create(const FString& Path, int32 Backlog);
+	virtual ~FMCPUnixSocketListener();
+
+	virtual bool WaitForConnection(FTimespan Timeout) override;
+	virtual TSharedPtr<FMCPTransport> Accept() override;
+	virtual void Stop() override;
+	virtual FString GetDescription() const override { return Path; }
+
+private:
+	FMCPUnixSocketListener(int32 InFileDescriptor, const FString& InPath);
+
+	int32 FileDescriptor;
+	FString Path;
+	TAtomic<bool> bStopped;
+};
+#endif
@@ -8,6 +8,13 @@
 #include "Json.h"
 #include "Interfaces/IPv4/IPv4Address.h"
 #include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "MCPResponseWriter.h"
+#include "MCPCommandRegistry.h"
+#include "MCPGameThreadQueue.h"
+#include "MCPJobManager.h"
+#include "MCPActorIndex.h"
+#include "MCPSceneChangeLog.h"
+#include "MCPEventHub.h"
 #include "Commands/UnrealMCPEditorCommands.h"
 #include "Commands/UnrealMCPBlueprintCommands.h"
 #include "Commands/UnrealMCPBlueprintNodeCommands.h"
@@ -16,11 +23,21 @@
 #include "UnrealMCPBridge.generated.h"
 
 class FMCPServerRunnable;
+class FMCPConnectionManager;
+class FMCPListener;
+
+/** Accept thread of one listener */
+struct FMCPListenerThread
+{
+	FMCPServerRunnable* Runnable = nullptr;
+	FRunnableThread* Thread = nullptr;
+};
 
 /**
  * Editor subsystem for MCP Bridge
  * Handles communication between external tools and the Unreal Editor
- * through a TCP socket connection. Commands are received as JSON and
+ * through a TCP socket connection, or a Unix domain socket or shared-memory
+ * rings for same-host clients where available. Commands are received as JSON and
  * routed to appropriate command handlers.
  */
 UCLASS()
@@ -40,25 +57,88 @@ public:
 	void StartServer();
 	void StopServer();
 	bool IsRunning() const { return bIsRunning; }
+	/** Where the TCP listener accepts clients */
+	FIPv4Endpoint GetServerEndpoint() const { return FIPv4Endpoint(ServerAddress, Port); }
 
 	// Command execution
 	FString ExecuteCommand(const FString& CommandType, const TSharedPtr<FJsonObject>& Params);
+	/** Same as ExecuteCommand but returns the response envelope unserialized. Safe to call from any thread. */
+	TSharedPtr<FJsonObject> ExecuteCommandJson(const FString& CommandType, const TSharedPtr<FJsonObject>& Params);
+
+	/** Every command the bridge serves; filled in by the constructor and read-only afterwards */
+	const FMCPCommandRegistry& GetCommandRegistry() const { return CommandRegistry; }
+
+	/** The editor world's actors by name, label and class. Game thread only. */
+	FMCPActorIndex& GetActorIndex() { return ActorIndex; }
+	/** Recent changes of the editor world, by version. Game thread only. */
+	FMCPSceneChangeLog& GetSceneChanges() { return SceneChanges; }
+	/** Editor events pushed to subscribed client sessions */
+	FMCPEventHub& GetEventHub() { return EventHub; }
+
+	/** True for commands whose potentially large result can be streamed instead of built as a DOM */
+	bool SupportsStreamedResult(const FString& CommandType) const;
+	/**
+	 * Runs a streamable command. On success returns null and sets OutResultWriter, which
+	 * writes the result once called from the worker thread; otherwise returns an error envelope.
+	 */
+	TSharedPtr<FJsonObject> ExecuteCommandStreamed(const FString& CommandType, const TSharedPtr<FJsonObject>& Params, FMCPResultWriter& OutResultWriter);
 
 private:
+	void StartLocalListeners();
+	void StartLocalListener(TSharedPtr<FMCPListener> Listener, const TCHAR* ThreadName);
+
+	/** Runs a command's handler on the current thread and wraps its result in a response envelope */
+	TSharedPtr<FJsonObject> RunCommand(const FMCPCommandInfo& Command, const TSharedPtr<FJsonObject>& Params);
+	/** Runs the sub-commands of a "batch" request in order, on the game thread */
+	TSharedPtr<FJsonObject> HandleBatch(const TSharedPtr<FJsonObject>& Params);
+	/**
+	 * Creates a job for the command and queues it for the game thread, or runs it at once if it may
+	 * run anywhere. A streamed job runs the command's streamed handler and keeps its result writer.
+	 */
+	TSharedRef<FMCPJob> StartJob(const FMCPCommandInfo& Command, const TSharedPtr<FJsonObject>& Params, bool bStreamed = false);
+	/** Runs a started job's command on the current thread and finishes the job with its outcome */
+	void RunJob(FMCPJob& Job, const FMCPCommandInfo& Command, const TSharedPtr<FJsonObject>& Params, bool bStreamed);
+	/** "start_job": validates the wrapped command and returns its job id without waiting for it */
+	TSharedPtr<FJsonObject> HandleStartJob(const TSharedPtr<FJsonObject>& Params);
+	/** "get_job_status": a job's state, optionally waiting a while for it to finish */
+	TSharedPtr<FJsonObject> HandleGetJobStatus(const TSharedPtr<FJsonObject>& Params);
+	/** "cancel_job": cancels a job that has not started yet */
+	TSharedPtr<FJsonObject> HandleCancelJob(const TSharedPtr<FJsonObject>& Params);
+
 	// Server state
 	bool bIsRunning;
 	TSharedPtr<FSocket> ListenerSocket;
 	TSharedPtr<FSocket> ConnectionSocket;
 	FRunnableThread* ServerThread;
+	FMCPServerRunnable* ServerRunnable;
+	/** Accept threads of the optional same-host listeners (Unix socket, shared memory) */
+	TArray<FMCPListenerThread> LocalListenerThreads;
+	TSharedPtr<FMCPConnectionManager> ConnectionManager;
 
 	// Server configuration
 	FIPv4Address ServerAddress;
 	uint16 Port;
 
+	// Editor-world actors by name, label and class; shared by the command handlers
+	FMCPActorIndex ActorIndex;
+	// Versioned log of what changed in the editor world, fed by the actor index
+	FMCPSceneChangeLog SceneChanges;
+	// Editor events for the sessions that subscribed to them, delivered once per frame
+	FMCPEventHub EventHub;
+
 	// Command handler instances
 	TSharedPtr<FUnrealMCPEditorCommands> EditorCommands;
 	TSharedPtr<FUnrealMCPBlueprintCommands> BlueprintCommands;
 	TSharedPtr<FUnrealMCPBlueprintNodeCommands> BlueprintNodeCommands;
 	TSharedPtr<FUnrealMCPProjectCommands> ProjectCommands;
 	TSharedPtr<FUnrealMCPUMGCommands> UMGCommands;
+
+	// Command name to handler and metadata
+	FMCPCommandRegistry CommandRegistry;
+
+	// Game-thread work from the request workers, run within a per-frame time budget
+	FMCPGameThreadQueue GameThreadQueue;
+
+	// Game-thread commands that outlive their caller's wait, and those started with start_job
+	FMCPJobManager JobManager;
 }; 
\ No newline at end of file
@@ -0,0 +1,94 @@
+#!/usr/bin/env python
+"""
+Cost of running many commands one at a time against a single batch.
+
+Sends --count copies of a command to a running editor three ways and reports
+the wall time of each:
+
+  - sequential: one request per command, each waiting for its response
+  - pipelined:  one request per command, all in flight at once (send_commands)
+  - batch:      one `batch` request holding every command
+
+Each sequential or pipelined request costs its own game-thread hop, while the
+batch runs all of them in one game-thread slice. The default command,
+find_actors_by_name with a pattern nothing matches, runs on the game thread
+without changing the level; pass --command and --params to measure real
+edits instead, e.g.
+
+    --command set_actor_transform --params '{"name": "Cube", "location": [0, 0, 100]}'
+
+Usage:
+    python bench_batch.py [--count 200] [--rounds 5]
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+from unreal_mcp_server import UnrealConnection
+
+
+def best_of(rounds: int, run) -> float:
+    """Fastest of several runs, in milliseconds."""
+    best = float("inf")
+    for _ in range(rounds):
+        start = time.perf_counter()
+        run()
+        best = min(best, (time.perf_counter() - start) * 1000.0)
+    return best
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--count", type=int, default=200, help="commands per run (a batch holds at most 1000)")
+    parser.add_argument("--rounds", type=int, default=5)
+    parser.add_argument("--command", default="find_actors_by_name")
+    parser.add_argument("--params", default='{"pattern": "__mcp_bench_no_match__"}', help="JSON object of command parameters")
+    args = parser.parse_args()
+
+    params = json.loads(args.params)
+    commands = [(args.command, params)] * args.count
+    batch = {"commands": [{"command": args.command, "params": params}] * args.count, "on_error": "continue"}
+
+    connection = UnrealConnection()
+    if not connection.connect():
+        print("Could not connect to Unreal Engine")
+        return 1
+
+    try:
+        # Check the command works once before timing anything
+        response = connection.send_command("batch", batch)
+        if response.get("status") == "error":
+            print(f"batch failed: {response.get('error')}")
+            return 1
+        failed = response.get("result", {}).get("failed", 0)
+        if failed:
+            print(f"warning: {failed} of {args.count} commands failed inside the batch")
+
+        def sequential():
+            for command, command_params in commands:
+                connection.send_command(command, command_params)
+
+        timings = {
+            "sequential": best_of(args.rounds, sequential),
+            "pipelined": best_of(args.rounds, lambda: connection.send_commands(commands)),
+            "batch": best_of(args.rounds, lambda: connection.send_command("batch", batch)),
+        }
+    finally:
+        connection.disconnect()
+
+    print(f"{args.count} x {args.command}, best of {args.rounds}:")
+    for label, milliseconds in timings.items():
+        print(f"  {label:<10} {milliseconds:9.1f} ms   {milliseconds * 1000.0 / args.count:8.1f} us/command")
+    print(f"  batch is {timings['sequential'] / timings['batch']:.1f}x sequential, "
+          f"{timings['pipelined'] / timings['batch']:.1f}x pipelined")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+"""
+Benchmark for connection setup latency against the Unreal MCP plugin.
+
+Each sample opens a fresh TCP connection, sends a framed `ping` and measures
+the time from the start of connect() until the first byte of the response
+arrives. The plugin must wake on a new connection immediately rather than on
+a polling interval, so on loopback the p50 is expected to stay under 1 ms.
+
+Usage:
+    python bench_connect_latency.py [--samples 500] [--host 127.0.0.1] [--port 55557]
+"""
+
+import argparse
+import json
+import socket
+import statistics
+import struct
+import sys
+import time
+
+P50_TARGET_MS = 1.0
+
+
+def measure_once(host: str, port: int, request: bytes) -> float:
+    """Return the connect-to-first-byte time of one ping in milliseconds."""
+    start = time.perf_counter()
+    sock = socket.create_connection((host, port), timeout=10)
+    try:
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        sock.sendall(request)
+        first = sock.recv(1)
+        elapsed = (time.perf_counter() - start) * 1000.0
+        if not first:
+            raise ConnectionError("Connection closed before the response arrived")
+
+        # Drain the rest of the frame so the session ends cleanly
+        header = first + sock.recv(3, socket.MSG_WAITALL)
+        remaining = struct.unpack('<I', header)[0]
+        while remaining > 0:
+            chunk = sock.recv(remaining)
+            if not chunk:
+                break
+            remaining -= len(chunk)
+        return elapsed
+    finally:
+        sock.close()
+
+
+def percentile(values, fraction: float) -> float:
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(fraction * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=55557)
+    parser.add_argument("--samples", type=int, default=500)
+    parser.add_argument("--warmup", type=int, default=20)
+    args = parser.parse_args()
+
+    payload = json.dumps({"command": "ping", "params": {}}).encode('utf-8')
+    request = struct.pack('<I', len(payload)) + payload
+
+    for _ in range(args.warmup):
+        measure_once(args.host, args.port, request)
+
+    samples = [measure_once(args.host, args.port, request) for _ in range(args.samples)]
+
+    p50 = percentile(samples, 0.50)
+    print(f"samples: {len(samples)}")
+    print(f"min:  {min(samples):.3f} ms")
+    print(f"mean: {statistics.mean(samples):.3f} ms")
+    print(f"p50:  {p50:.3f} ms")
+    print(f"p95:  {percentile(samples, 0.95):.3f} ms")
+    print(f"p99:  {percentile(samples, 0.99):.3f} ms")
+    print(f"max:  {max(samples):.3f} ms")
+
+    if p50 >= P50_TARGET_MS:
+        print(f"FAIL: p50 {p50:.3f} ms is not under {P50_TARGET_MS} ms")
+        return 1
+    print(f"PASS: p50 under {P50_TARGET_MS} ms")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
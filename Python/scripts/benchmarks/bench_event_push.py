@@ -0,0 +1,109 @@
+#!/usr/bin/env python
+"""
+How soon a client learns about a change: pushed events against polling.
+
+Spawns a probe actor and moves it --moves times from one session. A second
+session subscribed to actor_moved measures how long each move takes to arrive
+as an event; a third polls get_scene_changes_since every --poll-interval
+seconds and measures the same, along with the requests that polling cost.
+Pushed moves should arrive within about one editor frame, with no requests
+sent between changes.
+
+Usage:
+    python bench_event_push.py [--moves 100] [--poll-interval 0.1]
+"""
+
+import argparse
+import os
+import statistics
+import sys
+import threading
+import time
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+from unreal_mcp_server import UnrealConnection, UnrealEventStream
+
+PROBE_ACTOR = "MCPBenchEventProbe"
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--moves", type=int, default=100)
+    parser.add_argument("--interval", type=float, default=0.05, help="Seconds between moves")
+    parser.add_argument("--poll-interval", type=float, default=0.1)
+    args = parser.parse_args()
+
+    mover, poller, stream = UnrealConnection(), UnrealConnection(), UnrealEventStream()
+    if not mover.connect() or not poller.connect() or not stream.connect():
+        print("Could not connect to Unreal Engine")
+        return 1
+
+    spawned = mover.send_command("spawn_actor", {"name": PROBE_ACTOR, "type": "StaticMeshActor"})
+    if spawned.get("status") != "success":
+        print(f"Could not spawn the probe actor: {spawned.get('error')}")
+        return 1
+
+    moved_at = {}
+    push_latencies, poll_latencies = [], []
+    poll_requests = 0
+    stop = threading.Event()
+
+    def poll():
+        nonlocal poll_requests
+        listing = poller.send_command("get_actors_in_level", {"name": PROBE_ACTOR}).get("result", {})
+        version = listing.get("version", 0)
+        while not stop.is_set():
+            result = poller.send_command("get_scene_changes_since", {"version": version}).get("result", {})
+            poll_requests += 1
+            version = result.get("version", version)
+            for change in result.get("changes", []):
+                x = change.get("location", [None])[0]
+                if change.get("name") == PROBE_ACTOR and x in moved_at:
+                    poll_latencies.append((time.perf_counter() - moved_at.pop(x)) * 1000.0)
+            time.sleep(args.poll_interval)
+
+    try:
+        stream.subscribe(["actor_moved"])
+        polling = threading.Thread(target=poll, daemon=True)
+        polling.start()
+        time.sleep(0.5)
+
+        for index in range(args.moves):
+            x = float(index + 1)
+            start = time.perf_counter()
+            moved_at[x] = start
+            mover.send_command("set_actor_transform", {"name": PROBE_ACTOR, "location": [x, 0.0, 0.0]})
+
+            # Wait for this move's event, skipping any left over from earlier ones
+            deadline = start + 2.0
+            while time.perf_counter() < deadline:
+                events = stream.get_events(wait_seconds=deadline - time.perf_counter())["events"]
+                if any(event["data"].get("name") == PROBE_ACTOR and event["data"].get("location", [None])[0] == x
+                       for event in events):
+                    push_latencies.append((time.perf_counter() - start) * 1000.0)
+                    break
+            time.sleep(args.interval)
+
+        time.sleep(args.poll_interval * 2)
+        stop.set()
+        polling.join()
+    finally:
+        mover.send_command("delete_actor", {"name": PROBE_ACTOR})
+        mover.disconnect()
+        poller.disconnect()
+        stream.disconnect()
+
+    for label, samples in (("pushed", push_latencies), ("polled", poll_latencies)):
+        if not samples:
+            print(f"  {label}: no moves seen")
+            continue
+        print(f"  {label}: {len(samples)}/{args.moves} moves seen, median {statistics.median(samples):.2f} ms, "
+              f"max {max(samples):.2f} ms")
+    print(f"  polling sent {poll_requests} get_scene_changes_since requests; pushing sent none")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
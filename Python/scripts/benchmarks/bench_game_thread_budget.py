@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+"""
+Game-thread cost of a burst of MCP commands under the per-frame budget.
+
+Pipelines --count commands over one session while a second session polls
+get_queue_stats, then reports how the burst was spread over editor frames:
+peak queue depth, busy frames, the longest frame spent on MCP work, and how
+often and by how much frames overran UnrealMCP.GameThreadBudgetMs. Run it
+with different budgets (set the console variable in the editor) to trade
+command throughput against editor responsiveness.
+
+The default command, find_actors_by_name with a pattern nothing matches,
+does not change the level; pass --command and --params to measure real
+work such as spawns.
+
+Usage:
+    python bench_game_thread_budget.py [--count 2000]
+"""
+
+import argparse
+import json
+import os
+import sys
+import threading
+import time
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+from unreal_mcp_server import UnrealConnection
+
+
+def queue_stats(connection: UnrealConnection) -> dict:
+    response = connection.send_command("get_queue_stats", {})
+    if response.get("status") != "success":
+        raise RuntimeError(f"get_queue_stats failed: {response.get('error')}")
+    return response["result"]
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--count", type=int, default=2000)
+    parser.add_argument("--command", default="find_actors_by_name")
+    parser.add_argument("--params", default='{"pattern": "__mcp_bench_no_match__"}', help="JSON object of command parameters")
+    args = parser.parse_args()
+
+    worker, monitor = UnrealConnection(), UnrealConnection()
+    if not worker.connect() or not monitor.connect():
+        print("Could not connect to Unreal Engine")
+        return 1
+
+    try:
+        before = queue_stats(monitor)
+        peak_seen = 0
+        done = threading.Event()
+
+        def poll():
+            nonlocal peak_seen
+            while not done.is_set():
+                peak_seen = max(peak_seen, queue_stats(monitor)["depth"])
+                time.sleep(0.01)
+
+        poller = threading.Thread(target=poll, daemon=True)
+        poller.start()
+
+        start = time.perf_counter()
+        responses = worker.send_commands([(args.command, json.loads(args.params))] * args.count)
+        elapsed = time.perf_counter() - start
+        done.set()
+        poller.join()
+
+        after = queue_stats(monitor)
+    finally:
+        worker.disconnect()
+        monitor.disconnect()
+
+    failed = sum(1 for response in responses if response.get("status") == "error")
+    busy_frames = after["busy_frames"] - before["busy_frames"]
+    overrun_frames = after["overrun_frames"] - before["overrun_frames"]
+    overrun_ms = after["total_overrun_ms"] - before["total_overrun_ms"]
+
+    print(f"{args.count} x {args.command} with a {after['budget_ms']:g} ms budget:")
+    print(f"  {elapsed:.2f} s, {args.count / elapsed:.0f} commands/s, {failed} failed")
+    print(f"  queue depth seen up to {peak_seen} (peak since start {after['peak_depth']})")
+    print(f"  {busy_frames} busy frames, {args.count / max(busy_frames, 1):.1f} commands per frame")
+    print(f"  {overrun_frames} frames over budget, {overrun_ms:.1f} ms in total, "
+          f"longest MCP frame {after['max_frame_ms']:.2f} ms")
+    return 0 if failed == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,180 @@
+#!/usr/bin/env python
+"""
+Benchmark of JSON against CBOR payloads for a large actor listing.
+
+Builds a synthetic get_actors_in_level response for a level of --actors
+actors, encoded exactly as the plugin writes it in each encoding: condensed
+JSON with 17 significant digits per number, and CBOR with indefinite-length
+containers and the shortest exact number form. Reports the encoded size and
+the client-side decode time of each, plus encode time for the request
+direction. CBOR is decoded with cbor2 when it is installed and with the
+pure-Python decoder from unreal_mcp_server either way. Sizes after zlib
+compression of each 64 KB frame show what a compressed session sends.
+
+With --live the same comparison runs against a running editor: one session
+per encoding calls get_actors_in_level and reports response size and round
+trip time. Encode/decode cost inside the editor is measured there with the
+console command `UnrealMCP.BenchPayloadEncoding 10000`.
+
+Usage:
+    python bench_payload_encoding.py [--actors 10000] [--iterations 5] [--live]
+"""
+
+import argparse
+import json
+import os
+import random
+import struct
+import sys
+import time
+import zlib
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+import unreal_mcp_server
+from unreal_mcp_server import UnrealConnection, cbor_loads, cbor_dumps, _cbor_decode, _cbor_encode, _cbor_head
+
+
+def make_listing(actor_count: int) -> dict:
+    """A get_actors_in_level response with the layout of FUnrealMCPCommonUtils::ActorToJson."""
+    rng = random.Random(actor_count)
+    actors = []
+    for index in range(actor_count):
+        actors.append({
+            "name": f"StaticMeshActor_{index}",
+            "class": "StaticMeshActor",
+            "location": [rng.uniform(-50000.0, 50000.0), rng.uniform(-50000.0, 50000.0), rng.uniform(0.0, 5000.0)],
+            "rotation": [0.0, rng.uniform(-180.0, 180.0), 0.0],
+            "scale": [1.0, 1.0, 1.0],
+        })
+    return {"status": "success", "result": {"actors": actors}}
+
+
+def encode_plugin_json(value) -> str:
+    """Condensed JSON with numbers printed the way TJsonWriter prints doubles (%.17g)."""
+    if isinstance(value, dict):
+        return "{" + ",".join(f"{json.dumps(key)}:{encode_plugin_json(item)}" for key, item in value.items()) + "}"
+    if isinstance(value, list):
+        return "[" + ",".join(encode_plugin_json(item) for item in value) + "]"
+    if isinstance(value, float):
+        return format(value, ".17g")
+    return json.dumps(value)
+
+
+def encode_plugin_cbor(value, out: bytearray):
+    """CBOR as FMCPCborResponseWriter streams it: indefinite containers, shortest exact numbers."""
+    if isinstance(value, dict):
+        out.append(0xBF)
+        for key, item in value.items():
+            _cbor_encode(key, out)
+            encode_plugin_cbor(item, out)
+        out.append(0xFF)
+    elif isinstance(value, list):
+        out.append(0x9F)
+        for item in value:
+            encode_plugin_cbor(item, out)
+        out.append(0xFF)
+    elif isinstance(value, float):
+        if value.is_integer() and abs(value) < 2 ** 53:
+            integer = int(value)
+            _cbor_head(0, integer, out) if integer >= 0 else _cbor_head(1, -1 - integer, out)
+        elif struct.unpack('>f', struct.pack('>f', value))[0] == value:
+            out.append(0xFA)
+            out += struct.pack('>f', value)
+        else:
+            out.append(0xFB)
+            out += struct.pack('>d', value)
+    else:
+        _cbor_encode(value, out)
+
+
+def pure_cbor_loads(data):
+    return _cbor_decode(data, 0)[0]
+
+
+def time_call(function, argument, iterations: int) -> float:
+    """Mean wall time of function(argument) in milliseconds."""
+    function(argument)
+    start = time.perf_counter()
+    for _ in range(iterations):
+        function(argument)
+    return (time.perf_counter() - start) * 1000.0 / iterations
+
+
+def run_offline(actor_count: int, iterations: int):
+    listing = make_listing(actor_count)
+    json_bytes = encode_plugin_json(listing).encode('utf-8')
+    cbor_buffer = bytearray()
+    encode_plugin_cbor(listing, cbor_buffer)
+    cbor_bytes = bytes(cbor_buffer)
+
+    # Both encodings must decode to the same listing (floats may round-trip exactly either way)
+    assert pure_cbor_loads(cbor_bytes) == json.loads(json_bytes)
+
+    print(f"Synthetic listing of {actor_count} actors, {iterations} iterations")
+    print(f"  JSON size: {len(json_bytes):>10} bytes")
+    print(f"  CBOR size: {len(cbor_bytes):>10} bytes ({100.0 * len(cbor_bytes) / len(json_bytes):.0f}% of JSON)")
+
+    for name, payload in (("JSON", json_bytes), ("CBOR", cbor_bytes)):
+        frames = [payload[offset:offset + unreal_mcp_server.MAX_FRAME_SIZE] for offset in range(0, len(payload), unreal_mcp_server.MAX_FRAME_SIZE)]
+        start = time.perf_counter()
+        compressed = sum(4 + len(zlib.compress(frame)) for frame in frames)
+        elapsed = (time.perf_counter() - start) * 1000.0
+        print(f"  {name} zlib: {compressed:>10} bytes ({100.0 * compressed / len(json_bytes):.0f}% of JSON), compressed in {elapsed:.2f} ms")
+
+    print("  Client decode:")
+    print(f"    json.loads:           {time_call(json.loads, json_bytes, iterations):8.2f} ms")
+    print(f"    pure-Python CBOR:     {time_call(pure_cbor_loads, cbor_bytes, iterations):8.2f} ms")
+    if unreal_mcp_server.cbor2 is not None:
+        print(f"    cbor2:                {time_call(unreal_mcp_server.cbor2.loads, cbor_bytes, iterations):8.2f} ms")
+    else:
+        print("    cbor2:                not installed")
+
+    print("  Client encode (request direction):")
+    print(f"    json.dumps:           {time_call(lambda value: json.dumps(value).encode('utf-8'), listing, iterations):8.2f} ms")
+    print(f"    cbor_dumps:           {time_call(cbor_dumps, listing, iterations):8.2f} ms")
+    print(f"  Client would negotiate: {unreal_mcp_server.PAYLOAD_ENCODING}")
+
+
+def run_live(iterations: int):
+    print("Live get_actors_in_level:")
+    for encoding in ("json", "cbor"):
+        unreal_mcp_server.PAYLOAD_ENCODING = encoding
+        connection = UnrealConnection()
+        if not connection.connect():
+            print("  Could not connect to Unreal")
+            return
+        if connection.encoding != encoding:
+            print(f"  {encoding}: not supported by this plugin build")
+            connection.disconnect()
+            continue
+
+        request = connection._encode({"command": "get_actors_in_level", "params": {}})
+        sizes = []
+        start = time.perf_counter()
+        for _ in range(iterations):
+            response_data = connection._exchange(request)
+            sizes.append(len(response_data))
+            response = connection._decode(response_data)
+        elapsed = (time.perf_counter() - start) * 1000.0 / iterations
+        actor_count = len(response.get("result", {}).get("actors", []))
+        print(f"  {encoding}: {actor_count} actors, {sizes[-1]} bytes, {elapsed:.2f} ms per round trip (decode included)")
+        connection.disconnect()
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--actors", type=int, default=10000)
+    parser.add_argument("--iterations", type=int, default=5)
+    parser.add_argument("--live", action="store_true", help="also measure against a running editor")
+    args = parser.parse_args()
+
+    run_offline(args.actors, args.iterations)
+    if args.live:
+        run_live(args.iterations)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+"""
+Latency of health checks and interactive reads while bulk work runs.
+
+One session keeps the editor busy with pipelined bulk work (by default
+batches of --batch-size find_actors_by_name calls) while a second session
+sends ping and find_actors_by_name reads at a steady rate. Reports
+latency percentiles of each probe kind, then the per-lane queue waits from
+get_queue_stats. With priority lanes, pings should stay well under 10 ms and
+reads should wait at most about one editor frame, whatever the bulk load.
+
+Usage:
+    python bench_priority_lanes.py [--seconds 10] [--bulk-depth 16]
+"""
+
+import argparse
+import os
+import statistics
+import sys
+import threading
+import time
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+from unreal_mcp_server import UnrealConnection
+
+
+def percentile(samples: list, fraction: float) -> float:
+    ordered = sorted(samples)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * fraction))]
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--bulk-depth", type=int, default=16, help="Bulk requests kept in flight")
+    parser.add_argument("--batch-size", type=int, default=200)
+    parser.add_argument("--read-command", default="find_actors_by_name")
+    parser.add_argument("--probe-interval", type=float, default=0.05)
+    args = parser.parse_args()
+
+    bulk, probe = UnrealConnection(), UnrealConnection()
+    if not bulk.connect() or not probe.connect():
+        print("Could not connect to Unreal Engine")
+        return 1
+
+    batch = {"commands": [{"command": "find_actors_by_name", "params": {"pattern": "__mcp_bench_no_match__"}}] * args.batch_size}
+    stop = threading.Event()
+    bulk_done = 0
+
+    def run_bulk():
+        nonlocal bulk_done
+        while not stop.is_set():
+            responses = bulk.send_commands([("batch", batch)] * args.bulk_depth)
+            bulk_done += len(responses)
+
+    latencies = {"ping": [], args.read_command: []}
+    try:
+        loader = threading.Thread(target=run_bulk, daemon=True)
+        loader.start()
+        time.sleep(0.5)
+
+        deadline = time.perf_counter() + args.seconds
+        while time.perf_counter() < deadline:
+            for command, params in (("ping", {}), (args.read_command, {"pattern": "__mcp_bench_no_match__"})):
+                start = time.perf_counter()
+                response = probe.send_commands([(command, params)])[0]
+                if response.get("status") == "success":
+                    latencies[command].append((time.perf_counter() - start) * 1000.0)
+            time.sleep(args.probe_interval)
+
+        stop.set()
+        loader.join()
+        stats = probe.send_command("get_queue_stats", {}).get("result", {})
+    finally:
+        bulk.disconnect()
+        probe.disconnect()
+
+    print(f"{bulk_done} bulk batches of {args.batch_size} commands ran alongside the probes")
+    for command, samples in latencies.items():
+        if not samples:
+            print(f"  {command}: no successful samples")
+            continue
+        print(f"  {command}: {len(samples)} samples, median {statistics.median(samples):.2f} ms, "
+              f"p99 {percentile(samples, 0.99):.2f} ms, max {max(samples):.2f} ms")
+
+    for lane, lane_stats in stats.get("lanes", {}).items():
+        print(f"  {lane} lane: {lane_stats['items_run']} run, {lane_stats['items_rejected']} rejected, "
+              f"longest wait {lane_stats['max_wait_ms']:.2f} ms")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
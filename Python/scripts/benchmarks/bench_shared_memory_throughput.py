@@ -0,0 +1,138 @@
+#!/usr/bin/env python
+"""
+Message throughput of the shared-memory transport against the socket transports.
+
+Start the editor with -MCPSharedMemory (and -MCPUnixSocket to include the Unix
+socket). For each available transport the benchmark opens one session and
+reports messages per second for:
+
+  - sequential: send one request, wait for its response, repeat
+  - pipelined:  send --window requests at once, then read all the responses
+
+The request is `ping` by default, answered without touching the game thread,
+so the numbers show transport and framing cost. Pass --command and --params to
+drive real work instead, e.g. transform updates:
+
+    --command set_actor_transform --params '{"name": "Cube", "location": [0, 0, 100]}'
+
+Usage:
+    python bench_shared_memory_throughput.py [--messages 20000] [--window 64]
+        [--shm /unreal-mcp] [--socket /tmp/unreal-mcp.sock] [--host 127.0.0.1] [--port 55557]
+"""
+
+import argparse
+import json
+import os
+import socket
+import struct
+import sys
+import time
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+from unreal_mcp_server import SharedMemoryStream
+
+
+def receive_frames(stream, count: int, buffer: bytearray):
+    """Read count single-frame responses."""
+    view = memoryview(buffer)
+    for _ in range(count):
+        received = 0
+        while received < 4:
+            received += _recv_some(stream, view[received:4])
+        length = struct.unpack_from('<I', buffer)[0] & 0x3FFFFFFF
+        if length > len(buffer):
+            raise ValueError(f"Response of {length} bytes is larger than the receive buffer")
+        received = 0
+        while received < length:
+            received += _recv_some(stream, view[received:length])
+
+
+def _recv_some(stream, view) -> int:
+    count = stream.recv_into(view)
+    if count == 0:
+        raise ConnectionError("Session closed by the editor")
+    return count
+
+
+def measure(stream, request: bytes, messages: int, window: int):
+    """Return (sequential, pipelined) messages per second on one session."""
+    buffer = bytearray(1024 * 1024)
+
+    # Warm up the session and both code paths
+    for _ in range(min(messages, 100)):
+        stream.sendall(request)
+        receive_frames(stream, 1, buffer)
+
+    start = time.perf_counter()
+    for _ in range(messages):
+        stream.sendall(request)
+        receive_frames(stream, 1, buffer)
+    sequential = messages / (time.perf_counter() - start)
+
+    batch = request * window
+    batches = max(1, messages // window)
+    start = time.perf_counter()
+    for _ in range(batches):
+        stream.sendall(batch)
+        receive_frames(stream, window, buffer)
+    pipelined = batches * window / (time.perf_counter() - start)
+    return sequential, pipelined
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=55557)
+    parser.add_argument("--socket", default="/tmp/unreal-mcp.sock", help="the editor's -MCPUnixSocket path")
+    parser.add_argument("--shm", default="/unreal-mcp", help="the editor's -MCPSharedMemory segment name")
+    parser.add_argument("--messages", type=int, default=20000)
+    parser.add_argument("--window", type=int, default=64, help="requests in flight when pipelining")
+    parser.add_argument("--command", default="ping")
+    parser.add_argument("--params", default="{}", help="JSON object of command parameters")
+    args = parser.parse_args()
+
+    payload = json.dumps({"command": args.command, "params": json.loads(args.params)}).encode('utf-8')
+    request = struct.pack('<I', len(payload)) + payload
+
+    def open_tcp():
+        stream = socket.create_connection((args.host, args.port), timeout=10)
+        stream.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        return stream
+
+    def open_unix():
+        stream = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        stream.settimeout(10)
+        stream.connect(args.socket)
+        return stream
+
+    transports = (
+        ("tcp", open_tcp),
+        ("unix", open_unix),
+        ("shm", lambda: SharedMemoryStream(args.shm, timeout=10)),
+    )
+
+    print(f"{args.command} ({len(request)} byte request), {args.messages} messages, window {args.window}:")
+    results = {}
+    for label, opener in transports:
+        try:
+            stream = opener()
+        except OSError as error:
+            print(f"  {label:<5} unavailable: {error}")
+            continue
+        try:
+            results[label] = measure(stream, request, args.messages, args.window)
+        finally:
+            stream.close()
+        sequential, pipelined = results[label]
+        print(f"  {label:<5} sequential {sequential:>10.0f} msg/s   pipelined {pipelined:>10.0f} msg/s")
+
+    if "shm" in results and "tcp" in results:
+        print(f"  shm vs tcp: {results['shm'][0] / results['tcp'][0]:.1f}x sequential, "
+              f"{results['shm'][1] / results['tcp'][1]:.1f}x pipelined")
+    return 0 if "shm" in results else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
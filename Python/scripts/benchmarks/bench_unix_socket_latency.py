@@ -0,0 +1,137 @@
+#!/usr/bin/env python
+"""
+Latency comparison of the Unix domain socket transport against TCP loopback.
+
+Start the editor with -MCPUnixSocket (or -MCPUnixSocket=<path>) so the plugin
+listens on both. For each transport the benchmark opens one session and
+measures sequential round trips of a framed request: `ping` by default, or
+`echo` with a --payload byte string to include copy cost. A second pass
+measures connection setup, from connect() to the first response byte, on a
+fresh connection per sample. Both transports carry identical frames, so the
+difference is the cost of the loopback TCP stack.
+
+Usage:
+    python bench_unix_socket_latency.py [--samples 2000] [--payload 0]
+        [--socket /tmp/unreal-mcp.sock] [--host 127.0.0.1] [--port 55557]
+"""
+
+import argparse
+import json
+import socket
+import statistics
+import struct
+import sys
+import time
+
+
+def open_tcp(host: str, port: int) -> socket.socket:
+    sock = socket.create_connection((host, port), timeout=10)
+    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    return sock
+
+
+def open_unix(path: str) -> socket.socket:
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.settimeout(10)
+    sock.connect(path)
+    return sock
+
+
+def receive_frame(sock: socket.socket) -> bytes:
+    header = sock.recv(4, socket.MSG_WAITALL)
+    if len(header) < 4:
+        raise ConnectionError("Connection closed before the response arrived")
+    length = struct.unpack('<I', header)[0] & 0x3FFFFFFF
+    return sock.recv(length, socket.MSG_WAITALL) if length else b""
+
+
+def round_trips(sock: socket.socket, request: bytes, samples: int, warmup: int):
+    """Sequential request/response times on one session, in milliseconds."""
+    for _ in range(warmup):
+        sock.sendall(request)
+        receive_frame(sock)
+
+    times = []
+    for _ in range(samples):
+        start = time.perf_counter()
+        sock.sendall(request)
+        receive_frame(sock)
+        times.append((time.perf_counter() - start) * 1000.0)
+    return times
+
+
+def connect_times(opener, request: bytes, samples: int):
+    """Connect-to-first-byte times of one request per fresh connection, in milliseconds."""
+    times = []
+    for _ in range(samples):
+        start = time.perf_counter()
+        sock = opener()
+        try:
+            sock.sendall(request)
+            receive_frame(sock)
+            times.append((time.perf_counter() - start) * 1000.0)
+        finally:
+            sock.close()
+    return times
+
+
+def percentile(values, fraction: float) -> float:
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(fraction * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def report(label: str, times) -> float:
+    p50 = percentile(times, 0.50)
+    print(f"  {label:<5} mean {statistics.mean(times):7.3f}  p50 {p50:7.3f}  "
+          f"p95 {percentile(times, 0.95):7.3f}  p99 {percentile(times, 0.99):7.3f}  max {max(times):7.3f} ms")
+    return p50
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=55557)
+    parser.add_argument("--socket", default="/tmp/unreal-mcp.sock", help="the editor's -MCPUnixSocket path")
+    parser.add_argument("--samples", type=int, default=2000)
+    parser.add_argument("--warmup", type=int, default=100)
+    parser.add_argument("--connect-samples", type=int, default=200)
+    parser.add_argument("--payload", type=int, default=0, help="echo a string of this many bytes instead of ping")
+    args = parser.parse_args()
+
+    if args.payload > 0:
+        message = {"command": "echo", "params": {"data": "x" * args.payload}}
+    else:
+        message = {"command": "ping", "params": {}}
+    payload = json.dumps(message).encode('utf-8')
+    request = struct.pack('<I', len(payload)) + payload
+
+    openers = {
+        "tcp": lambda: open_tcp(args.host, args.port),
+        "unix": lambda: open_unix(args.socket),
+    }
+
+    print(f"Round trips of {message['command']} ({len(request)} byte request), {args.samples} samples:")
+    p50s = {}
+    for label, opener in openers.items():
+        try:
+            sock = opener()
+        except OSError as error:
+            print(f"  {label:<5} unavailable: {error}")
+            continue
+        try:
+            p50s[label] = report(label, round_trips(sock, request, args.samples, args.warmup))
+        finally:
+            sock.close()
+    if len(p50s) == 2:
+        print(f"  unix p50 is {100.0 * p50s['unix'] / p50s['tcp']:.0f}% of tcp")
+
+    print(f"Connect to first response byte, {args.connect_samples} samples:")
+    for label in p50s:
+        report(label, connect_times(openers[label], request, args.connect_samples))
+
+    return 0 if len(p50s) == 2 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
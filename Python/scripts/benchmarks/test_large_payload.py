@@ -0,0 +1,142 @@
+#!/usr/bin/env python
+"""
+Round-trip test for large messages over chunked frames.
+
+Negotiates chunked frames with `hello`, sends an `echo` request carrying a
+50 MB string and checks that the identical payload comes back. Both
+directions travel as bounded continuation frames. Compression is turned
+off for the session, since the payload would otherwise shrink to a few
+small frames and never exercise the chunked path.
+
+Memory is sampled while the round trip runs: the client side with
+tracemalloc, and optionally the editor process via /proc (Linux only) when
+--editor-pid is given. A flat profile means the peak stays within a small
+multiple of the payload size instead of growing with extra copies; the
+test fails when either side exceeds its limit.
+
+Usage:
+    python test_large_payload.py [--size-mb 50] [--editor-pid PID]
+"""
+
+import argparse
+import os
+import sys
+import threading
+import time
+import tracemalloc
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+import unreal_mcp_server
+from unreal_mcp_server import UnrealConnection
+
+# The client holds the request text and the received response; anything beyond
+# that is a copy the chunked path should have avoided
+CLIENT_PEAK_LIMIT = 2.0
+
+# The editor holds the received request, the parsed params with the payload as a
+# UTF-16 FString, and the response as it is written out; more means extra copies
+EDITOR_GROWTH_LIMIT = 6.0
+
+
+def read_rss_bytes(pid: int) -> int:
+    with open(f"/proc/{pid}/statm") as statm:
+        return int(statm.read().split()[1]) * os.sysconf("SC_PAGE_SIZE")
+
+
+class RssSampler(threading.Thread):
+    """Samples the resident set size of another process until stopped."""
+
+    def __init__(self, pid: int):
+        super().__init__(daemon=True)
+        self.pid = pid
+        self.baseline = read_rss_bytes(pid)
+        self.peak = self.baseline
+        self.running = True
+
+    def run(self):
+        while self.running:
+            self.peak = max(self.peak, read_rss_bytes(self.pid))
+            time.sleep(0.01)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=55557)
+    parser.add_argument("--size-mb", type=float, default=50.0)
+    parser.add_argument("--editor-pid", type=int, default=None)
+    args = parser.parse_args()
+
+    unreal_mcp_server.UNREAL_HOST = args.host
+    unreal_mcp_server.UNREAL_PORT = args.port
+    unreal_mcp_server.COMPRESSION = "none"
+
+    connection = UnrealConnection()
+    if not connection.connect():
+        print("FAIL: could not connect to Unreal")
+        return 1
+    if not connection.chunked_frames:
+        print("FAIL: the plugin did not accept chunked frames")
+        return 1
+    if connection.compression != "none":
+        print(f"FAIL: the plugin compressed the session with {connection.compression} although none was asked for")
+        return 1
+    print(f"Connected, frame size {connection.max_frame_size} bytes")
+
+    payload_size = int(args.size_mb * 1024 * 1024)
+    payload = "x" * payload_size
+    # In whichever payload encoding the session negotiated, JSON or CBOR
+    request = connection._encode({"command": "echo", "params": {"payload": payload}})
+
+    sampler = RssSampler(args.editor_pid) if args.editor_pid else None
+    if sampler:
+        sampler.start()
+
+    tracemalloc.start()
+    start = time.perf_counter()
+    connection._send_message(request)
+    response_data = connection.receive_full_response()
+    elapsed = time.perf_counter() - start
+    _, client_peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+
+    if sampler:
+        sampler.running = False
+        sampler.join()
+
+    # Decoded before disconnecting, which forgets the negotiated encoding
+    response = connection._decode(response_data) if response_data else None
+    connection.disconnect()
+
+    if not response:
+        print("FAIL: empty response")
+        return 1
+
+    echoed = response.get("result", {}).get("payload")
+    if echoed != payload:
+        print(f"FAIL: payload mismatch ({len(echoed or '')} bytes echoed, {payload_size} sent)")
+        return 1
+
+    megabytes = len(request) / (1024 * 1024)
+    print(f"Round trip of {megabytes:.1f} MB in {elapsed:.2f} s ({2 * megabytes / elapsed:.1f} MB/s)")
+    print(f"Client peak traced memory: {client_peak / (1024 * 1024):.1f} MB "
+          f"({client_peak / payload_size:.2f}x payload)")
+    if sampler:
+        growth = sampler.peak - sampler.baseline
+        print(f"Editor RSS growth: {growth / (1024 * 1024):.1f} MB ({growth / payload_size:.2f}x payload)")
+
+    if client_peak > CLIENT_PEAK_LIMIT * payload_size:
+        print(f"FAIL: client peak exceeds {CLIENT_PEAK_LIMIT}x the payload size")
+        return 1
+    if sampler and sampler.peak - sampler.baseline > EDITOR_GROWTH_LIMIT * payload_size:
+        print(f"FAIL: editor RSS growth exceeds {EDITOR_GROWTH_LIMIT}x the payload size")
+        return 1
+
+    print("PASS")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
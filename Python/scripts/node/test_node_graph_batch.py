@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+"""
+Test script for building a blueprint node graph in a single batch request.
+
+The nodes are created and wired together server-side: connect_blueprint_nodes
+takes its node ids from the results of the earlier commands through
+{"$ref": "<id>.node_id"} params, so the client never has to read them back.
+The graph is BeginPlay -> AddImpulse on the blueprint's own mesh component:
+
+```
+[BeginPlay] ───── [AddImpulse]
+                   │
+[BallMesh] ────────┘
+```
+
+The commands are deliberately listed with the connections first; the plugin
+runs them in dependency order.
+"""
+
+import sys
+import os
+import logging
+
+# Add the parent directory to the path so we can import the server module
+sys.path.append(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+from unreal_mcp_server import UnrealConnection
+
+# Set up logging
+logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(name)s - %(levelname)s - %(message)s')
+logger = logging.getLogger("TestNodeGraphBatch")
+
+BLUEPRINT = "GraphBatchBP"
+
+
+def build_graph_batch():
+    """The batch params: connections reference nodes created by other items."""
+    return {
+        "transaction": "Build GraphBatchBP",
+        "commands": [
+            {"command": "connect_blueprint_nodes", "params": {
+                "blueprint_name": BLUEPRINT,
+                "source_node_id": {"$ref": "begin_play.node_id"},
+                "source_pin": "then",
+                "target_node_id": {"$ref": "impulse.node_id"},
+                "target_pin": "execute"
+            }},
+            {"command": "connect_blueprint_nodes", "params": {
+                "blueprint_name": BLUEPRINT,
+                "source_node_id": {"$ref": "mesh_ref.node_id"},
+                "source_pin": "BallMesh",
+                "target_node_id": {"$ref": "impulse.node_id"},
+                "target_pin": "self"
+            }},
+            {"id": "begin_play", "command": "add_blueprint_event_node", "params": {
+                "blueprint_name": BLUEPRINT,
+                "event_name": "ReceiveBeginPlay",
+                "node_position": [0, 0]
+            }},
+            {"id": "mesh_ref", "command": "add_blueprint_get_self_component_reference", "params": {
+                "blueprint_name": BLUEPRINT,
+                "component_name": "BallMesh",
+                "node_position": [0, 200]
+            }},
+            {"id": "impulse", "command": "add_blueprint_function_node", "params": {
+                "blueprint_name": BLUEPRINT,
+                "function_name": "AddImpulse",
+                "target": "UPrimitiveComponent",
+                "params": {"Impulse": [0, 0, 1000]},
+                "node_position": [400, 100]
+            }},
+            {"command": "compile_blueprint", "params": {"blueprint_name": BLUEPRINT}}
+        ]
+    }
+
+
+def main():
+    """Create the blueprint, then build and compile its graph in one request."""
+    unreal = UnrealConnection()
+    if not unreal.connect():
+        logger.error("Failed to connect to Unreal Engine")
+        return 1
+
+    try:
+        # The blueprint and its component go first so a rerun can reuse them
+        response = unreal.send_command("create_blueprint", {"name": BLUEPRINT, "parent_class": "Actor"})
+        if response.get("status") != "success":
+            logger.error(f"Failed to create blueprint: {response}")
+            return 1
+        unreal.send_command("add_component_to_blueprint", {
+            "blueprint_name": BLUEPRINT,
+            "component_type": "StaticMeshComponent",
+            "component_name": "BallMesh"
+        })
+
+        response = unreal.send_command("batch", build_graph_batch())
+        if response.get("status") != "success":
+            logger.error(f"Batch was rejected: {response}")
+            return 1
+
+        result = response["result"]
+        for item in result["results"]:
+            logger.info(f"  item {item['index']} ({item.get('id', '-')}): {item['status']} {item.get('error', '')}")
+        logger.info(f"{result['completed']} of {result['total']} commands ran, {result['failed']} failed")
+        return 0 if result["failed"] == 0 else 1
+    finally:
+        unreal.disconnect()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
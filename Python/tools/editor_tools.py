@@ -4,7 +4,9 @@ Editor Tools for Unreal MCP.
 This module provides tools for controlling the Unreal Editor viewport and other editor functionality.
 """
 
+import base64
 import logging
+import struct
 from typing import Dict, List, Any, Optional
 from mcp.server.fastmcp import FastMCP, Context
 
@@ -15,66 +17,316 @@ def register_editor_tools(mcp: FastMCP):
     """Register editor tools with the MCP server."""
     
     @mcp.tool()
-    def get_actors_in_level(ctx: Context) -> List[Dict[str, Any]]:
-        """Get a list of all actors in the current level."""
+    def get_actors_in_level(
+        ctx: Context,
+        actor_class: str = None,
+        tag: str = None,
+        folder: str = None,
+        name: str = None,
+        level: str = None,
+        fields: List[str] = None,
+        sort_by: str = "name",
+        page_size: int = 0,
+        cursor: str = None
+    ) -> Dict[str, Any]:
+        """Get the actors in the current level, optionally filtered, trimmed to some fields and paged.
+
+        Args:
+            actor_class: Only actors of this class or its subclasses, e.g. "Light" or "BP_Door"
+            tag: Only actors with this tag
+            folder: Only actors in this World Outliner folder or its subfolders
+            name: Only actors whose name or label matches this wildcard, e.g. "Wall_*"
+            level: Only actors of this level (map name or package path)
+            fields: Fields to report per actor, from name, label, class, location, rotation,
+                scale, folder, tags and level (default name, class, location, rotation, scale)
+            sort_by: name, label, class, folder or level
+            page_size: Most actors to return; 0 returns them all
+            cursor: The next_cursor of the previous page
+
+        Returns:
+            "actors", the "total" number of matches, "next_cursor" when more pages follow,
+            and the scene "version" for get_scene_changes_since
+        """
         from unreal_mcp_server import get_unreal_connection
         
         try:
             unreal = get_unreal_connection()
             if not unreal:
                 logger.warning("Failed to connect to Unreal Engine")
-                return []
-                
-            response = unreal.send_command("get_actors_in_level", {})
+                return {"actors": []}
+
+            params = {"sort_by": sort_by, "page_size": page_size}
+            for key, value in (("class", actor_class), ("tag", tag), ("folder", folder), ("name", name),
+                               ("level", level), ("fields", fields), ("cursor", cursor)):
+                if value:
+                    params[key] = value
+
+            response = unreal.send_command("get_actors_in_level", params)
             
             if not response:
                 logger.warning("No response from Unreal Engine")
-                return []
+                return {"actors": []}
                 
-            # Log the complete response for debugging
-            logger.info(f"Complete response from Unreal: {response}")
-            
             # Check response format
-            if "result" in response and "actors" in response["result"]:
-                actors = response["result"]["actors"]
-                logger.info(f"Found {len(actors)} actors in level")
-                return actors
-            elif "actors" in response:
-                actors = response["actors"]
-                logger.info(f"Found {len(actors)} actors in level")
-                return actors
+            result = response.get("result", response)
+            if "actors" in result:
+                logger.info(f"Found {len(result['actors'])} of {result.get('total')} actors in level")
+                return result
                 
             logger.warning(f"Unexpected response format: {response}")
-            return []
+            return response
             
         except Exception as e:
             logger.error(f"Error getting actors: {e}")
-            return []
+            return {"actors": []}
 
     @mcp.tool()
-    def find_actors_by_name(ctx: Context, pattern: str) -> List[str]:
-        """Find actors by name pattern."""
+    def find_actors_by_name(
+        ctx: Context,
+        pattern: str,
+        mode: str = "substring",
+        case_sensitive: bool = False,
+        limit: int = 0
+    ) -> Dict[str, Any]:
+        """Find actors whose name or label (the name shown in the World Outliner) matches a pattern.
+
+        Args:
+            pattern: Text to look for
+            mode: substring (the pattern appears anywhere), glob (the whole name matches, with
+                  * and ?), regex (a regular expression found anywhere) or fuzzy (the pattern's
+                  characters appear in order, e.g. "bpdr" finds "BP_Door"; closest first)
+            case_sensitive: Compare letter case too
+            limit: Most actors to return; 0 returns them all
+
+        Returns:
+            "actors", each with its "label" and, for fuzzy searches, its "score", and the
+            "total" number of matches
+        """
         from unreal_mcp_server import get_unreal_connection
         
         try:
             unreal = get_unreal_connection()
             if not unreal:
                 logger.warning("Failed to connect to Unreal Engine")
-                return []
+                return {"actors": []}
                 
             response = unreal.send_command("find_actors_by_name", {
-                "pattern": pattern
+                "pattern": pattern,
+                "mode": mode,
+                "case_sensitive": case_sensitive,
+                "limit": limit
             })
             
             if not response:
-                return []
+                return {"actors": []}
                 
-            return response.get("actors", [])
+            return response.get("result", response)
             
         except Exception as e:
             logger.error(f"Error finding actors: {e}")
-            return []
+            return {"actors": []}
     
+    def _query_actors(command: str, params: Dict[str, Any]) -> Dict[str, Any]:
+        """Send a spatial query and return its result, or an error response."""
+        from unreal_mcp_server import get_unreal_connection
+
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+
+            response = unreal.send_command(command, params)
+            return response or {}
+
+        except Exception as e:
+            logger.error(f"Error running {command}: {e}")
+            return {"success": False, "message": str(e)}
+
+    @mcp.tool()
+    def query_actors_in_sphere(
+        ctx: Context,
+        center: List[float],
+        radius: float,
+        limit: int = 100,
+        actor_class: str = None
+    ) -> Dict[str, Any]:
+        """Find the actors whose bounds touch a sphere, nearest first.
+
+        Args:
+            center: The [x, y, z] center of the sphere
+            radius: The sphere's radius in world units
+            limit: Most actors to return
+            actor_class: Only actors of this exact class, e.g. "StaticMeshActor"
+
+        Returns:
+            "actors" with each actor's "distance" from the center, and "total" matches before the limit
+        """
+        params = {"center": center, "radius": radius, "limit": limit}
+        if actor_class:
+            params["class"] = actor_class
+        return _query_actors("query_actors_in_sphere", params)
+
+    @mcp.tool()
+    def query_actors_in_box(
+        ctx: Context,
+        min: List[float] = None,
+        max: List[float] = None,
+        center: List[float] = None,
+        extent: List[float] = None,
+        limit: int = 100,
+        actor_class: str = None
+    ) -> Dict[str, Any]:
+        """Find the actors whose bounds overlap an axis-aligned box, nearest to its center first.
+
+        Args:
+            min: The box's [x, y, z] minimum corner, with max
+            max: The box's [x, y, z] maximum corner, with min
+            center: The box's [x, y, z] center, with extent (instead of min and max)
+            extent: The box's [x, y, z] half size, with center
+            limit: Most actors to return
+            actor_class: Only actors of this exact class, e.g. "StaticMeshActor"
+        """
+        params = {"limit": limit}
+        if min is not None and max is not None:
+            params["min"] = min
+            params["max"] = max
+        if center is not None and extent is not None:
+            params["center"] = center
+            params["extent"] = extent
+        if actor_class:
+            params["class"] = actor_class
+        return _query_actors("query_actors_in_box", params)
+
+    @mcp.tool()
+    def query_actors_in_frustum(
+        ctx: Context,
+        origin: List[float] = None,
+        rotation: List[float] = None,
+        fov: float = None,
+        aspect_ratio: float = None,
+        near: float = None,
+        far: float = None,
+        limit: int = 100,
+        actor_class: str = None
+    ) -> Dict[str, Any]:
+        """Find the actors a camera can see, nearest to the camera first.
+
+        Without an origin, the camera is the active level viewport's.
+
+        Args:
+            origin: The camera's [x, y, z] location
+            rotation: The camera's [pitch, yaw, roll] in degrees
+            fov: Horizontal field of view in degrees (90 for a given origin)
+            aspect_ratio: Width over height (16:9 for a given origin)
+            near: Near clip distance (10)
+            far: Far clip distance (100000)
+            limit: Most actors to return
+            actor_class: Only actors of this exact class, e.g. "StaticMeshActor"
+        """
+        params = {"limit": limit}
+        for key, value in (("origin", origin), ("rotation", rotation), ("fov", fov),
+                           ("aspect_ratio", aspect_ratio), ("near", near), ("far", far)):
+            if value is not None:
+                params[key] = value
+        if actor_class:
+            params["class"] = actor_class
+        return _query_actors("query_actors_in_frustum", params)
+
+    @mcp.tool()
+    def get_scene_changes_since(ctx: Context, version: int) -> Dict[str, Any]:
+        """Get what changed in the level since a scene version.
+
+        Start from the "version" of get_actors_in_level, then pass each result's "version"
+        to the next call.
+
+        Args:
+            version: The scene version the caller is up to date with
+
+        Returns:
+            "changes", one per actor: its "name", "change" (added, removed, transformed or
+            modified) and, unless removed, its current state; the new "version"; and
+            "resync_required" when the changes since version are no longer known and the
+            caller has to list the level again
+        """
+        from unreal_mcp_server import get_unreal_connection
+
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+
+            response = unreal.send_command("get_scene_changes_since", {"version": version})
+            return response or {}
+
+        except Exception as e:
+            logger.error(f"Error getting scene changes: {e}")
+            return {"success": False, "message": str(e)}
+
+    @mcp.tool()
+    def subscribe_events(ctx: Context, events: List[str]) -> Dict[str, Any]:
+        """Have Unreal push editor events instead of polling for them; read them with get_events.
+
+        Args:
+            events: Any of actor_added, actor_removed, actor_moved, level_changed,
+                    selection_changed, blueprint_compiled, asset_saved, pie_started and
+                    pie_stopped, or "*" for all of them
+
+        Returns:
+            The "events" now subscribed to
+        """
+        from unreal_mcp_server import get_event_stream
+
+        try:
+            return get_event_stream().subscribe(events)
+        except Exception as e:
+            logger.error(f"Error subscribing to events: {e}")
+            return {"success": False, "message": str(e)}
+
+    @mcp.tool()
+    def get_events(ctx: Context, max_events: int = 100, wait_seconds: float = 0.0) -> Dict[str, Any]:
+        """Take the editor events pushed since the last call, oldest first.
+
+        actor_moved is sent once per actor per editor frame, with where it ended up. Actor
+        events carry the scene "version"; after an "events_dropped" event, catch up with
+        get_scene_changes_since from the last version seen.
+
+        Args:
+            max_events: Most events to return
+            wait_seconds: How long to wait for the first event when none are buffered
+
+        Returns:
+            "events", each with its "event" name and "data"; "dropped", events this client
+            discarded because they were not read in time; and "connected", false once the
+            session ended and the subscription has to be made again
+        """
+        from unreal_mcp_server import get_event_stream
+
+        try:
+            return get_event_stream().get_events(max_events, wait_seconds)
+        except Exception as e:
+            logger.error(f"Error getting events: {e}")
+            return {"success": False, "message": str(e)}
+
+    @mcp.tool()
+    def unsubscribe_events(ctx: Context, events: List[str] = None) -> Dict[str, Any]:
+        """Stop Unreal pushing some editor events, or all of them when none are given.
+
+        Args:
+            events: Event names as for subscribe_events
+
+        Returns:
+            The "events" still subscribed to
+        """
+        from unreal_mcp_server import get_event_stream
+
+        try:
+            return get_event_stream().unsubscribe(events)
+        except Exception as e:
+            logger.error(f"Error unsubscribing from events: {e}")
+            return {"success": False, "message": str(e)}
+
     @mcp.tool()
     def spawn_actor(
         ctx: Context,
@@ -194,6 +446,56 @@ def register_editor_tools(mcp: FastMCP):
         except Exception as e:
             logger.error(f"Error setting transform: {e}")
             return {}
+
+    @mcp.tool()
+    def set_actor_transforms(
+        ctx: Context,
+        names: List[str],
+        locations: List[List[float]] = None,
+        rotations: List[List[float]] = None,
+        scales: List[List[float]] = None,
+        defer_navigation: bool = False
+    ) -> Dict[str, Any]:
+        """
+        Set the transforms of many actors in one request.
+
+        Args:
+            names: Actor names, at most 10000
+            locations: One [x, y, z] per name, or None to keep every location
+            rotations: One [pitch, yaw, roll] per name, or None to keep every rotation
+            scales: One [x, y, z] per name, or None to keep every scale
+            defer_navigation: Update navigation once after all moves instead of after each one
+
+        Returns:
+            The number of actors moved, and the names of those that could not be
+        """
+        from unreal_mcp_server import get_unreal_connection
+
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+
+            # Each field goes as base64 of packed little-endian float32s, three per actor
+            params = {"names": names, "defer_navigation": defer_navigation}
+            for field, vectors in (("location", locations), ("rotation", rotations), ("scale", scales)):
+                if vectors is not None:
+                    values = [float(value) for vector in vectors for value in vector]
+                    params[field] = base64.b64encode(struct.pack(f"<{len(values)}f", *values)).decode("ascii")
+
+            response = unreal.send_command("set_actor_transforms", params)
+            if not response or response.get("status") != "success":
+                return response or {}
+
+            result = response.get("result", {})
+            moved = base64.b64decode(result.get("moved", ""))
+            failed = [name for index, name in enumerate(names) if not moved[index // 8] & (1 << (index % 8))]
+            return {"moved_count": result.get("moved_count", 0), "failed": failed}
+
+        except Exception as e:
+            logger.error(f"Error setting transforms: {e}")
+            return {}
     
     @mcp.tool()
     def get_actor_properties(ctx: Context, name: str) -> Dict[str, Any]:
@@ -366,4 +668,140 @@ def register_editor_tools(mcp: FastMCP):
             logger.error(error_msg)
             return {"success": False, "message": error_msg}
 
+    @mcp.tool()
+    def execute_batch(
+        ctx: Context,
+        commands: List[Dict[str, Any]],
+        transaction: Optional[str] = None,
+        stop_on_error: bool = True
+    ) -> Dict[str, Any]:
+        """Run several commands in order in one round trip to the editor.
+        
+        Args:
+            ctx: The MCP context
+            commands: Commands to run, each {"command": name, "params": {...}} with an optional
+                "id"; a param value {"$ref": "<id>.<field>"} is replaced by that field of the
+                result of the command with that id, e.g. {"$ref": "event.node_id"}
+            transaction: If given, record the whole batch as one undo step with this description
+            stop_on_error: Stop at the first failing command instead of running the rest
+            
+        Returns:
+            Dict with one response per command that ran under "results", in the order
+            they ran, plus "total", "completed" and "failed" counts
+        """
+        from unreal_mcp_server import get_unreal_connection
+        
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+            
+            params = {
+                "commands": commands,
+                "on_error": "stop" if stop_on_error else "continue"
+            }
+            if transaction:
+                params["transaction"] = transaction
+            
+            response = unreal.send_command("batch", params)
+            return response or {}
+            
+        except Exception as e:
+            error_msg = f"Error executing batch: {e}"
+            logger.error(error_msg)
+            return {"success": False, "message": error_msg}
+
+    @mcp.tool()
+    def get_queue_stats(ctx: Context) -> Dict[str, Any]:
+        """Get the depth of the editor's MCP command queue and how often it overran its per-frame time budget."""
+        from unreal_mcp_server import get_unreal_connection
+        
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+            
+            response = unreal.send_command("get_queue_stats", {})
+            return response or {}
+            
+        except Exception as e:
+            error_msg = f"Error getting queue stats: {e}"
+            logger.error(error_msg)
+            return {"success": False, "message": error_msg}
+
+    @mcp.tool()
+    def start_job(ctx: Context, command: str, params: Dict[str, Any] = None) -> Dict[str, Any]:
+        """Start a long-running command (e.g. compile_blueprint, batch) in the background.
+
+        Returns at once with a job_id; follow it with get_job_status.
+
+        Args:
+            command: Name of the command to run
+            params: Parameters of that command
+        """
+        from unreal_mcp_server import get_unreal_connection
+
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+
+            response = unreal.send_command("start_job", {"command": command, "params": params or {}})
+            return response or {}
+
+        except Exception as e:
+            error_msg = f"Error starting job: {e}"
+            logger.error(error_msg)
+            return {"success": False, "message": error_msg}
+
+    @mcp.tool()
+    def get_job_status(ctx: Context, job_id: str, wait_seconds: float = 0) -> Dict[str, Any]:
+        """Get the state of a job, and its result or error once it has finished.
+
+        Args:
+            job_id: Id returned by start_job, or by a command that timed out
+            wait_seconds: How long to wait for the job to finish first (at most 30)
+        """
+        from unreal_mcp_server import get_unreal_connection
+
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+
+            response = unreal.send_command("get_job_status", {"job_id": job_id, "wait_seconds": wait_seconds})
+            return response or {}
+
+        except Exception as e:
+            error_msg = f"Error getting job status: {e}"
+            logger.error(error_msg)
+            return {"success": False, "message": error_msg}
+
+    @mcp.tool()
+    def cancel_job(ctx: Context, job_id: str) -> Dict[str, Any]:
+        """Cancel a job that has not started yet. Running commands cannot be interrupted.
+
+        Args:
+            job_id: Id of the job to cancel
+        """
+        from unreal_mcp_server import get_unreal_connection
+
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+
+            response = unreal.send_command("cancel_job", {"job_id": job_id})
+            return response or {}
+
+        except Exception as e:
+            error_msg = f"Error cancelling job: {e}"
+            logger.error(error_msg)
+            return {"success": False, "message": error_msg}
+
     logger.info("Editor tools registered successfully")
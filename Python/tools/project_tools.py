@@ -5,7 +5,7 @@ This module provides tools for managing project-wide settings and configuration.
 """
 
 import logging
-from typing import Dict, Any
+from typing import Dict, Any, Optional
 from mcp.server.fastmcp import FastMCP, Context
 
 # Get logger
@@ -61,4 +61,82 @@ def register_project_tools(mcp: FastMCP):
             logger.error(error_msg)
             return {"success": False, "message": error_msg}
     
+    @mcp.tool()
+    def find_assets(
+        ctx: Context,
+        path: str = "/Game",
+        asset_class: Optional[str] = None,
+        name: Optional[str] = None,
+        recursive: bool = True,
+        limit: int = 1000
+    ) -> Dict[str, Any]:
+        """
+        Find saved assets in the asset registry. Answered without waiting for the editor's game thread.
+        
+        Args:
+            path: Content folder to search, e.g. "/Game/Blueprints"
+            asset_class: Class name ("StaticMesh", exact match) or class path ("/Script/Engine.StaticMesh")
+            name: Only assets whose name contains this text
+            recursive: Also search sub-folders
+            limit: Most assets to return
+            
+        Returns:
+            The matching assets with their object paths and classes, and the total match count
+        """
+        from unreal_mcp_server import get_unreal_connection
+        
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+            
+            params = {"path": path, "recursive": recursive, "limit": limit}
+            if asset_class:
+                params["class"] = asset_class
+            if name:
+                params["name"] = name
+            
+            response = unreal.send_command("find_assets", params)
+            return response or {}
+            
+        except Exception as e:
+            error_msg = f"Error finding assets: {e}"
+            logger.error(error_msg)
+            return {"success": False, "message": error_msg}
+
+    @mcp.tool()
+    def get_config_value(
+        ctx: Context,
+        section: str,
+        key: str,
+        file: str = "game"
+    ) -> Dict[str, Any]:
+        """
+        Read a value from the project's config.
+        
+        Args:
+            section: Config section, e.g. "/Script/EngineSettings.GameMapsSettings"
+            key: Key within the section, e.g. "GameDefaultMap"
+            file: Config file: engine, game, editor, input or editor_per_project
+            
+        Returns:
+            The value, or every value for keys that repeat
+        """
+        from unreal_mcp_server import get_unreal_connection
+        
+        try:
+            unreal = get_unreal_connection()
+            if not unreal:
+                logger.error("Failed to connect to Unreal Engine")
+                return {"success": False, "message": "Failed to connect to Unreal Engine"}
+            
+            response = unreal.send_command("get_config_value", {"section": section, "key": key, "file": file})
+            return response or {}
+            
+        except Exception as e:
+            error_msg = f"Error reading config value: {e}"
+            logger.error(error_msg)
+            return {"success": False, "message": error_msg}
+    
     logger.info("Project tools registered successfully") 
\ No newline at end of file
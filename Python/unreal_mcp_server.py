@@ -4,19 +4,35 @@ Unreal Engine MCP Server
 A simple MCP server for interacting with Unreal Engine.
 """
 
+import ctypes
+import mmap
+import os
+import platform
 import logging
+import select
 import socket
+import struct
 import sys
 import json
+import collections
+import threading
+import time
+import zlib
 from pathlib import Path
 
 # Add the script's directory to the Python path to resolve local imports
 sys.path.append(str(Path(__file__).parent))
 
 from contextlib import asynccontextmanager
-from typing import AsyncIterator, Dict, Any, Optional
+from typing import AsyncIterator, Dict, Any, List, Optional, Tuple
 from fastmcp import FastMCP
 
+try:
+    # C-accelerated CBOR codec; without it the pure-Python one below is used
+    import cbor2
+except ImportError:
+    cbor2 = None
+
 # Configure logging with more detailed format
 logging.basicConfig(
     level=logging.INFO,  # Set to INFO for production, DEBUG for development
@@ -32,13 +48,450 @@ logger = logging.getLogger("UnrealMCP")
 UNREAL_HOST = "127.0.0.1"
 UNREAL_PORT = 55557
 
+# Path of the editor's Unix domain socket (editor started with -MCPUnixSocket[=path]).
+# When set, the client connects there instead of TCP, skipping the loopback network stack.
+UNREAL_UNIX_SOCKET = os.environ.get("UNREAL_MCP_UNIX_SOCKET", "")
+
+# Name of the editor's shared-memory segment (editor started with -MCPSharedMemory[=name]).
+# When set, the client talks to the plugin through ring buffers in that segment (Linux only).
+UNREAL_SHARED_MEMORY = os.environ.get("UNREAL_MCP_SHARED_MEMORY", "")
+
+# Reconnect proactively before the plugin's idle timeout (300 s) closes the session
+IDLE_RECONNECT_SECONDS = 240
+
+# How long to wait for a response: the plugin's own limit for the command plus slack for
+# queueing and transfer. Commands the plugin allows longer than its default 5 s are listed.
+RESPONSE_TIMEOUT_SECONDS = 10
+RESPONSE_TIMEOUT_SLACK_SECONDS = 10
+COMMAND_TIMEOUT_SECONDS = {
+    "batch": 60,
+    "compile_blueprint": 30,
+    "take_screenshot": 30,
+}
+# Longest wait_seconds the plugin honours in get_job_status
+JOB_MAX_WAIT_SECONDS = 30
+
+# Requests kept in flight by send_commands; matches the plugin's per-connection limit
+PIPELINE_WINDOW = 32
+
+# Pushed events buffered by an UnrealEventStream before the oldest are discarded
+EVENT_BUFFER_SIZE = 4096
+
+# Frame header: little-endian uint32, payload length in the low 30 bits, top bit set
+# when more frames of the same message follow
+FRAME_LENGTH_MASK = 0x3FFFFFFF
+FRAME_FLAG_MORE = 0x80000000
+
+# Set on frames compressed with the negotiated format; the payload starts with the
+# little-endian uncompressed length
+FRAME_FLAG_COMPRESSED = 0x40000000
+
+# Compression requested in 'hello'; frames smaller than the threshold travel uncompressed
+COMPRESSION = "zlib"
+COMPRESSION_THRESHOLD = 4 * 1024
+
+# Frame size requested for chunked messages in both directions
+MAX_FRAME_SIZE = 64 * 1024
+
+# Payload encoding requested in 'hello'. CBOR is smaller and cheaper for the plugin to
+# produce, but decoding it in pure Python is slower than the C json module, so it is
+# only worth asking for when cbor2 is installed.
+PAYLOAD_ENCODING = "cbor" if cbor2 is not None else "json"
+
+def _cbor_head(major: int, value: int, out: bytearray):
+    """Append a CBOR item header with the shortest argument encoding."""
+    if value < 24:
+        out.append((major << 5) | value)
+    elif value < 0x100:
+        out.append((major << 5) | 24)
+        out.append(value)
+    elif value < 0x10000:
+        out.append((major << 5) | 25)
+        out += value.to_bytes(2, 'big')
+    elif value < 0x100000000:
+        out.append((major << 5) | 26)
+        out += value.to_bytes(4, 'big')
+    else:
+        out.append((major << 5) | 27)
+        out += value.to_bytes(8, 'big')
+
+def _cbor_encode(obj: Any, out: bytearray):
+    if obj is None:
+        out.append(0xF6)
+    elif obj is True:
+        out.append(0xF5)
+    elif obj is False:
+        out.append(0xF4)
+    elif isinstance(obj, int):
+        if obj >= 0:
+            _cbor_head(0, obj, out)
+        else:
+            _cbor_head(1, -1 - obj, out)
+    elif isinstance(obj, float):
+        out.append(0xFB)
+        out += struct.pack('>d', obj)
+    elif isinstance(obj, str):
+        encoded = obj.encode('utf-8')
+        _cbor_head(3, len(encoded), out)
+        out += encoded
+    elif isinstance(obj, (list, tuple)):
+        _cbor_head(4, len(obj), out)
+        for item in obj:
+            _cbor_encode(item, out)
+    elif isinstance(obj, dict):
+        _cbor_head(5, len(obj), out)
+        for key, value in obj.items():
+            _cbor_encode(str(key), out)
+            _cbor_encode(value, out)
+    else:
+        raise TypeError(f"Cannot encode {type(obj).__name__} as CBOR")
+
+_CBOR_FLOAT32 = struct.Struct('>f').unpack_from
+_CBOR_FLOAT64 = struct.Struct('>d').unpack_from
+_CBOR_FLOAT16 = struct.Struct('>e').unpack_from
+
+def _cbor_decode(data, pos: int) -> Tuple[Any, int]:
+    """Decode the item at pos, returning it and the offset just past it."""
+    initial = data[pos]
+    pos += 1
+
+    # Floats dominate actor listings, so they are checked first
+    if initial == 0xFA:
+        return _CBOR_FLOAT32(data, pos)[0], pos + 4
+    if initial == 0xFB:
+        return _CBOR_FLOAT64(data, pos)[0], pos + 8
+    if initial == 0xF9:
+        return _CBOR_FLOAT16(data, pos)[0], pos + 2
+
+    major = initial >> 5
+    info = initial & 0x1F
+    if info < 24:
+        arg = info
+    elif info == 24:
+        arg = data[pos]
+        pos += 1
+    elif info == 25:
+        arg = int.from_bytes(data[pos:pos + 2], 'big')
+        pos += 2
+    elif info == 26:
+        arg = int.from_bytes(data[pos:pos + 4], 'big')
+        pos += 4
+    elif info == 27:
+        arg = int.from_bytes(data[pos:pos + 8], 'big')
+        pos += 8
+    elif info == 31 and 2 <= major <= 5:
+        arg = None  # Indefinite length, ended by a break (0xFF)
+    else:
+        raise ValueError(f"Invalid CBOR item 0x{initial:02x} at offset {pos - 1}")
+
+    if major == 0:
+        return arg, pos
+    if major == 1:
+        return -1 - arg, pos
+    if major == 2 or major == 3:
+        if arg is None:
+            chunks = []
+            while data[pos] != 0xFF:
+                chunk, pos = _cbor_decode(data, pos)
+                chunks.append(chunk)
+            return (b''.join(chunks) if major == 2 else ''.join(chunks)), pos + 1
+        end = pos + arg
+        return (bytes(data[pos:end]) if major == 2 else str(data[pos:end], 'utf-8')), end
+    if major == 4:
+        items = []
+        if arg is None:
+            while data[pos] != 0xFF:
+                item, pos = _cbor_decode(data, pos)
+                items.append(item)
+            return items, pos + 1
+        for _ in range(arg):
+            item, pos = _cbor_decode(data, pos)
+            items.append(item)
+        return items, pos
+    if major == 5:
+        obj = {}
+        if arg is None:
+            while data[pos] != 0xFF:
+                key, pos = _cbor_decode(data, pos)
+                obj[key], pos = _cbor_decode(data, pos)
+            return obj, pos + 1
+        for _ in range(arg):
+            key, pos = _cbor_decode(data, pos)
+            obj[key], pos = _cbor_decode(data, pos)
+        return obj, pos
+    if major == 6:
+        # Tags carry no meaning here; return the tagged item itself
+        return _cbor_decode(data, pos)
+    if info == 20:
+        return False, pos
+    if info == 21:
+        return True, pos
+    if info == 22 or info == 23:
+        return None, pos
+    raise ValueError(f"Unsupported CBOR simple value {info} at offset {pos - 1}")
+
+def cbor_dumps(obj: Any) -> bytes:
+    """Encode obj as CBOR (RFC 8949)."""
+    if cbor2 is not None:
+        return cbor2.dumps(obj)
+    out = bytearray()
+    _cbor_encode(obj, out)
+    return bytes(out)
+
+def cbor_loads(data) -> Any:
+    """Decode one CBOR item, including the indefinite-length containers the plugin streams."""
+    if cbor2 is not None:
+        return cbor2.loads(data)
+    value, pos = _cbor_decode(data, 0)
+    if pos != len(data):
+        raise ValueError(f"Unexpected data after CBOR item at offset {pos}")
+    return value
+
+class _SharedMemoryRing(ctypes.Structure):
+    """One direction of the plugin's shared-memory transport (FMCPSharedMemoryRing)."""
+    _fields_ = [
+        ("head", ctypes.c_int64), ("_pad0", ctypes.c_uint8 * 56),
+        ("tail", ctypes.c_int64), ("_pad1", ctypes.c_uint8 * 56),
+        ("data_doorbell", ctypes.c_int32), ("consumer_waiting", ctypes.c_int32), ("_pad2", ctypes.c_uint8 * 56),
+        ("space_doorbell", ctypes.c_int32), ("producer_waiting", ctypes.c_int32), ("_pad3", ctypes.c_uint8 * 56),
+    ]
+
+
+class _SharedMemoryHeader(ctypes.Structure):
+    """Start of the plugin's shared-memory segment (FMCPSharedMemoryHeader)."""
+    _fields_ = [
+        ("magic", ctypes.c_uint32), ("version", ctypes.c_uint32), ("ring_capacity", ctypes.c_uint32), ("reserved", ctypes.c_uint32),
+        ("server_session", ctypes.c_int32), ("server_serving", ctypes.c_int32),
+        ("client_session", ctypes.c_int32), ("client_detached_session", ctypes.c_int32), ("client_pid", ctypes.c_int32),
+        ("_pad", ctypes.c_uint8 * 28),
+        ("requests", _SharedMemoryRing), ("responses", _SharedMemoryRing),
+    ]
+
+
+class _Timespec(ctypes.Structure):
+    _fields_ = [("tv_sec", ctypes.c_long), ("tv_nsec", ctypes.c_long)]
+
+
+class SharedMemoryStream:
+    """Socket stand-in over the plugin's shared-memory ring buffers.
+
+    Implements the part of the socket API UnrealConnection uses, so framing and
+    negotiation are unchanged. Each field of the segment has a single writer; on
+    the plain loads and stores ctypes makes this relies on x86-64 memory ordering.
+    After writing requests the client always makes the futex wake-up call, since
+    without a memory fence it cannot safely tell whether the plugin is asleep.
+    """
+
+    MAGIC = 0x50434D55
+    VERSION = 1
+    DATA_OFFSET = 4096
+    # Longest single futex sleep, so detach and timeouts are noticed
+    WAIT_SLICE_SECONDS = 0.1
+    # Polls of the ring before sleeping on its doorbell
+    SPIN_COUNT = 64
+    FUTEX_WAIT = 0
+    FUTEX_WAKE = 1
+    SYS_FUTEX_X86_64 = 202
+    _libc = None
+
+    def __init__(self, name: str, timeout: float = 10.0):
+        self._fd = None
+        self._map = None
+        self._session = 0
+        if not sys.platform.startswith("linux") or platform.machine() != "x86_64":
+            raise OSError("The shared-memory transport needs Linux on x86-64")
+        import fcntl
+        if SharedMemoryStream._libc is None:
+            SharedMemoryStream._libc = ctypes.CDLL(None, use_errno=True)
+
+        self.timeout = timeout
+        self._fd = os.open("/dev/shm/" + name.lstrip("/"), os.O_RDWR)
+        try:
+            # One client per segment; the lock is dropped by the kernel if this process dies
+            try:
+                fcntl.flock(self._fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+            except BlockingIOError:
+                raise ConnectionRefusedError(f"Shared-memory segment {name} is in use by another client")
+
+            self._map = mmap.mmap(self._fd, 0)
+            self._header = _SharedMemoryHeader.from_buffer(self._map)
+            if self._header.magic != self.MAGIC or self._header.version != self.VERSION:
+                raise ConnectionRefusedError(f"Shared-memory segment {name} has an unknown layout")
+            self._capacity = self._header.ring_capacity
+            self._requests_offset = self.DATA_OFFSET
+            self._responses_offset = self.DATA_OFFSET + self._capacity
+            self._claim()
+        except BaseException:
+            self.close()
+            raise
+
+    @staticmethod
+    def _address(structure, name: str) -> int:
+        return ctypes.addressof(structure) + getattr(type(structure), name).offset
+
+    def _futex(self, address: int, operation: int, value: int, timeout: Optional[float] = None):
+        timespec = None
+        if timeout is not None:
+            timespec = ctypes.byref(_Timespec(int(timeout), int((timeout - int(timeout)) * 1e9)))
+        self._libc.syscall(self.SYS_FUTEX_X86_64, ctypes.c_void_p(address), operation, ctypes.c_int(value), timespec, None, 0)
+
+    def _wake(self, structure, name: str):
+        self._futex(self._address(structure, name), self.FUTEX_WAKE, 0x7FFFFFFF)
+
+    def _sleep(self, structure, doorbell: str, flag: str, ready, deadline: float) -> bool:
+        """Sleep on a doorbell until ready() or the deadline; returns ready()."""
+        # Replies to small requests usually arrive sooner than a futex wake-up would. Yielding
+        # while polling keeps this from starving the editor when both share a core.
+        for _ in range(self.SPIN_COUNT):
+            if ready():
+                return True
+            os.sched_yield()
+        while not ready():
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                return False
+            setattr(structure, flag, 1)
+            sequence = getattr(structure, doorbell)
+            if not ready():
+                self._futex(self._address(structure, doorbell), self.FUTEX_WAIT, sequence, min(remaining, self.WAIT_SLICE_SECONDS))
+            setattr(structure, flag, 0)
+        return True
+
+    def _claim(self):
+        header = self._header
+        deadline = time.monotonic() + self.timeout
+
+        # Wait for the plugin to finish with the previous session, then start from empty rings
+        if not self._sleep_on_word("server_serving", lambda: not header.server_serving, deadline):
+            raise socket.timeout("Shared-memory segment is still serving another session")
+        for ring in (header.requests, header.responses):
+            ring.head = ring.tail = 0
+            ring.consumer_waiting = ring.producer_waiting = 0
+
+        self._session = (header.server_session + 1) & 0x7FFFFFFF or 1
+        header.client_pid = os.getpid()
+        header.client_detached_session = 0
+        header.client_session = self._session
+        self._wake(header, "client_session")
+
+        accepted = lambda: header.server_serving and header.server_session == self._session
+        if not self._sleep_on_word("server_serving", accepted, deadline):
+            raise socket.timeout("The editor did not accept the shared-memory session")
+
+    def _sleep_on_word(self, name: str, ready, deadline: float) -> bool:
+        while not ready():
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                return False
+            value = getattr(self._header, name)
+            if not ready():
+                self._futex(self._address(self._header, name), self.FUTEX_WAIT, value, min(remaining, self.WAIT_SLICE_SECONDS))
+        return True
+
+    def _serving(self) -> bool:
+        header = self._header
+        return bool(header.server_serving) and header.server_session == self._session
+
+    def settimeout(self, timeout: Optional[float]):
+        self.timeout = timeout if timeout is not None else float("inf")
+
+    def sendall(self, data):
+        view = memoryview(data).cast("B")
+        ring = self._header.requests
+        deadline = time.monotonic() + self.timeout
+        offset = 0
+        while offset < len(view):
+            if not self._serving():
+                raise ConnectionResetError("The editor closed the shared-memory session")
+            head = ring.head
+            free = self._capacity - (head - ring.tail)
+            if free == 0:
+                self._wake(ring, "data_doorbell")
+                tail = ring.tail
+                if not self._sleep(ring, "space_doorbell", "producer_waiting", lambda: ring.tail != tail or not self._serving(), deadline):
+                    raise socket.timeout("Timed out waiting for the editor to read")
+                continue
+            count = min(free, len(view) - offset)
+            position = head & (self._capacity - 1)
+            first = min(count, self._capacity - position)
+            start = self._requests_offset
+            self._map[start + position:start + position + first] = view[offset:offset + first]
+            if count > first:
+                self._map[start:start + count - first] = view[offset + first:offset + count]
+            ring.head = head + count
+            ring.data_doorbell = (ring.data_doorbell + 1) & 0x7FFFFFFF
+            offset += count
+        self._wake(ring, "data_doorbell")
+
+    def recv_into(self, buffer, nbytes: int = 0) -> int:
+        view = memoryview(buffer).cast("B")
+        wanted = nbytes or len(view)
+        ring = self._header.responses
+        tail = ring.tail
+        available = ring.head - tail
+        if available == 0:
+            deadline = time.monotonic() + self.timeout
+            if not self._sleep(ring, "data_doorbell", "consumer_waiting", lambda: ring.head != tail or not self._serving(), deadline):
+                raise socket.timeout("Timed out waiting for the editor to respond")
+            available = ring.head - tail
+            if available == 0:
+                return 0  # session closed
+
+        count = min(available, wanted)
+        position = tail & (self._capacity - 1)
+        first = min(count, self._capacity - position)
+        start = self._responses_offset
+        view[:first] = self._map[start + position:start + position + first]
+        if count > first:
+            view[first:count] = self._map[start:start + count - first]
+        ring.tail = tail + count
+        ring.space_doorbell = (ring.space_doorbell + 1) & 0x7FFFFFFF
+        # The plugin only sleeps on a full ring. Reading its flag may race with it going to sleep,
+        # but it cannot fill a ring that was less than half full within that window.
+        if ring.producer_waiting or available * 2 >= self._capacity:
+            self._wake(ring, "space_doorbell")
+        return count
+
+    def shutdown(self, how):
+        """The rings have no half-close; detaching ends the session after the plugin drains the requests."""
+        if self._map is not None and self._session:
+            self._header.client_detached_session = self._session
+            self._wake(self._header.requests, "data_doorbell")
+            self._wake(self._header.responses, "space_doorbell")
+
+    def close(self):
+        if self._map is not None:
+            self.shutdown(socket.SHUT_RDWR)
+            self._header = None
+            try:
+                self._map.close()
+            except BufferError:
+                pass  # ctypes views into the map are still alive; it is freed with them
+            self._map = None
+        if self._fd is not None:
+            os.close(self._fd)
+            self._fd = None
+
+
 class UnrealConnection:
-    """Manages the connection to an Unreal Engine instance for sending a single command."""
+    """Manages a persistent session with an Unreal Engine instance.
+
+    The plugin keeps a client socket open and serves any number of framed
+    requests on it, so a single connection is reused across commands.
+    """
     
     def __init__(self):
         """Initialize the connection manager."""
         self.socket: Optional[socket.socket] = None
         self.connected = False
+        self.last_used = 0.0
+        self._next_request_id = 0
+        self.chunked_frames = False
+        self.max_frame_size = MAX_FRAME_SIZE
+        self.encoding = "json"
+        self.compression = "none"
+        self.compression_threshold = COMPRESSION_THRESHOLD
+        self._lock = threading.Lock()
     
     def connect(self) -> bool:
         """Create a new socket and connect to the Unreal Engine instance."""
@@ -46,18 +499,29 @@ class UnrealConnection:
             self.disconnect()
 
         try:
-            logger.info(f"Connecting to Unreal at {UNREAL_HOST}:{UNREAL_PORT}...")
-            self.socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-            self.socket.settimeout(10)  # 10 second timeout for connection
-            
-            # Set socket options
-            self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
-            self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_KEEPALIVE, 1)
-            self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 65536)
-            self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, 65536)
-            
-            self.socket.connect((UNREAL_HOST, UNREAL_PORT))
+            if UNREAL_SHARED_MEMORY:
+                logger.info(f"Connecting to Unreal through shared memory {UNREAL_SHARED_MEMORY}...")
+                self.socket = SharedMemoryStream(UNREAL_SHARED_MEMORY, timeout=10)
+            elif UNREAL_UNIX_SOCKET:
+                logger.info(f"Connecting to Unreal at {UNREAL_UNIX_SOCKET}...")
+                self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+                self.socket.settimeout(10)  # 10 second timeout for connection
+                self.socket.connect(UNREAL_UNIX_SOCKET)
+            else:
+                logger.info(f"Connecting to Unreal at {UNREAL_HOST}:{UNREAL_PORT}...")
+                self.socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+                self.socket.settimeout(10)  # 10 second timeout for connection
+
+                # Set socket options
+                self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+                self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_KEEPALIVE, 1)
+                self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 65536)
+                self.socket.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, 65536)
+
+                self.socket.connect((UNREAL_HOST, UNREAL_PORT))
             self.connected = True
+            self.last_used = time.monotonic()
+            self._negotiate()
             logger.info("Successfully connected to Unreal Engine")
             return True
             
@@ -69,12 +533,104 @@ class UnrealConnection:
     def disconnect(self):
         """Disconnect from the Unreal Engine instance."""
         if self.socket:
+            try:
+                # Half-close first so the plugin finishes the session cleanly
+                self.socket.shutdown(socket.SHUT_WR)
+            except OSError:
+                pass
             try:
                 self.socket.close()
             except Exception as e:
                 logger.warning(f"Error while closing socket: {e}")
         self.socket = None
         self.connected = False
+        self.chunked_frames = False
+        self.encoding = "json"
+        self.compression = "none"
+
+    def _negotiate(self):
+        """Agree on session options with the plugin; older plugins reject 'hello' and keep single JSON frames.
+
+        The 'hello' exchange itself is always uncompressed JSON; a negotiated encoding and
+        compression apply from the next message.
+        """
+        self.chunked_frames = False
+        self.encoding = "json"
+        self.compression = "none"
+        hello = json.dumps({
+            "command": "hello",
+            "params": {
+                "chunked_frames": True,
+                "max_frame_size": MAX_FRAME_SIZE,
+                "encoding": PAYLOAD_ENCODING,
+                "compression": COMPRESSION,
+                "compression_threshold": COMPRESSION_THRESHOLD
+            }
+        }).encode('utf-8')
+        self._send_message(hello)
+        response_data = self.receive_full_response()
+        response = json.loads(response_data.decode('utf-8')) if response_data else {}
+        result = response.get("result", {}) if response.get("status") == "success" else {}
+        self.chunked_frames = bool(result.get("chunked_frames", False))
+        self.max_frame_size = int(result.get("max_frame_size", MAX_FRAME_SIZE))
+        self.encoding = result.get("encoding", "json")
+        self.compression = result.get("compression", "none")
+        self.compression_threshold = int(result.get("compression_threshold", COMPRESSION_THRESHOLD))
+        if self.compression not in ("none", "zlib"):
+            # Only zlib ships with Python; a plugin must not pick a format that was not offered
+            raise ConnectionError(f"Unsupported compression negotiated: {self.compression}")
+        logger.info(f"Negotiated session options: {result or 'legacy framing'}")
+
+    def _encode(self, message: Dict[str, Any]) -> bytes:
+        """Serialize a request in the session's payload encoding."""
+        if self.encoding == "cbor":
+            return cbor_dumps(message)
+        return json.dumps(message).encode('utf-8')
+
+    def _decode(self, payload) -> Dict[str, Any]:
+        """Parse a response in the session's payload encoding."""
+        if self.encoding == "cbor":
+            return cbor_loads(payload)
+        return json.loads(payload.decode('utf-8'))
+
+    def _send_frame(self, frame, flags: int):
+        """Write one frame, compressing it when negotiated and worthwhile."""
+        if self.compression == "zlib" and len(frame) >= self.compression_threshold:
+            compressed = zlib.compress(frame)
+            if len(compressed) + 4 < len(frame):
+                payload = len(frame).to_bytes(4, 'little') + compressed
+                self.socket.sendall((len(payload) | flags | FRAME_FLAG_COMPRESSED).to_bytes(4, 'little') + payload)
+                return
+        self.socket.sendall((len(frame) | flags).to_bytes(4, 'little'))
+        self.socket.sendall(frame)
+
+    def _send_message(self, message: bytes):
+        """Write one message, split into continuation frames when the session allows it."""
+        if not self.chunked_frames or len(message) <= self.max_frame_size:
+            self._send_frame(message, 0)
+            return
+
+        view = memoryview(message)
+        for offset in range(0, len(message), self.max_frame_size):
+            frame = view[offset:offset + self.max_frame_size]
+            more = FRAME_FLAG_MORE if offset + len(frame) < len(message) else 0
+            self._send_frame(frame, more)
+
+    def _recv_into(self, view: memoryview) -> int:
+        """Fill view from the socket, returning fewer bytes only if the peer closed the connection."""
+        received = 0
+        while received < len(view):
+            count = self.socket.recv_into(view[received:])
+            if count == 0:
+                break
+            received += count
+        return received
+
+    def _recv_exactly(self, size: int) -> bytes:
+        """Read exactly size bytes, returning fewer only if the peer closed the connection."""
+        buffer = bytearray(size)
+        received = self._recv_into(memoryview(buffer))
+        return bytes(buffer[:received]) if received < size else bytes(buffer)
 
     def receive_full_response(self) -> bytes:
         """Receive a complete response from Unreal, handling chunked data."""
@@ -82,26 +638,40 @@ class UnrealConnection:
             raise ConnectionError("Socket is not connected.")
 
         try:
-            # First, read the 4-byte length prefix
-            raw_msglen = self.socket.recv(4)
-            if not raw_msglen:
-                logger.error("No data received from Unreal when expecting message length.")
-                return b''
-            
-            msglen = int.from_bytes(raw_msglen, 'little')
-            logger.info(f"Expecting message of length: {msglen}")
-
-            # Now, read the full message based on the length
-            # Use a loop to handle chunked data
-            received_data = b''
-            while len(received_data) < msglen:
-                chunk = self.socket.recv(msglen - len(received_data))
-                if not chunk:
-                    logger.error(f"Connection closed while receiving data. Expected {msglen} bytes, got {len(received_data)}")
-                    break
-                received_data += chunk
+            received_data = bytearray()
+            more = True
+            while more:
+                # Each frame starts with a 4-byte header
+                raw_header = self._recv_exactly(4)
+                if len(raw_header) < 4:
+                    logger.error("No data received from Unreal when expecting a frame header.")
+                    return b''
+
+                header = int.from_bytes(raw_header, 'little')
+                frame_length = header & FRAME_LENGTH_MASK
+                more = bool(header & FRAME_FLAG_MORE)
+
+                if header & FRAME_FLAG_COMPRESSED:
+                    payload = self._recv_exactly(frame_length)
+                    if len(payload) < frame_length:
+                        logger.error(f"Connection closed while receiving data. Expected {frame_length} bytes in frame")
+                        return b''
+                    uncompressed_length = int.from_bytes(payload[:4], 'little')
+                    frame = zlib.decompress(memoryview(payload)[4:], bufsize=max(uncompressed_length, 1))
+                    if len(frame) != uncompressed_length:
+                        raise ValueError(f"Compressed frame inflated to {len(frame)} bytes, expected {uncompressed_length}")
+                    received_data += frame
+                    continue
+
+                # Read the frame straight into the end of the message buffer
+                offset = len(received_data)
+                received_data.extend(bytes(frame_length))
+                if self._recv_into(memoryview(received_data)[offset:]) < frame_length:
+                    logger.error(f"Connection closed while receiving data. Expected {frame_length} bytes in frame")
+                    return b''
             
             logger.info(f"Received {len(received_data)} bytes of response data")
+            # Returned as-is to avoid another copy of large responses
             return received_data
             
         except socket.timeout:
@@ -111,75 +681,271 @@ class UnrealConnection:
             logger.error(f"Error receiving data: {e}", exc_info=True)
             return b''
 
-    def send_command(self, command: str, params: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
-        """Send a command to Unreal Engine and get the response."""
-        # A new connection is established for each command.
-        if not self.connect():
-            return {"status": "error", "error": "Failed to connect to Unreal Engine for command"}
-        
-        if not self.socket:
-            return {"status": "error", "error": "Socket not initialized."}
+    def _ensure_connected(self) -> bool:
+        """Reuse the open session, reconnecting if it is missing, closed by the plugin or close to the idle timeout."""
+        if self.socket and time.monotonic() - self.last_used < IDLE_RECONNECT_SECONDS and not self._session_closed():
+            return True
+        return self.connect()
 
+    def _session_closed(self) -> bool:
+        """Whether the plugin already ended the open session, checked without blocking before a request is sent."""
+        if isinstance(self.socket, SharedMemoryStream):
+            return not self.socket._serving()
         try:
-            command_obj = {
-                "command": command,
-                "params": params or {}
-            }
-            
-            command_json = json.dumps(command_obj)
-            logger.info(f"Sending command to Unreal: {command_json}")
+            # Nothing is due on an idle session, so anything readable is the plugin closing it
+            readable, _, _ = select.select([self.socket], [], [], 0)
+            return bool(readable)
+        except (OSError, ValueError):
+            return True
+
+    @staticmethod
+    def _response_timeout(command: str, params: Optional[Dict[str, Any]]) -> float:
+        """Seconds to wait for the response to command, above the plugin's own limit for it."""
+        timeout = COMMAND_TIMEOUT_SECONDS.get(command, 0)
+        if command == "get_job_status":
+            timeout = min(float((params or {}).get("wait_seconds", 0) or 0), JOB_MAX_WAIT_SECONDS)
+        return max(RESPONSE_TIMEOUT_SECONDS, timeout + RESPONSE_TIMEOUT_SLACK_SECONDS)
+
+    def _exchange(self, message: bytes) -> bytes:
+        """Send one framed request and return the raw response payload."""
+        self._send_message(message)
+        response_data = self.receive_full_response()
+        self.last_used = time.monotonic()
+        return response_data
 
-            # Encode the message and prefix it with its length
-            message = command_json.encode('utf-8')
-            msglen = len(message)
-            self.socket.sendall(msglen.to_bytes(4, 'little') + message)
+    def send_command(self, command: str, params: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
+        """Send a command to Unreal Engine over the persistent session and get the response."""
+        with self._lock:
+            pooled_socket = self.socket
+            if not self._ensure_connected():
+                return {"status": "error", "error": "Failed to connect to Unreal Engine for command"}
             
+            if not self.socket:
+                return {"status": "error", "error": "Socket not initialized."}
+            reused = self.socket is pooled_socket
+
+            try:
+                command_obj = {
+                    "command": command,
+                    "params": params or {}
+                }
+                
+                logger.info(f"Sending command to Unreal: {command_obj}")
+
+                # Encode the message in the negotiated encoding and prefix it with its length
+                try:
+                    self._send_message(self._encode(command_obj))
+                except OSError:
+                    if not reused:
+                        raise
+                    # The plugin dropped the pooled session before the request reached it, so it
+                    # cannot have run; send it once on a fresh connection, re-encoding since the
+                    # new session may have negotiated differently. Once a request was written it
+                    # is never sent again, however its response fails.
+                    logger.info("Session was closed by Unreal, reconnecting")
+                    if not self.connect():
+                        return {"status": "error", "error": "Failed to reconnect to Unreal Engine"}
+                    self._send_message(self._encode(command_obj))
+
+                self.socket.settimeout(self._response_timeout(command, params))
+                response_data = self.receive_full_response()
+                self.last_used = time.monotonic()
+
+                if not response_data:
+                    raise ValueError("Received empty response from Unreal.")
+
+                response = self._decode(response_data)
+                logger.info(f"Complete response from Unreal: {json.dumps(response, indent=2)}")
+                return self._normalize_response(response)
+                
+            except Exception as e:
+                logger.error(f"An error occurred while sending command '{command}': {e}", exc_info=True)
+                # The stream may be out of sync after a failure, so start a fresh session next time
+                self.disconnect()
+                return {"status": "error", "error": str(e)}
+
+    def send_commands(self, commands: List[Tuple[str, Optional[Dict[str, Any]]]]) -> List[Dict[str, Any]]:
+        """Pipeline several commands over the session and return their responses in request order.
+
+        Every request is tagged with an id and written before any response is read,
+        so Unreal can overlap their execution; responses may arrive out of order and
+        are matched back by id.
+        """
+        with self._lock:
+            if not self._ensure_connected():
+                return [{"status": "error", "error": "Failed to connect to Unreal Engine for command"}] * len(commands)
+
+            try:
+                first_id = self._next_request_id + 1
+                self._next_request_id += len(commands)
+
+                def send(index: int):
+                    command, params = commands[index]
+                    self._send_message(self._encode({
+                        "id": first_id + index,
+                        "command": command,
+                        "params": params or {}
+                    }))
+
+                # Keep at most PIPELINE_WINDOW requests in flight; the plugin stops reading
+                # beyond its own limit, and unread responses would otherwise stall both sides
+                self.socket.settimeout(max(self._response_timeout(command, params) for command, params in commands))
+                sent = min(len(commands), PIPELINE_WINDOW)
+                for index in range(sent):
+                    send(index)
+
+                responses: Dict[Any, Dict[str, Any]] = {}
+                while len(responses) < len(commands):
+                    response_data = self.receive_full_response()
+                    if not response_data:
+                        raise ValueError("Received empty response from Unreal.")
+                    response = self._decode(response_data)
+                    responses[response.get("id")] = self._normalize_response(response)
+                    if sent < len(commands):
+                        send(sent)
+                        sent += 1
+                self.last_used = time.monotonic()
+
+                return [responses.get(first_id + index, {"status": "error", "error": "Missing response"})
+                        for index in range(len(commands))]
+
+            except Exception as e:
+                logger.error(f"An error occurred while pipelining {len(commands)} commands: {e}", exc_info=True)
+                self.disconnect()
+                return [{"status": "error", "error": str(e)}] * len(commands)
+
+    @staticmethod
+    def _normalize_response(response: Dict[str, Any]) -> Dict[str, Any]:
+        """Standardize error checking across response shapes."""
+        if response.get("status") == "error" or response.get("success") is False:
+            error_message = response.get("error") or response.get("message", "Unknown Unreal error")
+            logger.error(f"Unreal API Error: {error_message}")
+            return {"status": "error", "error": error_message}
+        return response
+
+class UnrealEventStream(UnrealConnection):
+    """A separate session that subscribes to editor events and buffers what Unreal pushes.
+
+    Pushed messages carry an "event" and its "data" instead of a status. A reader thread
+    owns the socket once connected: it files events in a bounded buffer and hands replies
+    to subscribe/unsubscribe, which are sent with an id, back to their caller.
+    """
+
+    def __init__(self, max_buffered: int = EVENT_BUFFER_SIZE):
+        super().__init__()
+        self._events = collections.deque(maxlen=max_buffered)
+        self._dropped = 0
+        self._replies: Dict[Any, Dict[str, Any]] = {}
+        self._condition = threading.Condition()
+        self._reader: Optional[threading.Thread] = None
+
+    def connect(self) -> bool:
+        if not super().connect():
+            return False
+        # Events may be minutes apart; the reader waits for them without a timeout
+        self.socket.settimeout(None)
+        self._reader = threading.Thread(target=self._read_loop, args=(self.socket,), daemon=True)
+        self._reader.start()
+        return True
+
+    def _read_loop(self, sock):
+        while self.socket is sock:
             response_data = self.receive_full_response()
             if not response_data:
-                raise ValueError("Received empty response from Unreal.")
+                break
+            message = self._decode(response_data)
+            with self._condition:
+                if "event" in message:
+                    if len(self._events) == self._events.maxlen:
+                        self._dropped += 1
+                    self._events.append(message)
+                else:
+                    self._replies[message.get("id")] = message
+                self._condition.notify_all()
+        with self._condition:
+            if self.socket is sock:
+                self.connected = False
+            self._condition.notify_all()
 
-            response = json.loads(response_data.decode('utf-8'))
-            logger.info(f"Complete response from Unreal: {json.dumps(response, indent=2)}")
-            
-            # Standardize error checking
-            if response.get("status") == "error" or response.get("success") is False:
-                error_message = response.get("error") or response.get("message", "Unknown Unreal error")
-                logger.error(f"Unreal API Error: {error_message}")
-                return {"status": "error", "error": error_message}
-            
-            return response
-            
-        except Exception as e:
-            logger.error(f"An error occurred while sending command '{command}': {e}", exc_info=True)
-            return {"status": "error", "error": str(e)}
-        finally:
-            # Unreal closes the connection after each command, so we do the same.
-            self.disconnect()
+    def _request(self, command: str, params: Dict[str, Any], timeout: float = 10.0) -> Dict[str, Any]:
+        with self._lock:
+            if not self.connected and not self.connect():
+                return {"status": "error", "error": "Failed to connect to Unreal Engine for events"}
+            self._next_request_id += 1
+            request_id = self._next_request_id
+            self._send_message(self._encode({"id": request_id, "command": command, "params": params}))
+
+        deadline = time.monotonic() + timeout
+        with self._condition:
+            while request_id not in self._replies:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0 or not self.connected:
+                    return {"status": "error", "error": f"No reply to {command}"}
+                self._condition.wait(remaining)
+            return self._normalize_response(self._replies.pop(request_id))
+
+    def subscribe(self, events: List[str]) -> Dict[str, Any]:
+        """Add events to the subscription; "*" subscribes to all of them."""
+        return self._request("subscribe", {"events": events})
+
+    def unsubscribe(self, events: Optional[List[str]] = None) -> Dict[str, Any]:
+        """Remove events from the subscription, or end it when none are given."""
+        return self._request("unsubscribe", {"events": events} if events else {})
+
+    def get_events(self, max_events: int = 100, wait_seconds: float = 0.0) -> Dict[str, Any]:
+        """Take buffered events, oldest first, waiting up to wait_seconds for the first one."""
+        deadline = time.monotonic() + wait_seconds
+        with self._condition:
+            while not self._events and self.connected:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    break
+                self._condition.wait(remaining)
+            events = [self._events.popleft() for _ in range(min(max_events, len(self._events)))]
+            dropped, self._dropped = self._dropped, 0
+            return {"events": events, "dropped": dropped, "connected": self.connected}
 
-# Global connection state is no longer needed, commands will create their own connection.
+
+# Shared session reused by every tool call
 _unreal_connection: Optional[UnrealConnection] = None
+_unreal_connection_lock = threading.Lock()
 
 def get_unreal_connection() -> UnrealConnection:
-    """Get a fresh connection to Unreal Engine."""
-    # This function now simply returns a new connection instance for each call.
-    return UnrealConnection()
+    """Get the shared persistent connection to Unreal Engine."""
+    global _unreal_connection
+    with _unreal_connection_lock:
+        if _unreal_connection is None:
+            _unreal_connection = UnrealConnection()
+        return _unreal_connection
+
+# Session for pushed editor events, opened by the first subscribe
+_event_stream: Optional[UnrealEventStream] = None
+
+def get_event_stream() -> UnrealEventStream:
+    """Get the shared session that receives editor events."""
+    global _event_stream
+    with _unreal_connection_lock:
+        if _event_stream is None:
+            _event_stream = UnrealEventStream()
+        return _event_stream
 
 @asynccontextmanager
 async def server_lifespan(server: FastMCP) -> AsyncIterator[Dict[str, Any]]:
     """Handle server startup and shutdown."""
     logger.info("UnrealMCP server starting up.")
-    # No need to manage a global connection here anymore.
-    # We can do a one-time check to see if Unreal is available.
-    conn = UnrealConnection()
+    # Open the shared session up front so the first tool call does not pay for the connect
+    conn = get_unreal_connection()
     if conn.connect():
         logger.info("Successfully connected to Unreal Engine on startup. Connection test passed.")
-        conn.disconnect()
     else:
         logger.warning("Could not connect to Unreal Engine on startup. Please ensure the editor is running.")
     
     try:
         yield {}
     finally:
+        conn.disconnect()
+        if _event_stream is not None:
+            _event_stream.disconnect()
         logger.info("Unreal MCP server is shutting down.")
 
 # Initialize server
@@ -229,12 +995,26 @@ def info():
     - `take_screenshot(filename, show_ui, resolution)` - Capture screenshots
 
     ### Actor Management
-    - `get_actors_in_level()` - List all actors in current level
-    - `find_actors_by_name(pattern)` - Find actors by name pattern
+    - `get_actors_in_level(actor_class, tag, folder, name, level, fields, sort_by, page_size, cursor)` - List actors in the current level, filtered and paged
+    - `find_actors_by_name(pattern, mode, case_sensitive, limit)` - Find actors by name or label: substring, glob, regex or fuzzy-ranked
+    - `get_scene_changes_since(version)` - What changed since a listing or an earlier call, instead of listing the level again
+    - `subscribe_events(events)` / `get_events(max_events, wait_seconds)` / `unsubscribe_events(events)` - Have Unreal push actor, selection, blueprint, save and PIE events instead of polling
     - `spawn_actor(name, type, location=[0,0,0], rotation=[0,0,0], scale=[1,1,1])` - Create actors
     - `delete_actor(name)` - Remove actors
     - `set_actor_transform(name, location, rotation, scale)` - Modify actor transform
+    - `set_actor_transforms(names, locations, rotations, scales, defer_navigation)` - Move many actors in one request
     - `get_actor_properties(name)` - Get actor properties
+    - `query_actors_in_sphere(center, radius, limit, actor_class)` - Actors near a point, nearest first
+    - `query_actors_in_box(min, max | center, extent, limit, actor_class)` - Actors overlapping a box
+    - `query_actors_in_frustum(origin, rotation, fov, aspect_ratio, near, far, limit, actor_class)` - Actors a camera sees; the active viewport's by default
+
+    ### Batches
+    - `execute_batch(commands, transaction=None, stop_on_error=True)` - Run many commands in one round trip, optionally as one undo step
+
+    ### Jobs
+    - `start_job(command, params)` - Run a long command in the background and get a job_id back at once
+    - `get_job_status(job_id, wait_seconds=0)` - Poll or wait for a job's result; commands that time out also return a job_id
+    - `cancel_job(job_id)` - Cancel a job that has not started yet
     
     ## Blueprint Management
     - `create_blueprint(name, parent_class)` - Create new Blueprint classes
@@ -258,8 +1038,13 @@ def info():
     
     ## Project Tools
     - `create_input_mapping(action_name, key, input_type)` - Create input mappings
+    - `find_assets(path, asset_class, name, recursive, limit)` - Search saved assets; answered even while the editor is busy
+    - `get_config_value(section, key, file)` - Read a project config value; answered even while the editor is busy
     
     ## Best Practices
+
+    ### Multi-step Edits
+    - Build a blueprint or lay out several actors with one `execute_batch` call rather than a tool call per step
     
     ### UMG Widget Development
     - Create widgets with descriptive names that reflect their purpose